@@ -10,7 +10,7 @@ using std::vector;
 using std::map;
 using std::string;
 
-map< string, vector<VALUESTORE>  > GeneAnnotations(RXNSPACE &small_list, double cut, double cut2);
-void removeAnnotation(RXNSPACE &rxnspace, const string &genename, const VALUESTORE &val);
+map< STRINGID, vector<VALUESTORE>  > GeneAnnotations(RXNSPACE &small_list, double cut, double cut2);
+void removeAnnotation(RXNSPACE &rxnspace, STRINGID geneId, const VALUESTORE &val);
 
 #endif
@@ -51,7 +51,7 @@ int ComponentTest(const PROBLEM &theModel){
   METSPACE inputs(baseModel.metabolites, inputIds);  
   checkExchangesAndTransporters(baseModel, theModel, inputIds, dirs);
   vector< vector< PATH > > allPaths;
-  adjustLikelihoods(baseModel.synrxns.rxns, 1.0f, -1.0f, 1.1f, -3.0f, false);
+  adjustLikelihoods(baseModel.synrxns, 1.0f, -1.0f, 1.1f, -3.0f, false);
   /*
   printf("baseModel: %d\n",(int)baseModel.synrxns.rxns.size());
   /*Print everything rxnModel
@@ -59,6 +59,24 @@ int ComponentTest(const PROBLEM &theModel){
     printf("%d %d  %s\n",i,baseModel.synrxns.rxns[i].id, baseModel.synrxns.rxns[i].name);}
   printf("synrxn Loaded\n");
   */
+
+  /* FBA for every component in one LP: the base model plus an objective reaction (under a free ID) for each component,
+     swept over with only the one being maximized allowed to carry flux */
+  RXNSPACE componentRxns = baseModel.fullrxns;
+  int firstObjId = 0;
+  for(int i=0;i<componentRxns.rxns.size();i++){ firstObjId = std::max(firstObjId, componentRxns.rxns[i].id + 1); }
+  vector<int> objIds;
+  for(int i=0;i<biomass.stoich.size();i++){
+    REACTION objRxn = MakeObjRxn(vector<STOICH>(1, biomass.stoich[i]));
+    objRxn.id = firstObjId + i;
+    componentRxns.addReaction(objRxn);
+    objIds.push_back(objRxn.id);
+  }
+  GLPKDATA componentLp(componentRxns, baseModel.metabolites, vector<int>(), vector<double>(), 1);
+  vector<double> maxFlux; vector<int> statuses; vector<vector<double> > componentFluxes;
+  componentLp.objectiveSweep(objIds, true, maxFlux, statuses, &componentFluxes);
+  int numBase = baseModel.fullrxns.rxns.size();
+
   for(int i=0;i<biomass.stoich.size();i++){
     PROBLEM tempModel = baseModel;
 
@@ -74,13 +92,15 @@ int ComponentTest(const PROBLEM &theModel){
     /*Run FBA*/
      char *matlab_str = (char *) malloc(sizeof(char) * 64);
     sprintf(matlab_str,"matlab_out_%d.mat",i);
-    MATLAB_out(matlab_str,tempModel.fullrxns.rxns);
+    MATLAB_out(matlab_str,tempModel.metabolites,tempModel.fullrxns.rxns);
 
-    printf("Running FBA on %s\n",biomass.stoich[i].met_name);
-    vector<double> fbaResult = FBA_SOLVE(tempModel.fullrxns.rxns,tempModel.metabolites);
+    printf("Running FBA on %s\n",baseModel.metabolites.metFromId(outputId).name.c_str());
+    /* tempModel is the base model with the objective reaction at the end */
+    vector<double> fbaResult(componentFluxes[i].begin(), componentFluxes[i].begin() + numBase);
+    fbaResult.push_back(componentFluxes[i][numBase + i]);
     //Print
     /*
-    printf("FBA result vector for %s\n",biomass.stoich[i].met_name);
+    printf("FBA result vector for %s\n",baseModel.metabolites.metFromId(outputId).name);
    for(int j=0;j<fbaResult.size();j++){
       printf("%s %f %d\n",tempModel.fullrxns.rxns[j].name,fbaResult[j],tempModel.fullrxns.rxns[j].net_reversible);
     }
@@ -98,7 +118,7 @@ int ComponentTest(const PROBLEM &theModel){
       FeedEnergy(tempModel,1.0f);
       for(int j=0;j<tempModel.fullrxns.rxns.size();j++){
 	printf("== %d %d %4.0f %4.0f %s\n",j,tempModel.fullrxns.rxns[j].id,
-	       tempModel.fullrxns.rxns[j].lb, tempModel.fullrxns.rxns[j].ub, tempModel.fullrxns.rxns[j].name);
+	       tempModel.fullrxns.rxns[j].lb, tempModel.fullrxns.rxns[j].ub, tempModel.fullrxns.rxns[j].name.c_str());
       }
       vector<double> fbaResult3 = FBA_SOLVE(tempModel.fullrxns.rxns,tempModel.metabolites);
       PROBLEM fluxonly3 = reportFlux(tempModel,fbaResult3);
@@ -107,11 +127,11 @@ int ComponentTest(const PROBLEM &theModel){
     }
     
     vector<PATH> kpaths;
-    adjustLikelihoods(tempModel.synrxns.rxns, 1.0f, -1.0f, 1.1f, -3.0f, false);
+    adjustLikelihoods(tempModel.synrxns, 1.0f, -1.0f, 1.1f, -3.0f, false);
 
     printf("Running kShortest: %d %d %d %s %d\n",(int)tempModel.synrxns.rxns.size(),
 	   (int)tempModel.metabolites.mets.size(),(int)inputs.mets.size(),
-	   tempModel.metabolites.metFromId(outputId).name, Kq);
+	   tempModel.metabolites.metFromId(outputId).name.c_str(), Kq);
     /*
     printf("tempModel: %d\n",(int)tempModel.synrxns.rxns.size());
     /*Print everything rxnModel
@@ -131,12 +151,9 @@ int ComponentTest(const PROBLEM &theModel){
 
 void Load_Stoich_Part_With_Cofactors(PROBLEM &Model){
   for(int i=0;i<Model.fullrxns.rxns.size();i++){
-    Model.fullrxns.rxns[i].stoich_part.clear();
     for(int j=0;j<Model.fullrxns.rxns[i].stoich.size();j++){
       int metID = Model.fullrxns.rxns[i].stoich[j].met_id;
-      if(Model.metabolites.metFromId(metID).secondary_lone!=1){
-	Model.fullrxns.rxns[i].stoich_part.push_back(Model.fullrxns.rxns[i].stoich[j]);
-      }
+      Model.fullrxns.rxns[i].stoich[j].secondary = (Model.metabolites.metFromId(metID).secondary_lone==1);
     }
   }
   return;
@@ -154,25 +171,20 @@ PROBLEM reportFlux(PROBLEM& Model, vector<double> &fbaSolution, double cutoff){
   for(int i=0;i<fbaSolution.size();i++){
     if(abs(fbaSolution[i])>cutoff){
       REACTION tmpRxn = Model.fullrxns.rxns[i];
-      //tmpRxn.stoich_part = tmpRxn.stoich; //includes everything
+      //tmpRxn.includeSecondaries(); //includes everything
       if(fbaSolution[i]>0.0f){ tmpRxn.net_reversible =  1; tmpRxn.lb = 0.0f; }
       if(fbaSolution[i]<0.0f){ tmpRxn.net_reversible = -1; tmpRxn.ub = 0.0f; }
-      if(tmpRxn.stoich_part.size()>1){ //This line isn't registering with ac either...
+      if(tmpRxn.stoichPart().size()>1){ //This line isn't registering with ac either...
 	reporter.fullrxns.addReaction(tmpRxn);
-	//printf("%s %d ( %d )\n",tmpRxn.name,tmpRxn.id,(int)tmpRxn.stoich_part.size());
-	//for(int j=0;j<tmpRxn.stoich_part.size();j++){
-	//  printf("   %s %d\n",tmpRxn.stoich_part[j].met_name,tmpRxn.stoich_part[j].met_id);
-	//}
       }
     }
   }
   if(reporter.fullrxns.rxns.size()>0){
     vector<int> metList;
     for(int i=0;i<reporter.fullrxns.rxns.size();i++){
-      for(int j=0;j<reporter.fullrxns.rxns[i].stoich_part.size();j++){
-	metList.push_back(reporter.fullrxns.rxns[i].stoich_part[j].met_id);
-	//printf("* %s  %d\n",rxnspace.rxns[i].stoich_part[j].met_name,
-	//       rxnspace.rxns[i].stoich_part[j].met_id);
+      for(int j=0;j<reporter.fullrxns.rxns[i].stoich.size();j++){
+	if(reporter.fullrxns.rxns[i].stoich[j].secondary) { continue; }
+	metList.push_back(reporter.fullrxns.rxns[i].stoich[j].met_id);
       }
     }
     custom_unique(metList);
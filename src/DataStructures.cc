@@ -1,4 +1,5 @@
 #include "DataStructures.h"
+#include "MyConstants.h"
 #include "pathUtils.h"
 
 #include <assert.h>
@@ -14,7 +15,7 @@ using std::sprintf;
 
 vector<NETREACTION> ANSWER::etc;
 vector<vector<vector<PATHSUMMARY> > > ANSWER::pList;
-map<string, vector<VALUESTORE> > ANSWER::annoteToRxns;
+map<STRINGID, vector<VALUESTORE> > ANSWER::annoteToRxns;
 
 METABOLITE::METABOLITE() {
   input = 0;
@@ -60,12 +61,13 @@ bool ANNOTATION::operator<(const ANNOTATION &rhs)const {
 
 STOICH::STOICH() {
   met_id = -1;
-  //met_name;
+  secondary = false;
   rxn_coeff = 999;
 }
 
 void STOICH::reset() {
   met_id = -1;
+  secondary = false;
   rxn_coeff = 999;
 }
 
@@ -79,7 +81,22 @@ bool REACTION::operator<(const REACTION &rhs) const{
   return (this[0].id < rhs.id);
 }
 
+/* The stoichiometry without the secondary metabolites (what Dijkstras sees) */
+vector<STOICH> REACTION::stoichPart() const {
+  vector<STOICH> part;
+  for(int i=0; i<stoich.size(); i++) {
+    if(!stoich[i].secondary) { part.push_back(stoich[i]); }
+  }
+  return part;
+}
+
+/* Treat every metabolite in the reaction as non-secondary */
+void REACTION::includeSecondaries() {
+  for(int i=0; i<stoich.size(); i++) { stoich[i].secondary = false; }
+}
+
 REACTION::REACTION(){
+  kind = 0;
   freeMakeFlag = 0;
   isExchange = 0;
   transporter = 0;
@@ -95,6 +112,7 @@ REACTION::REACTION(){
 }
 
 void REACTION::reset() {
+  kind = 0;
   freeMakeFlag = 0;
   isExchange = 0;
   transporter = 0;
@@ -107,16 +125,19 @@ void REACTION::reset() {
   else { lb = 0.0f; ub = 1000.0f; }
 
   stoich.clear();
-  stoich_part.clear();
   syn.clear();
   annote.clear();
 }
 
+NETREACTION::NETREACTION() {
+  startPartSize = 0;
+}
+
 bool NETREACTION::operator==(const NETREACTION &rhs) const{
   unsigned int i;
   if(this[0].rxnDirIds.size()!=rhs.rxnDirIds.size()){
     return false;}
-  if(this[0].rxn.stoich_part.size()!=rhs.rxn.stoich_part.size()){
+  if(this[0].startPartSize!=rhs.startPartSize){
     return false;}
   for(i=0;i<rhs.rxnDirIds.size();i++){
     if(this[0].rxnDirIds[i]!=rhs.rxnDirIds[i]){return false;}}
@@ -163,6 +184,7 @@ RXNSPACE::RXNSPACE(const vector<REACTION> &rxnVec) {
   numRxns = rxns.size();
   for(int i=0; i<rxns.size(); i++) {
     Ids2Idx[rxns[i].id] = i;
+    indexReaction(i);
   }
 }
 
@@ -171,6 +193,7 @@ RXNSPACE::RXNSPACE(const RXNSPACE& existingSpace, const vector<int> &idSubset) {
     REACTION rxn = existingSpace.rxnFromId(idSubset[i]);
     rxns.push_back(rxn);
     Ids2Idx[rxn.id] = i;
+    indexReaction(i);
   }
   numRxns = rxns.size();
 }
@@ -178,6 +201,10 @@ RXNSPACE::RXNSPACE(const RXNSPACE& existingSpace, const vector<int> &idSubset) {
 void RXNSPACE::clear() {
   rxns.clear();
   Ids2Idx.clear();
+  metExchangeIdx.clear();
+  metTransportIdx.clear();
+  kindIdx.clear();
+  attrCost.clear(); attrRev.clear(); attrLb.clear(); attrUb.clear();
   numRxns = 0;
 }
 
@@ -186,14 +213,45 @@ REACTION & RXNSPACE::operator[](int idx) {
   return this->rxns[idx];
 }
 
-/* Note - I implemented this myself so that I automatically reserve the capacity... lets see if it helps make this more efficient */
-RXNSPACE RXNSPACE::operator=(const RXNSPACE &orig) {
+/* The lookups are always rebuilt from the copied reactions, never copied: callers edit rxns[...] directly (IDs, bounds,
+   likelihoods, stoichiometry) without telling the RXNSPACE, so the source's lookups can't be trusted */
+RXNSPACE::RXNSPACE(const RXNSPACE &init) 
+  : rxns(init.rxns), currentAtpm(init.currentAtpm), numRxns(init.rxns.size()) {
+  if(!rxns.empty()) { rxnMap(); }
+}
+
+#if __cplusplus >= 201103L
+RXNSPACE::RXNSPACE(RXNSPACE &&init) {
+  numRxns = 0;
+  currentAtpm = 0.0f;
+  swap(init);
+}
+
+RXNSPACE& RXNSPACE::operator=(RXNSPACE &&init) {
+  if(&init != this) { swap(init); }
+  return *this;
+}
+#endif
+
+void RXNSPACE::swap(RXNSPACE &other) {
+  rxns.swap(other.rxns);
+  std::swap(currentAtpm, other.currentAtpm);
+  Ids2Idx.swap(other.Ids2Idx);
+  std::swap(numRxns, other.numRxns);
+  metExchangeIdx.swap(other.metExchangeIdx);
+  metTransportIdx.swap(other.metTransportIdx);
+  kindIdx.swap(other.kindIdx);
+  attrCost.swap(other.attrCost);
+  attrRev.swap(other.attrRev);
+  attrLb.swap(other.attrLb);
+  attrUb.swap(other.attrUb);
+}
+
+/* Copy and swap - copies the reactions in one go and rebuilds the lookups once, instead of re-adding the reactions one at a time */
+RXNSPACE& RXNSPACE::operator=(const RXNSPACE &orig) {
   if(&orig != this) {
-    clear();
-    rxns.reserve(orig.rxns.capacity());
-    for(int i=0; i<orig.rxns.size(); i++) {
-      addReaction(orig.rxns[i]);
-    }
+    RXNSPACE tmp(orig);
+    swap(tmp);
   }
   return *this;
 }
@@ -223,6 +281,7 @@ void RXNSPACE::addReaction(const REACTION &rxn) {
   }
   rxns.push_back(rxn);
   Ids2Idx[rxn.id] = rxns.size()-1;
+  indexReaction(rxns.size()-1);
   numRxns++;
 }
 
@@ -230,7 +289,9 @@ void RXNSPACE::removeRxnFromBack() {
   assert(rxns.size() > 0);
   int id = rxns.back().id;
   int idx = Ids2Idx[id];
+  unindexReaction(idx);
   rxns.pop_back();
+  attrCost.pop_back(); attrRev.pop_back(); attrLb.pop_back(); attrUb.pop_back();
   Ids2Idx.erase(id);
   numRxns--;
 }
@@ -238,9 +299,19 @@ void RXNSPACE::removeRxnFromBack() {
 void RXNSPACE::changeId(int oldId, int newId) {
   if(idIn(newId)) { printf("ERROR: Request to change ID to an ID already taken by a reaction in the RXNSPACE (in RXNSPACE::changeID)\n"); assert(false); }
   int idx = idxFromId(oldId);
+  /* Whether or not something counts as an exchange depends on its ID (biomass is excluded) */
+  unindexReaction(idx);
   rxns[idx].id = newId;
   Ids2Idx.erase(oldId);
   Ids2Idx[newId] = idx;
+  indexReaction(idx);
+}
+
+void RXNSPACE::changeStoich(int id, const vector<STOICH> &newStoich) {
+  int idx = idxFromId(id);
+  unindexReaction(idx);
+  rxns[idx].stoich = newStoich;
+  indexReaction(idx);
 }
 
 /* NOTE (IMPORTANT): For reverse compatibility, :
@@ -260,6 +331,7 @@ void RXNSPACE::changeReversibility(int id, int new_rev) {
   if(new_rev == 0)  { ptr->lb = -1000.0f; ptr->ub = 1000.0f; }
   if(new_rev == 1)  { ptr->lb = 0.0f    ; ptr->ub = 1000.0f; }
   ptr->net_reversible = new_rev;
+  setAttributes(idxFromId(id));
 }
 
 /* Change the lb of the reaction to new_lb
@@ -273,6 +345,7 @@ void RXNSPACE::change_Lb(int id, double new_lb) {
 
   if(new_lb >= 1E-5f) { ptr->net_reversible = 1; }
   if(new_lb <= 1E-5f & ptr->ub >= -1E-5f) { ptr->net_reversible = 0; }
+  setAttributes(idxFromId(id));
 }
 
 /* Change the ub of the reaction to new_ub
@@ -285,6 +358,7 @@ void RXNSPACE::change_Ub(int id, double new_ub) {
 
   if(new_ub <= -1E-5f) { ptr->net_reversible = -1; }
   if(new_ub >= -1E-5f & ptr->lb <= 1E-5f) { ptr->net_reversible = 0; }
+  setAttributes(idxFromId(id));
 }
 
 /* If you know you want to change both the LB AND the UB... you can pass both here to avoid obnoxious assertions.
@@ -300,12 +374,19 @@ void RXNSPACE::change_Lb_and_Ub(int id, double new_lb, double new_ub) {
   if(new_lb > 1E-5) { ptr->net_reversible = 1; }
   else if(new_ub < -1E-5) { ptr->net_reversible = -1; }
   else { ptr->net_reversible = 0; }
+  setAttributes(idxFromId(id));
+}
 
+/* Change current_likelihood (the Dijkstras cost - -1 means DO NOT INCLUDE) */
+void RXNSPACE::changeLikelihood(int id, double new_likelihood) {
+  int idx = idxFromId(id);
+  rxns[idx].current_likelihood = new_likelihood;
+  attrCost[idx] = new_likelihood;
 }
 
 /* Uses "find" function from map to allow us to declare constant RXNSPACE's
 Return a reaction with a given ID */
-REACTION RXNSPACE::rxnFromId(int id) const {
+const REACTION & RXNSPACE::rxnFromId(int id) const {
   int idx = this->idxFromId(id);
   return rxns[idx];
 }
@@ -341,15 +422,183 @@ bool RXNSPACE::idIn(int id) const {
 void RXNSPACE::rxnMap() {
   assert(this->rxns.size()>0);
   this->Ids2Idx.clear();
+  this->metExchangeIdx.clear();
+  this->metTransportIdx.clear();
+  this->kindIdx.clear();
+  this->attrCost.clear(); this->attrRev.clear(); this->attrLb.clear(); this->attrUb.clear();
   for(int i=0;i<this->rxns.size();i++) {
     this->Ids2Idx[this->rxns[i].id] = i;
+    indexReaction(i);
   }
   return;
 }
 
+void RXNSPACE::reorder(const vector<int> &newOrder) {
+  assert(newOrder.size() == this->rxns.size());
+  if(this->rxns.empty()) { return; }
+  vector<REACTION> reordered;
+  reordered.reserve(this->rxns.size());
+  for(int i=0; i<newOrder.size(); i++) {
+    reordered.push_back(this->rxns[newOrder[i]]);
+  }
+  this->rxns.swap(reordered);
+  rxnMap();
+}
+
+/* Insert idx into a sorted index list (no duplicates) */
+static void insertSortedIdx(vector<int> &idxList, int idx) {
+  vector<int>::iterator it = std::lower_bound(idxList.begin(), idxList.end(), idx);
+  if(it == idxList.end() || *it != idx) { idxList.insert(it, idx); }
+}
+
+static void eraseSortedIdx(map<int, vector<int> > &index, int metId, int idx) {
+  map<int, vector<int> >::iterator mit = index.find(metId);
+  if(mit == index.end()) { return; }
+  vector<int>::iterator it = std::lower_bound(mit->second.begin(), mit->second.end(), idx);
+  if(it != mit->second.end() && *it == idx) { mit->second.erase(it); }
+  if(mit->second.empty()) { index.erase(mit); }
+}
+
+/* Exchanges are identified the same way FindExchange4Metabolite always has (one metabolite in the stoich, not biomass) -
+   it does not depend on the isExchange flag. Transporters are anything flagged with transporter == 1. 
+   The index lists are kept sorted by rxns index so that the first exchange is the same one a linear scan would have found */
+void RXNSPACE::indexReaction(int idx) {
+  setAttributes(idx);
+  REACTION &rxn = rxns[idx];
+  rxn.kind = rxnKind(rxn);
+  for(int k=0; k<RXN_NUMKINDS; k++) {
+    if(rxn.kind & (1u<<k)) { insertSortedIdx(kindIdx[1u<<k], idx); }
+  }
+  if(rxn.stoich.size() == 1 && rxn.id != _db.BIOMASS) {
+    insertSortedIdx(metExchangeIdx[rxn.stoich[0].met_id], idx);
+  }
+  if(rxn.transporter == 1) {
+    for(int i=0; i<rxn.stoich.size(); i++) {
+      insertSortedIdx(metTransportIdx[rxn.stoich[i].met_id], idx);
+    }
+  }
+}
+
+void RXNSPACE::unindexReaction(int idx) {
+  const REACTION &rxn = rxns[idx];
+  for(int k=0; k<RXN_NUMKINDS; k++) {
+    if(!(rxn.kind & (1u<<k))) { continue; }
+    map<unsigned int, vector<int> >::iterator it = kindIdx.find(1u<<k);
+    if(it == kindIdx.end()) { continue; }
+    vector<int>::iterator vit = std::lower_bound(it->second.begin(), it->second.end(), idx);
+    if(vit != it->second.end() && *vit == idx) { it->second.erase(vit); }
+  }
+  for(int i=0; i<rxn.stoich.size(); i++) {
+    eraseSortedIdx(metExchangeIdx, rxn.stoich[i].met_id, idx);
+    eraseSortedIdx(metTransportIdx, rxn.stoich[i].met_id, idx);
+  }
+}
+
+/* Sorts rxns indexes by decreasing current_likelihood (ties keep their order in rxns) */
+class LIKELIHOODORDER{
+ public:
+  const vector<REACTION> &rxns;
+  LIKELIHOODORDER(const vector<REACTION> &r) : rxns(r) {}
+  bool operator()(int a, int b) const { return rxns[a].current_likelihood > rxns[b].current_likelihood; }
+};
+
+/* Likelihoods change all the time (and directly through rxns) so the ordering is done when asked for rather than stored */
+vector<int> RXNSPACE::likelihoodOrderedIds(const map<int, vector<int> > &index, int metId) const {
+  vector<int> result;
+  map<int, vector<int> >::const_iterator it = index.find(metId);
+  if(it == index.end()) { return result; }
+  vector<int> idxList = it->second;
+  std::stable_sort(idxList.begin(), idxList.end(), LIKELIHOODORDER(rxns));
+  for(int i=0; i<idxList.size(); i++) {
+    result.push_back(rxns[idxList[i]].id);
+  }
+  return result;
+}
+
+/* Returns the ID of the first exchange (in rxns order) for metId or -1 if there isn't one */
+int RXNSPACE::exchangeIdForMet(int metId) const {
+  map<int, vector<int> >::const_iterator it = metExchangeIdx.find(metId);
+  if(it == metExchangeIdx.end()) { return -1; }
+  return rxns[it->second[0]].id;
+}
+
+vector<int> RXNSPACE::exchangeIdsForMet(int metId) const {
+  return likelihoodOrderedIds(metExchangeIdx, metId);
+}
+
+vector<int> RXNSPACE::transporterIdsForMet(int metId) const {
+  return likelihoodOrderedIds(metTransportIdx, metId);
+}
+
+const vector<int> & RXNSPACE::idxOfKind(unsigned int kind) const {
+  static const vector<int> none;
+  map<unsigned int, vector<int> >::const_iterator it = kindIdx.find(kind);
+  if(it == kindIdx.end()) { return none; }
+  return it->second;
+}
+
+/* Copy the hot fields of rxns[idx] into the attribute arrays (growing them if idx is new) */
+void RXNSPACE::setAttributes(int idx) {
+  if(idx >= attrCost.size()) {
+    attrCost.resize(rxns.size()); attrRev.resize(rxns.size());
+    attrLb.resize(rxns.size()); attrUb.resize(rxns.size());
+  }
+  const REACTION &rxn = rxns[idx];
+  attrCost[idx] = rxn.current_likelihood;
+  attrRev[idx] = rxn.net_reversible;
+  attrLb[idx] = rxn.lb;
+  attrUb[idx] = rxn.ub;
+}
+
+void RXNSPACE::syncAttributes() {
+  attrCost.resize(rxns.size()); attrRev.resize(rxns.size());
+  attrLb.resize(rxns.size()); attrUb.resize(rxns.size());
+  for(int i=0; i<rxns.size(); i++) { setAttributes(i); }
+}
+
+const vector<double> & RXNSPACE::costs() const {
+  return attrCost;
+}
+
+const vector<int> & RXNSPACE::reversibilities() const {
+  return attrRev;
+}
+
+const vector<double> & RXNSPACE::lowerBounds() const {
+  return attrLb;
+}
+
+const vector<double> & RXNSPACE::upperBounds() const {
+  return attrUb;
+}
+
+static bool inFactorRange(int id, int factor) {
+  return id >= factor && id < factor + _db.MINFACTORSPACING;
+}
+
+/* Same range tests that used to be scattered around (e.g. id >= BLACKMAGICFACTOR && id < BLACKMAGICFACTOR + MINFACTORSPACING) 
+   Reversed synthesis reactions get both RXN_REV and RXN_SYN */
+unsigned int rxnKind(const REACTION &rxn) {
+  unsigned int kind = 0;
+  int id = rxn.id;
+  if(id < _db.MINFACTORSPACING) { kind |= RXN_NORMAL; }
+  if(inFactorRange(id, _db.MISSINGTRANSPORTFACTOR)) { kind |= RXN_MISSINGTRANSPORT; }
+  if(inFactorRange(id, _db.MISSINGEXCHANGEFACTOR)) { kind |= RXN_MISSINGEXCHANGE; }
+  if(inFactorRange(id, _db.MAGICBRIDGEFACTOR)) { kind |= RXN_MAGICBRIDGE; }
+  if(inFactorRange(id, _db.BLACKMAGICFACTOR)) { kind |= RXN_MAGICEXIT; }
+  if(inFactorRange(id, _db.ETCFACTOR)) { kind |= RXN_ETC; }
+  if(inFactorRange(id, _db.BRIDGEFIXFACTOR)) { kind |= RXN_BRIDGEFIX; }
+  if(inFactorRange(id, _db.REVFACTOR)) { kind |= RXN_REV; }
+  if(inFactorRange(id, _db.SYNFACTOR)) { kind |= RXN_SYN; }
+  if(inFactorRange(id, _db.REVFACTOR + _db.SYNFACTOR)) { kind |= (RXN_REV | RXN_SYN); }
+  if(rxn.isExchange == 1) { kind |= RXN_EXCHANGE; }
+  return kind;
+}
+
 
 /* I think I'm required to put this here...even if it does nothing*/
 METSPACE::METSPACE() {
+  numMets = 0;
 }
 
 METSPACE::METSPACE(const vector<METABOLITE> &metVec) {
@@ -369,7 +618,7 @@ METSPACE::METSPACE(const METSPACE& existingSpace, const vector<int> &idSubset) {
   numMets = mets.size();
 }
 
-/* Initializes a list of mets based on stoich (NOT stoich_part) for a given RXNSPACE */
+/* Initializes a list of mets based on stoich (secondaries included) for a given RXNSPACE */
 METSPACE::METSPACE(const RXNSPACE &rxnspace, const METSPACE &largeMetSpace) {
   vector<int> metIds;
   for(int i=0; i<rxnspace.rxns.size(); i++) {
@@ -410,7 +659,7 @@ void METSPACE::removeMetFromBack() {
   numMets--;
 }
 
-METABOLITE METSPACE::metFromId(int id) const {
+const METABOLITE & METSPACE::metFromId(int id) const {
   return mets[idxFromId(id)];
 }
 
@@ -450,14 +699,46 @@ void METSPACE::metMap() {
   return;
 }
 
-/* Note - I implemented this myself so that I automatically reserve the capacity... lets see if it helps make this more efficient */
-METSPACE METSPACE::operator=(const METSPACE &orig) {
+void METSPACE::reorder(const vector<int> &newOrder) {
+  assert(newOrder.size() == this->mets.size());
+  if(this->mets.empty()) { return; }
+  vector<METABOLITE> reordered;
+  reordered.reserve(this->mets.size());
+  for(int i=0; i<newOrder.size(); i++) {
+    reordered.push_back(this->mets[newOrder[i]]);
+  }
+  this->mets.swap(reordered);
+  metMap();
+}
+
+/* Ids2Idx is rebuilt rather than copied, as for RXNSPACE */
+METSPACE::METSPACE(const METSPACE &init) 
+  : mets(init.mets), numMets(init.mets.size()) {
+  if(!mets.empty()) { metMap(); }
+}
+
+#if __cplusplus >= 201103L
+METSPACE::METSPACE(METSPACE &&init) {
+  numMets = 0;
+  swap(init);
+}
+
+METSPACE& METSPACE::operator=(METSPACE &&init) {
+  if(&init != this) { swap(init); }
+  return *this;
+}
+#endif
+
+void METSPACE::swap(METSPACE &other) {
+  mets.swap(other.mets);
+  Ids2Idx.swap(other.Ids2Idx);
+  std::swap(numMets, other.numMets);
+}
+
+METSPACE& METSPACE::operator=(const METSPACE &orig) {
   if(&orig != this) {
-    clear();
-    mets.reserve(orig.mets.capacity());
-    for(int i=0; i<orig.mets.size(); i++) {
-      addMetabolite(orig.mets[i]);
-    }
+    METSPACE tmp(orig);
+    swap(tmp);
   }
   return *this;
 }
@@ -520,6 +801,204 @@ PATH::PATH() {
 }
 
 
+GRAPHSTORE::GRAPHSTORE() {
+  pathIdx = -1;
+  excludedNode = -1;
+  numExcluded = 0;
+  totalLikelihood = INT_MAX;
+}
+
+PATHARENA::PATHARENA() {
+
+}
+
+void PATHARENA::appendField(PATHSPAN &span, int field, const vector<int> &src) {
+  span.start[field] = ints.size();
+  span.len[field] = src.size();
+  ints.insert(ints.end(), src.begin(), src.end());
+}
+
+void PATHARENA::copyField(const PATHSPAN &span, int field, vector<int> &dest) const {
+  vector<int>::const_iterator first = ints.begin() + span.start[field];
+  dest.assign(first, first + span.len[field]);
+}
+
+int PATHARENA::addPath(const PATH &path) {
+  PATHSPAN span;
+  span.outputId = path.outputId;
+  span.totalLikelihood = path.totalLikelihood;
+  appendField(span, PATH_INPUT, path.inputIds);
+  appendField(span, PATH_RXN, path.rxnIds);
+  appendField(span, PATH_DIR, path.rxnDirection);
+  appendField(span, PATH_METSCONSUMED, path.metsConsumedIds);
+  appendField(span, PATH_DEADEND, path.deadEndIds);
+  appendField(span, PATH_PRIORITY, path.rxnPriority);
+  paths.push_back(span);
+  return paths.size() - 1;
+}
+
+/* Copy a path body from another arena without going through a PATH */
+int PATHARENA::copyPathFrom(const PATHARENA &source, int pathIdx) {
+  const PATHSPAN &from = source.paths[pathIdx];
+  PATHSPAN span = from;
+  for(int f=0; f<PATH_NUMFIELDS; f++) {
+    span.start[f] = ints.size();
+    ints.insert(ints.end(), source.ints.begin() + from.start[f], source.ints.begin() + from.start[f] + from.len[f]);
+  }
+  paths.push_back(span);
+  return paths.size() - 1;
+}
+
+PATH PATHARENA::getPath(int pathIdx) const {
+  assert(pathIdx >= 0 && pathIdx < paths.size());
+  const PATHSPAN &span = paths[pathIdx];
+  PATH path;
+  path.outputId = span.outputId;
+  path.totalLikelihood = span.totalLikelihood;
+  copyField(span, PATH_INPUT, path.inputIds);
+  copyField(span, PATH_RXN, path.rxnIds);
+  copyField(span, PATH_DIR, path.rxnDirection);
+  copyField(span, PATH_METSCONSUMED, path.metsConsumedIds);
+  copyField(span, PATH_DEADEND, path.deadEndIds);
+  copyField(span, PATH_PRIORITY, path.rxnPriority);
+  return path;
+}
+
+double PATHARENA::pathLikelihood(int pathIdx) const {
+  return paths[pathIdx].totalLikelihood;
+}
+
+void PATHARENA::getRxnIds(int pathIdx, vector<int> &dest) const {
+  copyField(paths[pathIdx], PATH_RXN, dest);
+}
+
+void PATHARENA::getRxnDirection(int pathIdx, vector<int> &dest) const {
+  copyField(paths[pathIdx], PATH_DIR, dest);
+}
+
+GRAPHSTORE PATHARENA::addGraph(int pathIdx, const GRAPHSTORE &parent, int newExcludedId) {
+  EXCLUDENODE node;
+  node.parent = parent.excludedNode;
+  node.rxnId = newExcludedId;
+  excluded.push_back(node);
+
+  GRAPHSTORE graph;
+  graph.pathIdx = pathIdx;
+  graph.totalLikelihood = paths[pathIdx].totalLikelihood;
+  graph.excludedNode = excluded.size() - 1;
+  graph.numExcluded = parent.numExcluded + 1;
+  return graph;
+}
+
+GRAPHSTORE PATHARENA::addGraph(int pathIdx) {
+  GRAPHSTORE graph;
+  graph.pathIdx = pathIdx;
+  graph.totalLikelihood = paths[pathIdx].totalLikelihood;
+  graph.excludedNode = -1;
+  graph.numExcluded = 0;
+  return graph;
+}
+
+void PATHARENA::getExcluded(const GRAPHSTORE &graph, vector<int> &dest) const {
+  dest.resize(graph.numExcluded);
+  int node = graph.excludedNode;
+  for(int i=graph.numExcluded-1; i>=0; i--) {
+    assert(node != -1);
+    dest[i] = excluded[node].rxnId;
+    node = excluded[node].parent;
+  }
+}
+
+void PATHARENA::compact(vector<GRAPHSTORE> &graphs) {
+  PATHARENA fresh;
+  /* Old exclusion node --> new node (-1 = not copied yet) */
+  vector<int> newNode(excluded.size(), -1);
+  vector<int> chain;
+  for(int i=0; i<graphs.size(); i++) {
+    GRAPHSTORE &graph = graphs[i];
+    graph.pathIdx = fresh.copyPathFrom(*this, graph.pathIdx);
+
+    /* Walk up to the first node that is already in the new arena and copy the rest from the top down 
+       so that parents always come before their children */
+    chain.clear();
+    for(int node = graph.excludedNode; node != -1 && newNode[node] == -1; node = excluded[node].parent) {
+      chain.push_back(node);
+    }
+    for(int j=(int)chain.size()-1; j>=0; j--) {
+      EXCLUDENODE copy = excluded[chain[j]];
+      if(copy.parent != -1) { copy.parent = newNode[copy.parent]; }
+      fresh.excluded.push_back(copy);
+      newNode[chain[j]] = fresh.excluded.size() - 1;
+    }
+    if(graph.excludedNode != -1) { graph.excludedNode = newNode[graph.excludedNode]; }
+  }
+  ints.swap(fresh.ints);
+  paths.swap(fresh.paths);
+  excluded.swap(fresh.excluded);
+}
+
+void PATHARENA::release() {
+  vector<int>().swap(ints);
+  vector<PATHSPAN>().swap(paths);
+  vector<EXCLUDENODE>().swap(excluded);
+}
+
+int PATHARENA::numPaths() const {
+  return paths.size();
+}
+
+long int PATHARENA::memoryUsed() const {
+  return ints.capacity()*sizeof(int) + paths.capacity()*sizeof(PATHSPAN) + excluded.capacity()*sizeof(EXCLUDENODE);
+}
+
+bool LANDMARKS::empty() const {
+  return landmarkIdx.empty();
+}
+
+/* Triangle inequality on each landmark L:  d(m,t) >= d(L,t) - d(L,m)  and  d(m,t) >= d(m,L) - d(t,L).
+   If L reaches m but not t (or t reaches L but m doesn't) there is no route from m to t at all */
+void LANDMARKS::boundsTo(int targetIdx, vector<double> &bounds) const {
+  int numMets = fromLandmark.empty() ? 0 : fromLandmark[0].size();
+  bounds.assign(numMets, 0.0f);
+  for(int l=0; l<landmarkIdx.size(); l++) {
+    const vector<double> &from = fromLandmark[l];
+    const vector<double> &to = toLandmark[l];
+    for(int i=0; i<numMets; i++) {
+      if(bounds[i] < 0) { continue; }
+      if(from[i] >= 0) {
+	if(from[targetIdx] < 0) { bounds[i] = -1; continue; }
+	if(from[targetIdx] - from[i] > bounds[i]) { bounds[i] = from[targetIdx] - from[i]; }
+      }
+      if(to[targetIdx] >= 0) {
+	if(to[i] < 0) { bounds[i] = -1; continue; }
+	if(to[i] - to[targetIdx] > bounds[i]) { bounds[i] = to[i] - to[targetIdx]; }
+      }
+    }
+  }
+  bounds[targetIdx] = 0.0f;
+}
+
+bool FLUXEXPANSION::empty() const {
+  return originalIds.empty();
+}
+
+void FLUXEXPANSION::expand(const vector<double> &compressedFlux, vector<double> &fullFlux) const {
+  fullFlux.assign(originalIds.size(), 0.0f);
+  for(int i=0; i<originalIds.size(); i++) {
+    if(column[i] != -1) { fullFlux[i] = factor[i] * compressedFlux[column[i]]; }
+  }
+}
+
+int FLUXEXPANSION::columnOf(int rxnId, double &rxnFactor) const {
+  map<int,int>::const_iterator it = originalIdx.find(rxnId);
+  if(it == originalIdx.end()) {
+    printf("FAILURE: Reaction ID %d is not in the compressed model\n", rxnId);
+    assert(false);
+  }
+  rxnFactor = factor[it->second];
+  return column[it->second];
+}
+
 PATHSUMMARY PATHSUMMARY::clear(){
   this->rxnDirIds.clear();
   this->deadEndIds.clear();
@@ -602,6 +1081,10 @@ PATHSUMMARY PATHSUMMARY::operator/(PATH &onepath){
 
 BADIDSTORE::BADIDSTORE() {  badRxnId = -1; }
 
+BOUNDOVERRIDE::BOUNDOVERRIDE() {  rxnId = -1; lb = 0.0f; ub = 0.0f; }
+
+BOUNDOVERRIDE::BOUNDOVERRIDE(int id, double newLb, double newUb) {  rxnId = id; lb = newLb; ub = newUb; }
+
 bool BADIDSTORE::operator<(const BADIDSTORE &rhs) const {
   BADIDSTORE lhs = *this;
   /* order first by the reaction ID, then by the size of badMetIds, and finally by their values. */
@@ -659,7 +1142,7 @@ ANSWER::ANSWER(){
 
 }
 
-void initializeAnswer(const vector<NETREACTION> &myEtc, const vector<vector<vector<PATHSUMMARY> > > &myPlist, const map<string, vector<VALUESTORE> > &annoteToRxn) {
+void initializeAnswer(const vector<NETREACTION> &myEtc, const vector<vector<vector<PATHSUMMARY> > > &myPlist, const map<STRINGID, vector<VALUESTORE> > &annoteToRxn) {
   ANSWER::etc = myEtc;
   ANSWER::pList = myPlist;
   ANSWER::annoteToRxns = annoteToRxn;
@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "StringPool.h"
 
 using std::vector;
 using std::map;
@@ -29,7 +30,13 @@ class PATHSUMMARY;
 
 class VALUESTORE;
 class GRAPHSTORE;
+class SSSPSTATE;
+class LANDMARKS;
+class HYPERCSR;
 class BADIDSTORE;
+class BOUNDOVERRIDE;
+class FLUXEXPANSION;
+class COMPRESSEDMODEL;
 
 class GAPFILLRESULT;
 class ANSWER;
@@ -37,6 +44,24 @@ class SIMULATIONRESULT;
 class KORESULT;
 class SCORE;
 
+/* Reaction kinds (bits in REACTION::kind). All but RXN_EXCHANGE come from the ID range the reaction
+   was given (see the *FACTOR's in MyConstants) - RXN_EXCHANGE mirrors isExchange. */
+enum {
+  RXN_NORMAL           = 1<<0,
+  RXN_MISSINGTRANSPORT = 1<<1,
+  RXN_MISSINGEXCHANGE  = 1<<2,
+  RXN_MAGICBRIDGE      = 1<<3,
+  RXN_MAGICEXIT        = 1<<4,
+  RXN_ETC              = 1<<5,
+  RXN_REV              = 1<<6,
+  RXN_SYN              = 1<<7,
+  RXN_BRIDGEFIX        = 1<<8,
+  RXN_EXCHANGE         = 1<<9,
+  RXN_NUMKINDS         = 10
+};
+
+unsigned int rxnKind(const REACTION &rxn);
+
 class RXNSPACE{
  public:
   vector<REACTION> rxns;
@@ -44,6 +69,12 @@ class RXNSPACE{
   RXNSPACE();
   RXNSPACE(const vector<REACTION> &rxnVec);
   RXNSPACE(const RXNSPACE& existingSpace, const vector<int> &idSubset);
+  RXNSPACE(const RXNSPACE& init);
+#if __cplusplus >= 201103L
+  RXNSPACE(RXNSPACE&& init);
+  RXNSPACE& operator=(RXNSPACE&& init);
+#endif
+  void swap(RXNSPACE &other);
 
   void clear();
 
@@ -51,20 +82,44 @@ class RXNSPACE{
   void change_Lb(int id, double new_lb);
   void change_Ub(int id, double new_ub);
   void change_Lb_and_Ub(int id, double new_lb, double new_ub);
+  void changeLikelihood(int id, double new_likelihood);
 
   void changeId(int oldId, int newId);
+  /* Replace the stoichiometry of reaction id (keeps the exchange / transporter indexes up to date) */
+  void changeStoich(int id, const vector<STOICH> &newStoich);
 
   void addReactionVector(const vector<REACTION> &rxnVec);
   void addReaction(const REACTION &rxn);
   void removeRxnFromBack();
-  REACTION rxnFromId(int id) const;
+  const REACTION & rxnFromId(int id) const;
   REACTION* rxnPtrFromId(int id);
   const REACTION* rxnPtrFromId(int id) const;
   int idxFromId(int id) const;
   bool idIn(int id) const;
   void rxnMap();
-
-  RXNSPACE operator=(const RXNSPACE& init);
+  /* Move rxns[newOrder[i]] to index i (IDs don't change - see reorderForLocality) */
+  void reorder(const vector<int> &newOrder);
+
+  /* Per-metabolite lookup of exchanges and transporters (kept up to date by addReaction, changeId, 
+     removeRxnFromBack and rxnMap). Lists are returned in order of decreasing current_likelihood */
+  int exchangeIdForMet(int metId) const;
+  vector<int> exchangeIdsForMet(int metId) const;
+  vector<int> transporterIdsForMet(int metId) const;
+
+  /* Indexes (in rxns, ascending) of all reactions with the given RXN_* bit set */
+  const vector<int> & idxOfKind(unsigned int kind) const;
+
+  /* Hot attributes of rxns[i] (current_likelihood, net_reversible, lb, ub) stored contiguously by index,
+     for Dijkstras and the LP setup. Kept in sync by addReaction, the change* functions, rxnMap and copying.
+     Anything that writes those fields of rxns[i] directly must call syncAttributes() before it returns
+     (adjustLikelihoods, setSpecificGrowthConditions, minimizeExits and friends do) */
+  const vector<double> & costs() const;
+  const vector<int> & reversibilities() const;
+  const vector<double> & lowerBounds() const;
+  const vector<double> & upperBounds() const;
+  void syncAttributes();
+
+  RXNSPACE& operator=(const RXNSPACE& init);
   REACTION & operator[](int idx);
   bool operator==(const RXNSPACE &rhs);
 
@@ -74,6 +129,21 @@ class RXNSPACE{
   map<int,int> Ids2Idx;
   int numRxns;
 
+  /* Metabolite ID --> indexes (in rxns) of exchanges / transporters involving that metabolite */
+  map<int, vector<int> > metExchangeIdx;
+  map<int, vector<int> > metTransportIdx;
+  /* RXN_* bit --> indexes of reactions of that kind */
+  map<unsigned int, vector<int> > kindIdx;
+  /* Structure-of-arrays copy of the hot REACTION fields (see costs()) */
+  vector<double> attrCost;
+  vector<int> attrRev;
+  vector<double> attrLb;
+  vector<double> attrUb;
+  void setAttributes(int idx);
+  void indexReaction(int idx);
+  void unindexReaction(int idx);
+  vector<int> likelihoodOrderedIds(const map<int, vector<int> > &index, int metId) const;
+
 };
 
 class METSPACE{
@@ -84,17 +154,25 @@ class METSPACE{
   METSPACE(const vector<METABOLITE> &metVec);
   METSPACE(const METSPACE &existingSpace, const vector<int> &idSubset);
   METSPACE(const RXNSPACE &rxnspace, const METSPACE &largeMetSpace);
+  METSPACE(const METSPACE& init);
+#if __cplusplus >= 201103L
+  METSPACE(METSPACE&& init);
+  METSPACE& operator=(METSPACE&& init);
+#endif
+  void swap(METSPACE &other);
 
   void clear();
   void removeMetFromBack();
   void addMetabolite(const METABOLITE &met);
-  METABOLITE metFromId(int id) const;
+  const METABOLITE & metFromId(int id) const;
   METABOLITE* metPtrFromId(int id);
   int idxFromId(int id) const;
   bool idIn(int id) const;
   void metMap();
+  /* Move mets[newOrder[i]] to index i (IDs don't change) */
+  void reorder(const vector<int> &newOrder);
 
-  METSPACE operator=(const METSPACE& init);
+  METSPACE& operator=(const METSPACE& init);
   METABOLITE & operator[](int idx);
   map<int, int> Ids2Idx;
 
@@ -149,7 +227,7 @@ struct MEDIA{
 
 struct KNOCKOUT{
   int id;
-  string genename;
+  NAMEREF genename;
   double act_coef; /* percentage of maximum growth rate achieved with knockout (0 = lethal knockout, 1 = wild type growth rate) */
 };
 
@@ -157,7 +235,7 @@ class METABOLITE{
  public:
   /* Externally (XML/User) defined parameters */
   int id; /* Has to be big matrix row index */
-  char name[64];
+  NAMEREF name;
   int charge;
   int input; /* Is it an input?: 0 for no, 1 for yes */
   int output; /* Is it an output? 0 for no, 1 for yes */
@@ -165,7 +243,7 @@ class METABOLITE{
   int secondary_lone; /* 0 for no, 1 for yes */
   vector<int> secondary_pair; /* Int of the ID for each possible secondary pair */
   int noncentral; /* 0 = central (not used for ETC), 1 = noncentral (used for ETC), -1 = undefined */
-  char chemform[64];
+  NAMEREF chemform;
   double modifier; /* Reserved for things that can be used to modify metabolite cost in Dijkstras algorithm, such as metabolomics data or other thigns we calculate */
   
   /* Connected reactions */
@@ -176,11 +254,12 @@ class METABOLITE{
   int isSecondary() const;
 };
 
+/* Note - names are NOT stored here. Look them up in the METSPACE (only needed for printing) */
 class STOICH{
   public:
   int met_id;
+  bool secondary; /* Secondary (cofactor) in THIS reaction - skipped by Dijkstras (set by Load_Stoic_Part) */
   double rxn_coeff;
-  char met_name[64];
   
   bool operator==(const STOICH &rhs) const;
   bool operator>(const STOICH &rhs) const;
@@ -194,12 +273,10 @@ class REACTION{
   
   int id;
   int synthesis; /* ID for metabolite that the REACTION synthesizes - if any (-1 otherwise) */
-  char name[64];
-  vector<STOICH> stoich; /* Full chemical reaction */
-
-  /* stoich, but without the secondary metabolties (Load_Stoic_Part deals with this) */
-  /* This is the one used by Dijkstras - if you want to use fullrxns with dijkstras you need to copy it over first */
-  vector<STOICH> stoich_part;
+  NAMEREF name;
+  /* Full chemical reaction. Entries flagged "secondary" are left out by Dijkstras (Load_Stoic_Part deals with this) - 
+     if you want to use fullrxns with dijkstras including the secondaries call includeSecondaries() first */
+  vector<STOICH> stoich;
 
   int transporter; /* 0 for no, 1 for yes */
 
@@ -228,17 +305,21 @@ class REACTION{
   int revPair; /* The iD of the reaction gonig the other way in the network (if there is one) and -1 if none */
   vector<int> syn;    /* Special vector for storing reactions in the same reaction-class */
   vector<ANNOTATION> annote; /* List of gene annotations */
+
+  unsigned int kind; /* RXN_* bits - filled in by RXNSPACE when the reaction is added */
   
   bool operator==(const REACTION &rhs) const;
   bool operator>(const REACTION &rhs) const;
   bool operator<(const REACTION &rhs) const;
+  vector<STOICH> stoichPart() const;
+  void includeSecondaries();
   REACTION();
   void reset();
 };
 
 struct ANNOTATION{
   double probability;
-  string genename;
+  NAMEREF genename;
   /* THis compares > because we want to go in opposite order.. when sorting these. */
   bool operator<(const ANNOTATION &rhs) const;
 };
@@ -249,7 +330,10 @@ class NETREACTION{
   vector<int> rxnDirIds;
   /* The NETREACTION itself */
   REACTION rxn;
+  /* Number of non-secondary metabolites in the reaction the chain started from (set by convert, compared by ==) */
+  int startPartSize;
   bool operator==(const NETREACTION &rhs) const;
+  NETREACTION();
 };
 
 class PATH{
@@ -304,12 +388,135 @@ class VALUESTORE{
 };
 
 /* Setup priority queue for K-shortest (again, we want the minimum and not the maximum)
-   We exclude specific reactions from a particular PATH and then pass those onto the next iteration */
+   We exclude specific reactions from a particular PATH and then pass those onto the next iteration.
+   The path itself and the excluded reaction IDs live in the PATHARENA for the query - this only says where. */
 class GRAPHSTORE{
  public:
-  vector<int> excludedRxnIds;
-  PATH path;  
-  bool operator<(const GRAPHSTORE &rhs) const { return this[0].path.totalLikelihood > rhs.path.totalLikelihood; }
+  int pathIdx; /* Path number in the PATHARENA */
+  int excludedNode; /* Last reaction excluded for this graph (a PATHARENA exclusion node - -1 if nothing is excluded) */
+  int numExcluded;
+  double totalLikelihood; /* Copy of the path's totalLikelihood so the queue never has to look in the arena */
+  GRAPHSTORE();
+  bool operator<(const GRAPHSTORE &rhs) const { return this[0].totalLikelihood > rhs.totalLikelihood; }
+};
+
+/* Storage for every candidate path (and exclusion list) found during one K-shortest query. Path bodies are
+   appended to one flat int buffer and nothing is freed until the arena itself goes away (or release() / compact() is called), so 
+   the candidate queue holds a handful of ints per entry instead of a PATH with six vectors.
+
+   Exclusion lists are persistent cons-lists: a spur candidate excludes everything its parent did plus one
+   more reaction, so it stores just that reaction and a link to the parent's node. Siblings share the whole prefix.
+   Not thread safe - add things from a serial section. */
+class PATHARENA{
+ public:
+  PATHARENA();
+  /* Returns the pathIdx of the copy */
+  int addPath(const PATH &path);
+  PATH getPath(int pathIdx) const;
+  double pathLikelihood(int pathIdx) const;
+  /* Copy the reaction IDs / directions of a stored path into dest (reusing its capacity) */
+  void getRxnIds(int pathIdx, vector<int> &dest) const;
+  void getRxnDirection(int pathIdx, vector<int> &dest) const;
+
+  /* Exclude everything the parent excluded plus one more reaction. Returns a GRAPHSTORE for the given path */
+  GRAPHSTORE addGraph(int pathIdx, const GRAPHSTORE &parent, int newExcludedId);
+  /* First entry for a query (nothing excluded) */
+  GRAPHSTORE addGraph(int pathIdx);
+  /* Excluded reaction IDs in the order they were excluded */
+  void getExcluded(const GRAPHSTORE &graph, vector<int> &dest) const;
+
+  /* Throw away everything not reachable from the given graphs (paths that were already popped or pruned and
+     exclusion nodes nobody links to any more). The graphs are updated to point into the compacted arena */
+  void compact(vector<GRAPHSTORE> &graphs);
+  void release();
+  int numPaths() const;
+  /* Bytes currently reserved by the arena */
+  long int memoryUsed() const;
+
+ private:
+  enum { PATH_INPUT, PATH_RXN, PATH_DIR, PATH_METSCONSUMED, PATH_DEADEND, PATH_PRIORITY, PATH_NUMFIELDS };
+  class PATHSPAN{
+  public:
+    int outputId;
+    double totalLikelihood;
+    int start[PATH_NUMFIELDS];
+    int len[PATH_NUMFIELDS];
+  };
+  class EXCLUDENODE{
+  public:
+    int parent; /* -1 for the first reaction excluded */
+    int rxnId;
+  };
+  vector<int> ints;
+  vector<PATHSPAN> paths;
+  vector<EXCLUDENODE> excluded;
+  void appendField(PATHSPAN &span, int field, const vector<int> &src);
+  void copyField(const PATHSPAN &span, int field, vector<int> &dest) const;
+  int copyPathFrom(const PATHARENA &source, int pathIdx);
+};
+
+/* Labels from a complete Dijkstras run (findShortestPath with a fullState), indexed like METSPACE::mets. 
+   K-shortest keeps the one for the current path so spur searches can repair it instead of starting over */
+class SSSPSTATE{
+ public:
+  vector<double> values;
+  vector<int> precursorRxnIds; /* Reaction that reached each metabolite (-1 for inputs and -2 if it was never reached) */
+  vector<bool> isDone;
+  vector<int> settleOrder; /* Metabolite indexes in the order they were reached */
+};
+
+/* Distances to and from a few landmark metabolites on the network with every reaction split into simple reactant --> product
+   edges (each costing the whole reaction). A hyperpath through a metabolite costs at least as much as the cheapest simple
+   route from it, so these give admissible A* bounds for findShortestPath (see buildLandmarks). Taking reactions away
+   only makes routes longer, so a table built on a network stays valid when reactions are excluded from it later. */
+/* Simple-graph view of a reaction network (see splitGraph) - [metabolite index] -> (metabolite index, cost) pairs */
+typedef vector<vector<std::pair<int, double> > > SPLITGRAPH;
+
+class LANDMARKS{
+ public:
+  vector<int> landmarkIdx; /* Indexes in METSPACE::mets */
+  vector<vector<double> > fromLandmark; /* [landmark][metabolite index] - negative if unreachable */
+  vector<vector<double> > toLandmark;
+  bool empty() const;
+  /* Lower bound on the cost of reaching targetIdx from each metabolite (-1 if it can't be reached at all) */
+  void boundsTo(int targetIdx, vector<double> &bounds) const;
+};
+
+/* Compressed (CSR) copy of the non-secondary stoichiometry of a network, for batchShortestPaths. Only the topology is
+   stored - costs are read from RXNSPACE::costs() - so it stays valid while reactions are excluded and put back */
+class HYPERCSR{
+ public:
+  vector<int> metStart; /* Reactions involving metabolite index i are metRxns[metStart[i]] to metRxns[metStart[i+1]-1] */
+  vector<int> metRxns; /* Reaction indexes */
+  vector<int> rxnStart; /* Stoichiometry of reaction index i is rxnMets / rxnSigns[rxnStart[i]] to [rxnStart[i+1]-1] */
+  vector<int> rxnMets; /* Metabolite indexes */
+  vector<int> rxnSigns; /* -1 for reactants and +1 for products (as written) */
+  vector<int> rxnDirection; /* net_reversible */
+};
+
+/* Map from the columns of a compressed model back to the reactions it came from (see compressModel): reaction
+   originalIds[i] has flux factor[i] * (flux of compressed column column[i]), or always 0 if column[i] is -1 (blocked) */
+class FLUXEXPANSION{
+ public:
+  vector<int> originalIds;
+  vector<int> column;
+  vector<double> factor;
+  vector<int> columnSize; /* Number of original reactions lumped into each column */
+  map<int, int> originalIdx; /* Original reaction ID --> i */
+
+  bool empty() const;
+  /* Flux vector over the compressed columns --> flux vector over the original reactions (in their order) */
+  void expand(const vector<double> &compressedFlux, vector<double> &fullFlux) const;
+  /* Column of original reaction rxnId (-1 if blocked) and its factor */
+  int columnOf(int rxnId, double &rxnFactor) const;
+};
+
+/* A model with blocked reactions and dead-end metabolites taken out and linear chains lumped into single columns */
+class COMPRESSEDMODEL{
+ public:
+  RXNSPACE rxnspace; /* Each column keeps the ID of one of the reactions lumped into it */
+  METSPACE metspace;
+  FLUXEXPANSION expansion;
 };
 
 class GAPFILLRESULT{
@@ -332,6 +539,17 @@ class BADIDSTORE {
   bool operator==(const BADIDSTORE &rhs) const;
 };
 
+/* New bounds for one reaction in one of the variants solved by GLPKDATA::batchSolve (everything not overridden keeps
+   the bounds the GLPKDATA was built with) */
+class BOUNDOVERRIDE {
+ public:
+  int rxnId;
+  double lb;
+  double ub;
+  BOUNDOVERRIDE();
+  BOUNDOVERRIDE(int id, double newLb, double newUb);
+};
+
 class INNERPOPSTORE {
  public:
   double score;
@@ -366,23 +584,25 @@ class ANSWER {
        Secretion rates (Predicted by algorithm) for each media in the PROBLEM
        Total network likelihood */
 
-  static map<string, vector<VALUESTORE> > annoteToRxns;
+  static map<STRINGID, vector<VALUESTORE> > annoteToRxns; /* Keyed by interned gene name */
   static vector<NETREACTION> etc;
   static vector<vector<vector<PATHSUMMARY> > > pList;
 
   RXNSPACE reactions;
   METSPACE metabolites;
   /* Set of path IDs used in model (the genetic algorithm will shuffle these) */
-  vector<const PATHSUMMARY*> passedPaths;
+  vector<long int> passedPaths;
 
-  vector<const METABOLITE*> fixedGaps;
-  vector<vector<const REACTION*> > fixes; //indexed by the fixedGaps they solve 
+  /* Everything below holds IDs into reactions / metabolites rather than pointers, so that the default
+     (memberwise) copy and move are correct and copying an ANSWER costs no lookups */
+  vector<int> fixedGaps; //metabolite IDs
+  vector<vector<int> > fixes; //reaction IDs, indexed by the fixedGaps they solve 
 
-  vector<const REACTION*> essentialMagicExits;
+  vector<int> essentialMagicExits;
 
   /* ETC IDs (not sure how I'll do this) for ETCs connected to our network via ETC_CONNECT */
-  vector<const REACTION*> etcIds; 
-  vector<const REACTION*> etcConnect;
+  vector<int> etcIds; 
+  vector<int> etcConnect;
   vector<KORESULT> knockoutResults;
 
   //optimum scoring answer
@@ -390,37 +610,6 @@ class ANSWER {
 
   ANSWER();
 
-  //copy constructor
-  ANSWER(const ANSWER &source){
-    /* These aren't necessary because these variables are declared as STATIC so they have the same value automatically
-       as any other ANSWER */
-    /*    this->annoteToRxns = source.annoteToRxns;
-    this->etc = source.etc;
-    this->pList = source.pList; */
-
-    this->reactions = source.reactions;
-    this->metabolites = source.metabolites;
-    this->knockoutResults = source.knockoutResults;
-    this->optLocalScore = source.optLocalScore;
-
-    /* This should be OK since passedPaths is a STATIC it should always be in the same memory location... */
-    this->passedPaths = source.passedPaths;
-
-    /* Since the reactions and metabolites are NOT static (by design)
-       we need to move the pointers to the new answer */
-    for(int i=0; i<source.fixedGaps.size(); i++) { this->fixedGaps.push_back( this->metabolites.metPtrFromId( source.fixedGaps[i]->id )); }
-    for(int i=0; i<source.fixes.size(); i++) {
-      vector<const REACTION*> tmp;
-      for(int j=0; j<source.fixes[i].size(); j++) {
-	tmp.push_back(this->reactions.rxnPtrFromId( source.fixes[i][j]->id ));
-      }
-      this->fixes.push_back(tmp);
-    }
-    for(int i=0; i<source.essentialMagicExits.size(); i++) { this->essentialMagicExits.push_back( this->reactions.rxnPtrFromId( source.essentialMagicExits[i]->id )); }
-    for(int i=0; i<source.etcIds.size(); i++) { this->etcIds.push_back( this->reactions.rxnPtrFromId( source.etcIds[i]->id )); }
-    for(int i=0; i<source.etcConnect.size(); i++) { this->etcConnect.push_back( this->reactions.rxnPtrFromId( source.etcConnect[i]->id )); }
-  }
-
 };
 
 class KORESULT{
@@ -428,6 +617,6 @@ class KORESULT{
 };
 
 /* Initialize static members of the ANSWER class */
-void initializeAnswer(const vector<NETREACTION> &myEtc, const vector<vector<vector<PATHSUMMARY> > > &myPlist, const map<string, vector<VALUESTORE> > &annoteToRxn);
+void initializeAnswer(const vector<NETREACTION> &myEtc, const vector<vector<vector<PATHSUMMARY> > > &myPlist, const map<STRINGID, vector<VALUESTORE> > &annoteToRxn);
 
 #endif // _DATASTRUCTURES_H
@@ -41,15 +41,12 @@ void flip(vector<int> &rxnDirs){
 }
 
 NETREACTION flip(const NETREACTION &one){
-  int i;
   NETREACTION tempN;
   vector<int> tempI;
   tempI = one.rxnDirIds;
   tempN.rxnDirIds = tempI;
   tempN.rxn = one.rxn;
-  for(i=0;i<one.rxn.stoich_part.size();i++){
-    tempN.rxn.stoich_part[i].rxn_coeff *= -1;
-  }
+  tempN.startPartSize = one.startPartSize;
   return tempN;
 }
 
@@ -78,7 +75,7 @@ void identifyETCrxns(const PROBLEM &ProblemSpace, vector<int> &ETCrxnIds){
       k = 0;
       for(int j=0;j<reaction[i].stoich.size();j++){
 	int MetID   = reaction[i].stoich[j].met_id;
-	const char* MetNAME = reaction[i].stoich[j].met_name;
+	const char* MetNAME = ProblemSpace.metabolites.metFromId(MetID).name;
 	if((int)strlen(MetNAME)>=3){
 	  strncpy(tempS,MetNAME+((int)strlen(MetNAME)-3),3);	
 	  if(strcmp(tempS,_db.E_tag)==0){ k++;}
@@ -121,6 +118,7 @@ void identifyETCrxns(const PROBLEM &ProblemSpace, vector<int> &ETCrxnIds, double
 
 void convert(NETREACTION &net, REACTION add, int rxnDirId){
   net.rxn = add;
+  net.startPartSize = add.stoichPart().size();
   net.rxnDirIds.clear();
   net.rxnDirIds.push_back(rxnDirId);
 }
@@ -153,7 +151,7 @@ int netrxn(NETREACTION &net, const PROBLEM &ProblemSpace, int rxnDirId){
   const RXNSPACE &BaseRxns = ProblemSpace.fullrxns;
   const METSPACE &BaseMets = ProblemSpace.metabolites;
 
-  REACTION add = BaseRxns.rxnFromId(abs(rxnDirId));
+  const REACTION &add = BaseRxns.rxnFromId(abs(rxnDirId));
 
   /* Eliminate External Non-players */
   vector<STOICH> fromnet = net.rxn.stoich;
@@ -320,10 +318,9 @@ void ETC(const PROBLEM &ProblemSpace, vector<NETREACTION> &bigout, double cutoff
     net = ETC_add(ProblemSpace,net,bigout);
   }
 
-  /* Unique Chains - problem: should we do this with stoich or stoich_part? */
+  /* Unique Chains */
   for(int i=0;i<bigout.size();i++){
     sort(bigout[i].rxnDirIds.begin(),bigout[i].rxnDirIds.end());
-    sort(bigout[i].rxn.stoich_part.begin(),bigout[i].rxn.stoich_part.end());
   }
 
   for(int i=0;i<bigout.size();i++){
@@ -355,8 +352,9 @@ vector<NETREACTION> ETC_dir_check(const RXNSPACE &rxnspace, const vector<NETREAC
     int numForwardGood = 0;
     for(int j=0;j<bigout[i].rxnDirIds.size();j++){
       //printf("ETC_dir_check: %d %d %d\n",i,k,bigout[i].rxn.net_reversible);
-      if(rxnspace.rxnFromId(rxnIds[j]).net_reversible==0){numForwardGood++;}
-      if(rxnspace.rxnFromId(rxnIds[j]).net_reversible==rxnDirs[j]){numForwardGood++;}
+      int rev = rxnspace.rxnFromId(rxnIds[j]).net_reversible;
+      if(rev==0){numForwardGood++;}
+      if(rev==rxnDirs[j]){numForwardGood++;}
     }
     if(numForwardGood==bigout[i].rxnDirIds.size()){
       bigout2.push_back(bigout[i]);
@@ -368,8 +366,9 @@ vector<NETREACTION> ETC_dir_check(const RXNSPACE &rxnspace, const vector<NETREAC
     flip(rxnDirs);
     int numRevGood = 0;
     for(int j=0;j<bigout[i].rxnDirIds.size();j++){
-      if(rxnspace.rxnFromId(rxnIds[j]).net_reversible==0){numRevGood++;}
-      if(rxnspace.rxnFromId(rxnIds[j]).net_reversible==rxnDirs[j]){numRevGood++;}
+      int rev = rxnspace.rxnFromId(rxnIds[j]).net_reversible;
+      if(rev==0){numRevGood++;}
+      if(rev==rxnDirs[j]){numRevGood++;}
     }
     if(numRevGood==bigout[i].rxnDirIds.size()){
       bigout2.push_back(flip(bigout[i]));
@@ -47,8 +47,9 @@ void ResetFood(vector<REACTION> &reactions){
 // Adjusts Flux limits on Exchange Reactions for each Media condition
 void FeedTheBeast(RXNSPACE &inModel, GROWTH &growth){
   ResetFood(inModel.rxns);
+  inModel.syncAttributes();
   for(int i=0;i<growth.media.size();i++){
-    int j = FindExchange4Metabolite(inModel.rxns,growth.media[i].id);
+    int j = FindExchange4Metabolite(inModel,growth.media[i].id);
     assert(j!=-1);
 
     printf("%d %d\n",growth.media[i].id,j);
@@ -60,7 +61,7 @@ void FeedTheBeast(RXNSPACE &inModel, GROWTH &growth){
 void FeedEnergy(PROBLEM &Model,double flux_bound){
   for(int i=0;i<Model.metabolites.mets.size();i++){
     if(Model.metabolites.mets[i].isSecondary()){
-      int j = FindExchange4Metabolite(Model.fullrxns.rxns,Model.metabolites.mets[i].id);
+      int j = FindExchange4Metabolite(Model.fullrxns,Model.metabolites.mets[i].id);
       int id = j;
       if(j!=-1){
 	REACTION new_exchange = MagicExchange(Model.metabolites.mets[i],1000.0f, 0);
@@ -69,7 +70,7 @@ void FeedEnergy(PROBLEM &Model,double flux_bound){
 	id = new_exchange.id;
       }
       printf("* %d %d %s*\n",Model.metabolites.mets[i].id,j,
-	     Model.metabolites.mets[i].name);
+	     Model.metabolites.mets[i].name.c_str());
       Model.fullrxns.change_Lb_and_Ub(id, -flux_bound, flux_bound);
     }
   }
@@ -87,13 +88,12 @@ REACTION MagicExchange(METABOLITE met,double flux_bound,int dir){
   rxn_add.id = _db.MISSINGEXCHANGEFACTOR + met.id;
 
   /* Size of string could be a problem but for now I left this since we don't want 30 extra spaces in everything... */
-  sprintf(temp,"%s%s","MagicEx_",met.name);
-  strcpy(rxn_add.name,temp);
+  sprintf(temp,"%s%s","MagicEx_",met.name.c_str());
+  rxn_add.name = temp;
   stoich_add.met_id = met.id;
   stoich_add.rxn_coeff = -1;
-  sprintf(stoich_add.met_name,"%s",met.name);
+  stoich_add.secondary = false; /* Primary - Dijkstras has to be able to use the exchange */
   rxn_add.stoich.push_back(stoich_add);
-  rxn_add.stoich_part.push_back(stoich_add);
 
   if(dir <= 0) {  rxn_add.lb = -flux_bound; } else { rxn_add.lb = 0.0f; }
   if(dir >= 0) {  rxn_add.ub = flux_bound;  } else { rxn_add.ub = 0.0f; }
@@ -163,13 +163,48 @@ int FindTransport4Metabolite(const vector<REACTION> &reaction, const METSPACE &m
   return result;
 }
 
+/* TRUE if transporter "rxn" moves met_id <--> pair_id in the direction rxn_direction (same rules as above) */
+static bool transportMatches(const REACTION &rxn, int met_id, int pair_id, int whichExternal, int rxn_direction) {
+  int metIdx(-1), pairIdx(-1);
+  for(int j=0; j<rxn.stoich.size(); j++) {
+    if(metIdx == -1 && rxn.stoich[j].met_id == met_id) { metIdx = j; }
+    if(pairIdx == -1 && rxn.stoich[j].met_id == pair_id) { pairIdx = j; }
+  }
+  if(metIdx == -1 || pairIdx == -1) { return false; }
+  if(rxn.net_reversible == 0) { return true; }
+  double coeff = rxn.stoich[ whichExternal == met_id ? metIdx : pairIdx ].rxn_coeff;
+  if(rxn_direction == -1 && coeff*(double)rxn.net_reversible < 0) { return true; }
+  if(rxn_direction == 1 && coeff*(double)rxn.net_reversible > 0) { return true; }
+  return false;
+}
+
+/* Same as above but uses the per-metabolite transporter index in the RXNSPACE so that only the transporters
+   actually involving met_id are looked at. Candidates come back most likely first so the first one that matches wins. */
+int FindTransport4Metabolite(const RXNSPACE &rxnspace, const METSPACE &metspace, int met_id, 
+			     int rxn_direction){
+  int whichExternal;
+  int pair_id = inOutPair(met_id, metspace);
+
+  if(isExternalMet(metspace.metFromId(met_id).name, _db.E_tag)) { whichExternal = met_id;  } 
+  else {  whichExternal = pair_id;  }
+
+  vector<int> candidates = rxnspace.transporterIdsForMet(met_id);
+  for(int i=0; i<candidates.size(); i++) {
+    const REACTION* rxn = rxnspace.rxnPtrFromId(candidates[i]);
+    /* The linear scan above never accepts anything with likelihood <= -1 (excluded / special reactions) */
+    if(rxn->current_likelihood <= -1.0f) { break; }
+    if(transportMatches(*rxn, met_id, pair_id, whichExternal, rxn_direction)) { return rxn->id; }
+  }
+  return -1;
+}
+
 REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, 
-			char* name, int R){
-  return MagicTransport(reaction,metspace,met_id,&name[0],R,1000.0f);
+			const char* name, int R){
+  return MagicTransport(reaction,metspace,met_id,name,R,1000.0f);
 }
 
 REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, 
-			char* name, int R, double bound){
+			const char* name, int R, double bound){
   REACTION rxn_add;
   char *temp = (char *) malloc(sizeof(char) * 64);
   STOICH stoich_add;
@@ -181,19 +216,16 @@ REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspa
 
   /* Size of string could be a problem but for now I left this since we don't want 30 extra spaces in everything... */
   sprintf(temp,"%s%s","MagicTran_",name);
-  strcpy(rxn_add.name,temp);
+  rxn_add.name = temp;
   stoich_add.met_id = met_id;
   stoich_add.rxn_coeff = -1;
-  sprintf(stoich_add.met_name,"%s",name);
+  stoich_add.secondary = false;
   rxn_add.stoich.push_back(stoich_add);
-  rxn_add.stoich_part.push_back(stoich_add);
   stoich_add.met_id = inOutPair(met_id,metspace);
   if(stoich_add.met_id==-1){
     printf("MagicTransport: ERROR - NO COMPLEMENTARY METABOLITE: %d %s\n",met_id,name);}
   stoich_add.rxn_coeff = 1;
-  sprintf(stoich_add.met_name, "%s", metspace.metFromId(stoich_add.met_id).name);
   rxn_add.stoich.push_back(stoich_add);
-  rxn_add.stoich_part.push_back(stoich_add);
   if(R <= 0) { rxn_add.lb = -bound; } else { rxn_add.lb = 0.0f; }
   if(R >= 0) { rxn_add.ub =  bound; } else { rxn_add.ub = 0.0f; }
 
@@ -236,13 +268,12 @@ void GetTransportReactions(vector<int> metIds, vector<int> rxnDirections, const
   double tmpLikely = 0.0f;
 
   const vector<REACTION> &reaction = ProblemSpace.fullrxns.rxns;
-  const vector<METABOLITE> &metabolite = ProblemSpace.metabolites.mets;
   const METSPACE &metspace = ProblemSpace.metabolites;
 
   for(int i=0;i<metIds.size();i++) {
     if(strcmp(metspace.metFromId(metIds[i]).name, _db.H_name) != 0) {
       /* FindTransport4Metabolite already looks for the most likely and also will account for direction. */
-      int temp = FindTransport4Metabolite(reaction,metspace,metIds[i],rxnDirections[i]);
+      int temp = FindTransport4Metabolite(ProblemSpace.fullrxns,metspace,metIds[i],rxnDirections[i]);
       if(temp == -1){
 	TMPRXN = MagicTransport(reaction,metspace,metIds[i],metspace.metFromId(metIds[i]).name,0);
       } else {
@@ -271,13 +302,13 @@ void GetExchangeReactions(vector<int> metIdList, vector<int> dirs, const PROBLEM
 
   for(int i=0;i<metIdList.size();i++) {
     /* Returns an existing reaction ID if possible */
-    int temp = FindExchange4Metabolite(rxnspace.rxns, metIdList[i]);
+    int temp = FindExchange4Metabolite(rxnspace, metIdList[i]);
     REACTION TMPRXN;
     METABOLITE tmpMet;
 
     if(temp==-1) {
       if(metspace.idIn(metIdList[i])) {
-	sprintf(name, "%s", ProblemSpace.metabolites.metFromId(metIdList[i]).name);
+	sprintf(name, "%s", ProblemSpace.metabolites.metFromId(metIdList[i]).name.c_str());
 	TMPRXN = GrowthExit(rxnspace.rxns, metIdList[i], dirs[i], 1000, name); 
       } else {
 	/* Add the exchange anyway, but warn the user about possible perils... */
@@ -285,8 +316,8 @@ void GetExchangeReactions(vector<int> metIdList, vector<int> dirs, const PROBLEM
 	printf("You should replace this with the METABOLITE entry in the full metabolite vector later. If you are using the full metabolite vector this indicates a major problem. \n");
 	printf("Offending metID: %d\n", metIdList[i]);
 	tmpMet.id = metIdList[i];
-	sprintf(tmpMet.name, "UNKNOWN_ID %d", tmpMet.id);
-	sprintf(name, "%s", tmpMet.name);
+	sprintf(name, "UNKNOWN_ID %d", tmpMet.id);
+	tmpMet.name = name;
 	TMPRXN = GrowthExit(rxnspace.rxns, metIdList[i], dirs[i], 1000, name);
       }
     } else {
@@ -337,3 +368,8 @@ int FindExchange4Metabolite(const vector<REACTION> &reaction, int met_id){
   }
   return -1; /* Exchange not found in database */
 }
+
+/* Same as above but uses the per-metabolite exchange index kept by the RXNSPACE (no scan over all the reactions) */
+int FindExchange4Metabolite(const RXNSPACE &rxnspace, int met_id){
+  return rxnspace.exchangeIdForMet(met_id);
+}
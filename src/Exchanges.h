@@ -8,8 +8,8 @@ void LoadAllExchanges(PROBLEM &ProblemSpace);
 void FeedTheBeast(RXNSPACE &inModel,GROWTH &growth);
 void FeedEnergy(PROBLEM &Model,double flux_bound);
 
-REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, char *name, int R);
-REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, char *name, int R,double bound);
+REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, const char *name, int R);
+REACTION MagicTransport(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, const char *name, int R,double bound);
 REACTION MagicExchange(METABOLITE met,double flux_bound,int dir);
 
 void GetExchangeReactions(vector<int> metIdList, vector<int> directions, const PROBLEM &ProblemSpace, RXNSPACE &exchanges);
@@ -21,8 +21,9 @@ void GetTransportReactionsFromGrowth(const GROWTH &growth, vector<int> rxnDirect
 				     vector<REACTION> &Transporters);
 
 int FindExchange4Metabolite(const vector<REACTION> &reaction, int met_id);
-int FindExchange4Metabolite(const vector<REACTION> &reaction, int met_id);
-int FindTransport4Metabolite(const vector<REACTION> &reaction, int met_id, int rxnDirection);
+int FindExchange4Metabolite(const RXNSPACE &rxnspace, int met_id);
+int FindTransport4Metabolite(const vector<REACTION> &reaction, const METSPACE &metspace, int met_id, int rxnDirection);
+int FindTransport4Metabolite(const RXNSPACE &rxnspace, const METSPACE &metspace, int met_id, int rxnDirection);
 
 
 #endif
@@ -56,43 +56,71 @@ ANSWER gapfillWrapper(const PROBLEM &problemSpace, const vector<PATHSUMMARY> &pL
   
   /* Set up uptake rates and exchanges on/off for the specific growth condition passed here */
   setSpecificGrowthConditions(baseModel, growth);
+  /* The MILP gets the model from before gapfinding turns exits off - it decides for itself which ones to keep */
+  PROBLEM milpModel;
+  if(_db.MILP_GAPFILL) { milpModel = baseModel; }
   vector<GAPFILLRESULT> res = gapFindGapFill(baseModel, problemSpace, gapfillK); 
   vector<int> allEssentialExits;
-  /* Identify the set of gapfill solutions that minimizes the number of essential magic exits and entrances... */
-  vector<int> whichK = findSolutionsMinimizingExits(baseModel, problemSpace, res, allEssentialExits);
+  vector<int> whichK;
+  vector<int> milpAdded;
+  if(_db.MILP_GAPFILL) {
+    /* Start it from the first Dijkstras answer for every gap plus the exits gapfinding kept */
+    vector<int> startIds;
+    for(int i=0; i<res.size(); i++) {
+      startIds.insert(startIds.end(), res[i].deadEndSolutions[0].begin(), res[i].deadEndSolutions[0].end());
+    }
+    const vector<int> &exitIdx = baseModel.fullrxns.idxOfKind(RXN_MAGICEXIT);
+    for(int i=0; i<exitIdx.size(); i++) {
+      const REACTION &exit = baseModel.fullrxns.rxns[exitIdx[i]];
+      if(rougheq(exit.lb, 0.0f, _db.FLUX_CUTOFF)==1 && rougheq(exit.ub, 0.0f, _db.FLUX_CUTOFF)==1) { continue; }
+      startIds.push_back(exit.id);
+    }
+    milpAdded = milpGapfill(milpModel, problemSpace, startIds, allEssentialExits);
+    baseModel = milpModel;
+  } else {
+    /* Identify the set of gapfill solutions that minimizes the number of essential magic exits and entrances... */
+    whichK = findSolutionsMinimizingExits(baseModel, problemSpace, res, allEssentialExits);
+  }
   custom_unique(allEssentialExits);
 
   printf("Final Essential exits: \n");
   for(int i=0; i<allEssentialExits.size(); i++) {
-    printf("%s\t", baseModel.fullrxns.rxnFromId(allEssentialExits[i]).name);
+    printf("%s\t", baseModel.fullrxns.rxnFromId(allEssentialExits[i]).name.c_str());
   }
   printf("\n");
   
   /* Add the whichK to the model before running the next growth condition. Hopefully this minimizes the number of
      redundant answers... */
-  for(int i=0; i<res.size(); i++) {  addGapfillResultToProblem(baseModel, problemSpace, res[i], whichK[i]);  }
-  minimizeExits(baseModel);
+  if(!_db.MILP_GAPFILL) {
+    for(int i=0; i<res.size(); i++) {  addGapfillResultToProblem(baseModel, problemSpace, res[i], whichK[i]);  }
+    /* (the MILP already uses as few exits as possible) */
+    minimizeExits(baseModel);
+  }
   
-  if(_db.PRINTGAPFILLRESULTS) {  PrintGapfillResult(res, problemSpace, whichK);  }
+  if(_db.PRINTGAPFILLRESULTS) {
+    if(_db.MILP_GAPFILL) {
+      printf("Reactions added by the gapfill MILP: \n");
+      for(int i=0; i<milpAdded.size(); i++) { printf("%s\t", baseModel.fullrxns.rxnFromId(milpAdded[i]).name.c_str()); }
+      printf("\n");
+    } else {
+      PrintGapfillResult(res, problemSpace, whichK);
+    }
+  }
 
-  /* Fill up ANSWER structure (note - the point of using the pointers is that all of them must point to the copy INSIDE the class */
+  /* Fill up ANSWER structure (gaps, fixes and exits are stored by ID so the ANSWER can be copied freely) */
   result.reactions = baseModel.fullrxns;
   result.metabolites = baseModel.metabolites;
-  for(int i=0; i<res.size(); i++) {
-    const METABOLITE* fixedPtr = result.metabolites.metPtrFromId(res[i].deadMetId);
-    vector<const REACTION*> fixPtrVec;
-    for(int j=0; j<res[i].deadEndSolutions[whichK[i]].size(); j++) {
-      const REACTION * onePtr = result.reactions.rxnPtrFromId(res[i].deadEndSolutions[whichK[i]][j]);
-      fixPtrVec.push_back(onePtr);
+  if(_db.MILP_GAPFILL) {
+    milpFixes(res, milpAdded, problemSpace, result.fixedGaps, result.fixes);
+  } else {
+    for(int i=0; i<whichK.size(); i++) {
+      result.fixedGaps.push_back(res[i].deadMetId);
+      result.fixes.push_back(res[i].deadEndSolutions[whichK[i]]);
     }
-    result.fixedGaps.push_back(fixedPtr);
-    result.fixes.push_back(fixPtrVec);
-  }
-  for(int i=0; i<allEssentialExits.size(); i++) {
-    const REACTION* essentialExit = result.reactions.rxnPtrFromId(allEssentialExits[i]);
   }
+  result.essentialMagicExits = allEssentialExits;
 
-  MATLAB_out("Optimal_innerloop", result.reactions.rxns); 
+  MATLAB_out("Optimal_innerloop", problemSpace.metabolites, result.reactions.rxns); 
 
   return result;
 }
@@ -292,7 +320,7 @@ double innerScore(PROBLEM &model, const PROBLEM &problemSpace, vector<int> &esse
   printf("Number of essential exits for given model: %d\n", (int)essential.size());
   printf("Essential exits: \n");
   for(int i=0; i<essential.size(); i++) {
-    printf("%s\t", model.fullrxns.rxnFromId(essential[i]).name);
+    printf("%s\t", model.fullrxns.rxnFromId(essential[i]).name.c_str());
   }
   printf("\n");
 
@@ -306,8 +334,59 @@ double innerScore(PROBLEM &model, const PROBLEM &problemSpace, vector<int> &esse
 }
 
 /* Returns TRUE if the knockout was predicted to be lethal and FALSE otherwise */
-bool knockoutLethality(PROBLEM &modified, const string &genename) {
-  return false;
+bool knockoutLethality(PROBLEM &modified, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, STRINGID geneId) {
+  vector<STRINGID> geneIds(1, geneId);
+  return knockoutLethality(modified, geneRxnMap, geneIds)[0];
+}
+
+/* Reactions in rxnspace turned off by knocking out each gene in geneIds on its own (variants[i] for geneIds[i]).
+   The annotations in geneRxnMap are alternatives - any one of a reaction's genes is enough to make it (isozymes) - so
+   a reaction only goes off if the knocked out gene is the only one annotated to it. */
+void knockoutVariants(const RXNSPACE &rxnspace, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, const vector<STRINGID> &geneIds,
+		      vector<vector<BOUNDOVERRIDE> > &variants) {
+  /* Reaction ID --> number of different genes annotated to it */
+  map<int, int> numGenes;
+  for(map<STRINGID, vector<VALUESTORE> >::const_iterator it = geneRxnMap.begin(); it != geneRxnMap.end(); it++) {
+    set<int> geneRxns;
+    for(int j=0; j<it->second.size(); j++) { geneRxns.insert(it->second[j].id); }
+    for(set<int>::iterator rit = geneRxns.begin(); rit != geneRxns.end(); rit++) { numGenes[*rit]++; }
+  }
+
+  variants.clear();
+  variants.resize(geneIds.size());
+  for(int i=0; i<geneIds.size(); i++) {
+    map<STRINGID, vector<VALUESTORE> >::const_iterator it = geneRxnMap.find(geneIds[i]);
+    if(it == geneRxnMap.end()) { continue; }
+    set<int> closed;
+    for(int j=0; j<it->second.size(); j++) {
+      int rxnId = it->second[j].id;
+      if(!rxnspace.idIn(rxnId) || numGenes[rxnId] > 1) { continue; }
+      if(closed.insert(rxnId).second) { variants[i].push_back(BOUNDOVERRIDE(rxnId, 0.0f, 0.0f)); }
+    }
+  }
+}
+
+/* Lethality of each gene knockout in geneIds (one FBA variant per gene, with the reactions knockoutVariants says it
+   turns off). Genes that turn off no reaction in the model (none annotated, or all have another gene) are never lethal. */
+vector<bool> knockoutLethality(PROBLEM &modified, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, const vector<STRINGID> &geneIds) {
+  vector<vector<BOUNDOVERRIDE> > variants;
+  knockoutVariants(modified.fullrxns, geneRxnMap, geneIds, variants);
+
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  /* Knockouts only close reactions, which works on lumped ones too - nothing but the objective has to be kept */
+  COMPRESSEDMODEL lpModel;
+  if(_db.COMPRESS_LP) { compressModel(modified.fullrxns, modified.metabolites, obj, lpModel); }
+  else { lpModel.rxnspace = modified.fullrxns; lpModel.metspace = modified.metabolites; }
+  GLPKDATA data(lpModel, obj, coeff, 1);
+  vector<double> growth; vector<int> statuses;
+  data.batchSolve(variants, growth, statuses);
+
+  vector<bool> lethal(geneIds.size(), false);
+  for(int i=0; i<geneIds.size(); i++) {
+    if(variants[i].empty()) { continue; }
+    lethal[i] = growth[i] < _db.GROWTH_CUTOFF;
+  }
+  return lethal;
 }
 
 
@@ -318,7 +397,7 @@ bool knockoutLethality(PROBLEM &modified, const string &genename) {
 void addGapfillResultToProblem(PROBLEM &model, const PROBLEM &problemSpace, const GAPFILLRESULT &gapfillResult, int whichK) {
   if( gapfillResult.deadEndSolutions.size() <= whichK ) {
     printf("ERROR: Asked for path %d for output metabolite %s but no such path exists!\n", 
-				 whichK, problemSpace.metabolites.metFromId(gapfillResult.deadMetId).name);
+				 whichK, problemSpace.metabolites.metFromId(gapfillResult.deadMetId).name.c_str());
     assert(false);
   }
   for(int i=0; i<gapfillResult.deadEndSolutions[whichK].size(); i++) {
@@ -330,37 +409,178 @@ void addGapfillResultToProblem(PROBLEM &model, const PROBLEM &problemSpace, cons
   }
 }
 
-/* Minimizes magic exit usage in the model by running through them sequentially and seeing if they grow */
+/* Cost of adding rxn in the gapfill MILP by its likelihood code (see adjustLikelihoods), or -1 if it may never be added:
+   HARD DO NOT INCLUDE (-1) is left out, HARD INCLUDE (-2) and SPONTANEOUS (-4) are free and everything else (including
+   BLACK MAGIC and NO LIKELIHOOD) costs its Dijkstras distance, current_likelihood */
+static double milpCost(const REACTION &rxn) {
+  if(rxn.init_likelihood > -1.1f && rxn.init_likelihood < -0.9f) { return -1.0f; }
+  /* (excluded for now - see fillGapWithDijkstras) */
+  if(rxn.current_likelihood > -1.1f && rxn.current_likelihood < -0.9f) { return -1.0f; }
+  if(rxn.init_likelihood > -2.1f && rxn.init_likelihood < -1.9f) { return 0.0f; }
+  if(rxn.init_likelihood > -4.1f && rxn.init_likelihood < -3.9f) { return 0.0f; }
+  return std::max(0.0, rxn.current_likelihood);
+}
+
+/* Splits the MILP answer (added) up by gap for ANSWER::fixedGaps / fixes: a reaction fixes every gap that has it in one of
+   its Dijkstras answers. Reactions in none of them (the MILP found a route Dijkstras didn't) go to the gaps whose dead end
+   metabolite they make or use. */
+void milpFixes(const vector<GAPFILLRESULT> &res, const vector<int> &added, const PROBLEM &problemSpace,
+	       vector<int> &fixedGaps, vector<vector<int> > &fixes) {
+  fixedGaps.clear();  fixes.clear();
+  fixes.resize(res.size());
+  for(int i=0; i<res.size(); i++) { fixedGaps.push_back(res[i].deadMetId); }
+
+  for(int r=0; r<added.size(); r++) {
+    bool placed = false;
+    for(int i=0; i<res.size(); i++) {
+      for(int k=0; k<res[i].deadEndSolutions.size(); k++) {
+	const vector<int> &solution = res[i].deadEndSolutions[k];
+	if(std::find(solution.begin(), solution.end(), added[r]) != solution.end()) {
+	  fixes[i].push_back(added[r]);
+	  placed = true;
+	  break;
+	}
+      }
+    }
+    if(placed) { continue; }
+    const REACTION &rxn = problemSpace.fullrxns.rxnFromId(added[r]);
+    for(int i=0; i<res.size(); i++) {
+      for(int j=0; j<rxn.stoich.size(); j++) {
+	if(rxn.stoich[j].met_id == res[i].deadMetId) { fixes[i].push_back(added[r]);  break; }
+      }
+    }
+  }
+}
+
+/* MILP alternative to choosing among the Dijkstras answers with the genetic algorithm (_db.MILP_GAPFILL).
+   Adds the cheapest set of reactions from problemSpace (cost from milpCost) that lets the model grow, and turns off
+   every magic exit that isn't needed. Each exit costs more than all the candidate reactions together, so the fewest exits
+   come first and likelihood only breaks ties - the same priority innerScore gives them.
+   startIds (reactions and exits) is a known answer for the MILP to start from.
+   Returns the IDs of the reactions added; usedExits gets the exits left on. If the MILP fails the model is not changed. */
+vector<int> milpGapfill(PROBLEM &model, const PROBLEM &problemSpace, const vector<int> &startIds, vector<int> &usedExits) {
+  vector<int> added;
+  usedExits.clear();
+
+  /* Candidates: everything in problemSpace that isn't in the model yet, except magic reactions, synonyms, exchanges and
+     reactions that may never be included (the starting answer is always allowed) */
+  RXNSPACE milpRxns = model.fullrxns;
+  METSPACE milpMets = model.metabolites;
+  set<int> startSet(startIds.begin(), startIds.end());
+  for(int i=0; i<problemSpace.fullrxns.rxns.size(); i++) {
+    const REACTION &rxn = problemSpace.fullrxns.rxns[i];
+    if(milpRxns.idIn(rxn.id)) { continue; }
+    if(startSet.find(rxn.id) == startSet.end()) {
+      if(rxn.kind & (RXN_MAGICEXIT | RXN_MAGICBRIDGE | RXN_SYN | RXN_EXCHANGE)) { continue; }
+      if(milpCost(rxn) < 0.0f) { continue; }
+    }
+    milpRxns.addReaction(rxn);
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      if(!milpMets.idIn(rxn.stoich[j].met_id)) { milpMets.addMetabolite(problemSpace.metabolites.metFromId(rxn.stoich[j].met_id)); }
+    }
+  }
+
+  /* Reactions already in the model are free (negative cost = no binary) */
+  vector<double> cost(milpRxns.rxns.size(), -1.0f);
+  double totalCost = 0.0f;
+  for(int i=model.fullrxns.rxns.size(); i<milpRxns.rxns.size(); i++) {
+    cost[i] = std::max(0.0, milpCost(milpRxns.rxns[i]));
+    totalCost += cost[i];
+  }
+  const vector<int> &exitIdx = milpRxns.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<exitIdx.size(); i++) { cost[exitIdx[i]] = totalCost + 1.0f; }
+
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  GLPKDATA milp(milpRxns, milpMets, obj, coeff, 1);
+  vector<int> onIds;
+  if(milp.minCostMilp(cost, _db.GROWTH_CUTOFF, startIds, onIds) == -1) {
+    printf("ERROR: MILP gapfill failed - the model is unchanged\n");
+    return added;
+  }
+
+  for(int i=0; i<onIds.size(); i++) {
+    const REACTION &rxn = milpRxns.rxnFromId(onIds[i]);
+    if(rxn.kind & RXN_MAGICEXIT) { usedExits.push_back(rxn.id); continue; }
+    added.push_back(rxn.id);
+    model.fullrxns.addReaction(rxn);
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      model.metabolites.addMetabolite(problemSpace.metabolites.metFromId(rxn.stoich[j].met_id));
+    }
+  }
+
+  set<int> keep(usedExits.begin(), usedExits.end());
+  const vector<int> &modelExitIdx = model.fullrxns.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<modelExitIdx.size(); i++) {
+    int exitId = model.fullrxns.rxns[modelExitIdx[i]].id;
+    if(keep.find(exitId) == keep.end()) { model.fullrxns.change_Lb_and_Ub(exitId, 0.0f, 0.0f); }
+  }
+
+  return added;
+}
+
+/* Minimizes magic exit usage in the model by running through them sequentially and seeing if they grow
+   (an exit found to be nonessential stays off while the ones after it are tested).
+
+   The tests go to batchSolve a window of _db.LP_THREADS exits at a time. Variant j of a window also turns off exits
+   0..j-1 of the window on the guess that they are nonessential too. Turning more exits off can only lower growth, so every
+   variant up to and including the first one that doesn't grow gives exactly the answer of the one-at-a-time loop -
+   the next window starts right after it. */
 vector<int> minimizeExits(PROBLEM &model) {
 
   vector<int> requiredExits;
-  vector<double> initialResult = FBA_SOLVE(model.fullrxns, model.metabolites);
-  if(initialResult[model.fullrxns.idxFromId(_db.BIOMASS)] < _db.GROWTH_CUTOFF ) { 
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  COMPRESSEDMODEL lpModel;
+  if(_db.COMPRESS_LP) { compressModel(model.fullrxns, model.metabolites, obj, lpModel); }
+  else { lpModel.rxnspace = model.fullrxns; lpModel.metspace = model.metabolites; }
+  GLPKDATA data(lpModel, obj, coeff, 1);
+
+  vector<vector<BOUNDOVERRIDE> > variants(1);
+  vector<double> growth; vector<int> statuses;
+  data.batchSolve(variants, growth, statuses);
+  if(growth[0] < _db.GROWTH_CUTOFF ) { 
     printf("ERROR: Failure to get growth after adding gapfill reactions\n");
     assert(false);
   }
 
-  for(int i=0; i<model.fullrxns.rxns.size(); i++) {
-    if(model.fullrxns.rxns[i].id >= _db.BLACKMAGICFACTOR && model.fullrxns.rxns[i].id < _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) {
-      REACTION &exit = model.fullrxns.rxns[i];
-      
-      /* Exit is already off */
-      if(rougheq(exit.lb, 0.0f, _db.FLUX_CUTOFF)==1 && rougheq(exit.ub, 0.0f, _db.FLUX_CUTOFF)==1) { continue; }
-      
-      /* Turn off exit and re-run FBA */
-      double oldLb = exit.lb; double oldUb = exit.ub;
-      exit.lb = 0; exit.ub = 0;
-      vector<double> newResult = FBA_SOLVE(model.fullrxns, model.metabolites);
-      if( newResult[model.fullrxns.idxFromId(_db.BIOMASS)] < _db.GROWTH_CUTOFF ) {     
-	if(_db.DEBUGGAPFILL) { printf("Exit %s predicted essential\n", exit.name); }
-	exit.lb = oldLb;
-	exit.ub = oldUb;
-	requiredExits.push_back(exit.id);
-      } else {
-	if(_db.DEBUGGAPFILL) { printf("Exit %s predicted nonessential and will be turned off!\n", exit.name); }
+  /* Exits that are on, in the order they are tested */
+  vector<int> candidates;
+  const vector<int> &exitIdx = model.fullrxns.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<exitIdx.size(); i++) {
+    const REACTION &exit = model.fullrxns.rxns[exitIdx[i]];
+    /* Exit is already off */
+    if(rougheq(exit.lb, 0.0f, _db.FLUX_CUTOFF)==1 && rougheq(exit.ub, 0.0f, _db.FLUX_CUTOFF)==1) { continue; }
+    candidates.push_back(exit.id);
+  }
+
+  vector<BOUNDOVERRIDE> closed; /* Exits turned off so far */
+  int window = std::max(1, _db.LP_THREADS);
+  int next = 0;
+  while(next < candidates.size()) {
+    int windowEnd = std::min((int)candidates.size(), next + window);
+    variants.clear();
+    vector<BOUNDOVERRIDE> overrides = closed;
+    for(int j=next; j<windowEnd; j++) {
+      overrides.push_back(BOUNDOVERRIDE(candidates[j], 0.0f, 0.0f));
+      variants.push_back(overrides);
+    }
+    data.batchSolve(variants, growth, statuses);
+
+    int first = next;
+    for(int j=0; j<variants.size(); j++) {
+      REACTION *exit = model.fullrxns.rxnPtrFromId(candidates[first + j]);
+      next = first + j + 1;
+      if( growth[j] < _db.GROWTH_CUTOFF ) {
+	if(_db.DEBUGGAPFILL) { printf("Exit %s predicted essential\n", exit->name.c_str()); }
+	requiredExits.push_back(exit->id);
+	/* The rest of the window was solved with this exit off */
+	break;
       }
+      if(_db.DEBUGGAPFILL) { printf("Exit %s predicted nonessential and will be turned off!\n", exit->name.c_str()); }
+      exit->lb = 0; exit->ub = 0;
+      closed.push_back(BOUNDOVERRIDE(exit->id, 0.0f, 0.0f));
     }
   }
+  model.fullrxns.syncAttributes();
 
   return requiredExits;
 }
@@ -382,9 +602,9 @@ PROBLEM setUpGapfill(const PROBLEM &problemSpace, const vector<PATHSUMMARY> &pLi
   /* Set up a map from ID to direction to avoid duplicates */
   map<int, int> metId2Dir;
   for(int i=0; i<rxnList.size(); i++) {
-    REACTION tmpRxn = problemSpace.fullrxns.rxnFromId(rxnList[i]);
+    const REACTION &tmpRxn = problemSpace.fullrxns.rxnFromId(rxnList[i]);
     for(int j=0; j<tmpRxn.stoich.size(); j++) {
-      METABOLITE tmpMet = problemSpace.metabolites.metFromId(tmpRxn.stoich[j].met_id);
+      const METABOLITE &tmpMet = problemSpace.metabolites.metFromId(tmpRxn.stoich[j].met_id);
       if(tmpMet.secondary_lone == 1 || (!tmpMet.secondary_pair.empty())) {
 	metId2Dir[tmpMet.id] = 0;
       } else { 
@@ -402,12 +622,12 @@ PROBLEM setUpGapfill(const PROBLEM &problemSpace, const vector<PATHSUMMARY> &pLi
     dirs.push_back(it->second);
   }
 
-  REACTION biomass = problemSpace.fullrxns.rxnFromId(_db.BIOMASS);
+  const REACTION &biomass = problemSpace.fullrxns.rxnFromId(_db.BIOMASS);
   int basenum;
   makeSimulatableModel(pList, problemSpace, biomass, exitIds, dirs, working, basenum);
 
   /* Needed for cost calculation (scoring function) */
-  adjustLikelihoods(working.fullrxns.rxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
+  adjustLikelihoods(working.fullrxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
 
   return working;
 }
@@ -422,25 +642,36 @@ vector<int> gapFind(const PROBLEM &md, const vector<PATHSUMMARY> &psum) {
   /* Initialize list of entrances */
   /* Also, turn any EXITS off (keep ENTRANCES on) */
   vector<int> entranceSet;
-  for(int i=0; i<model.fullrxns.rxns.size(); i++) {
-    if(model.fullrxns.rxns[i].id >= _db.BLACKMAGICFACTOR && model.fullrxns.rxns[i].id < _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) {
-      if(model.fullrxns.rxns[i].lb < 0.0f) { entranceSet.push_back(model.fullrxns.rxns[i].id); }
-      model.fullrxns.rxns[i].ub = 0.0f;
-    }
+  const vector<int> &exitIdx = model.fullrxns.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<exitIdx.size(); i++) {
+    REACTION &exit = model.fullrxns.rxns[exitIdx[i]];
+    if(exit.lb < 0.0f) { entranceSet.push_back(exit.id); }
+    exit.ub = 0.0f;
   }
+  model.fullrxns.syncAttributes();
 
   vector<int> deadEnds;
   REACTION bm = model.fullrxns.rxnFromId(_db.BIOMASS);
+
+  /* Test for existing production of each biomass component (one objective sweep over their exchanges) */
+  vector<int> grExits;
   for(int i=0; i<bm.stoich.size(); i++) {
-    /* Test for existing production of the biomass component. */
-    int grExit = FindExchange4Metabolite(model.fullrxns.rxns, bm.stoich[i].met_id);
-    if(grExit == -1) { printf("ERROR: No exchange reaction found for metabolite %s which is impossible under our proposed schema...\n", bm.stoich[i].met_name); assert(false); }
+    int grExit = FindExchange4Metabolite(model.fullrxns, bm.stoich[i].met_id);
+    if(grExit == -1) { printf("ERROR: No exchange reaction found for metabolite %s which is impossible under our proposed schema...\n", model.metabolites.metFromId(bm.stoich[i].met_id).name.c_str()); assert(false); }
+    grExits.push_back(grExit);
+  }
+  vector<int> bmObj(1, _db.BIOMASS); vector<double> bmCoeff(1, 1.0f);
+  GLPKDATA sweep(model.fullrxns, model.metabolites, bmObj, bmCoeff, 1);
+  vector<double> maxProduction; vector<int> statuses;
+  sweep.objectiveSweep(grExits, false, maxProduction, statuses);
 
+  for(int i=0; i<bm.stoich.size(); i++) {
     /* If we can already make the target without adding more magic exits, great. */
-    vector<int> obj(1, grExit); vector<double> coeff(1, 1.0f);    
+    if(maxProduction[i] > 0.0f) { continue; }
+    vector<int> obj(1, grExits[i]); vector<double> coeff(1, 1.0f);    
     GLPKDATA data(model.fullrxns, model.metabolites, obj, coeff, 1);
-    vector<double> fbaResult = data.FBA_SOLVE();
-    if(fbaResult[model.fullrxns.idxFromId(grExit)] > 0.0f) { continue; }
+    vector<vector<BOUNDOVERRIDE> > variants;
+    vector<double> objValues; vector<vector<double> > fluxes;
     
     /* Get the psum associated with the particular biomass component in question. */
     PATHSUMMARY bmPath;
@@ -458,19 +689,21 @@ vector<int> gapFind(const PROBLEM &md, const vector<PATHSUMMARY> &psum) {
       bool reactantsMade(true);
       bool productsMade(true);
 
-      /* Test for production of (nominal) reactants and products */
+      /* Test for production of (nominal) reactants and products - one variant per exchange, with just that exchange turned on */
+      vector<int> exitIds;
+      variants.clear();
       for(int k=0; k<st.size(); k++) {
-	int exitId = FindExchange4Metabolite(model.fullrxns.rxns, st[k].met_id);
+	int exitId = FindExchange4Metabolite(model.fullrxns, st[k].met_id);
 	if(exitId == -1) { printf("ERROR: Missing exchange reaction...\n"); assert(false); }
-	/* Turn exchange on and try to get flux through it */
-        model.fullrxns.rxnPtrFromId(exitId)->ub = 1000.0f;
-	GLPKDATA tmp(model.fullrxns, model.metabolites, obj, coeff, 1);
-        vector<double> res = tmp.FBA_SOLVE();
-	if(res[model.fullrxns.idxFromId(exitId)] < _db.FLUX_CUTOFF) { 
+	exitIds.push_back(exitId);
+	variants.push_back(vector<BOUNDOVERRIDE>(1, BOUNDOVERRIDE(exitId, model.fullrxns.rxnFromId(exitId).lb, 1000.0f)));
+      }
+      data.batchSolve(variants, objValues, statuses, &fluxes);
+      for(int k=0; k<st.size(); k++) {
+	if(fluxes[k][model.fullrxns.idxFromId(exitIds[k])] < _db.FLUX_CUTOFF) { 
 	  if(st[k].rxn_coeff < 0.0f) { reactantsMade = false; }
 	  else { productsMade = false; }
 	}
-	model.fullrxns.rxnPtrFromId(exitId)->ub = 0.0f;
       }
 
       /* Test if reactans can be made but products cannot - and test if adding a exit of one chemical allows flux through another (on the same side of the reaction) 
@@ -497,7 +730,7 @@ vector<GAPFILLRESULT> gapFindGapFill(PROBLEM &model, const PROBLEM &problemSpace
   vector<GAPFILLRESULT> result;
   vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
 
-  if(_db.PRINTSHOULDGROW) { MATLAB_out("./outputs/Pre_gapfind", model.fullrxns.rxns); }
+  if(_db.PRINTSHOULDGROW) { MATLAB_out("./outputs/Pre_gapfind", model.metabolites, model.fullrxns.rxns); }
 
   GLPKDATA datainit(model.fullrxns, model.metabolites, obj, coeff, 1);
 
@@ -507,27 +740,28 @@ vector<GAPFILLRESULT> gapFindGapFill(PROBLEM &model, const PROBLEM &problemSpace
   GLPKDATA data(model.fullrxns, model.metabolites, obj, coeff, 1);
 
   vector<int> idVector;
-  int status  = data.gapFindLinprog(idVector);
+  int status  = _db.GAPFIND_SPLIT_LP ? data.gapFindSplitLinprog(idVector) : data.gapFindLinprog(idVector);
   set<int> idList; for(int i=0; i<idVector.size(); i++) { idList.insert(model.fullrxns.rxnFromId(idVector[i]).stoich[0].met_id); }
 
   /* Skip over the turning off of magic exits if gapfinding failed */
   if(status == -1) { printf("Gap pruning failed! Will attempt to recover using ALL possible exits...\n"); 
   } else {  
-    for(int i=0; i<model.fullrxns.rxns.size(); i++) {
-      /* Only work on magic exits */
-      if(model.fullrxns.rxns[i].id < _db.BLACKMAGICFACTOR || model.fullrxns.rxns[i].id > _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) { continue; }    
+    /* Only work on magic exits */
+    const vector<int> &exitIdx = model.fullrxns.idxOfKind(RXN_MAGICEXIT);
+    for(int i=0; i<exitIdx.size(); i++) {
+      const REACTION &exit = model.fullrxns.rxns[exitIdx[i]];
       /* Turn off the exit if it's not on the list we obtained from gapFindLinprog() */
-      set<int>::iterator it = idList.find(model.fullrxns.rxns[i].stoich[0].met_id);
+      set<int>::iterator it = idList.find(exit.stoich[0].met_id);
       if(it == idList.end()) {
-	model.fullrxns.change_Lb_and_Ub(model.fullrxns.rxns[i].id, 0.0f, 0.0f);
-	if(_db.DEBUGGAPFILL) { printf("Turned off reaction %s\n", model.fullrxns.rxns[i].name); }
+	model.fullrxns.change_Lb_and_Ub(exit.id, 0.0f, 0.0f);
+	if(_db.DEBUGGAPFILL) { printf("Turned off reaction %s\n", exit.name.c_str()); }
       } else {
-	if(_db.DEBUGGAPFILL) { printf("Kept on reaction %s\n", model.fullrxns.rxns[i].name); }
+	if(_db.DEBUGGAPFILL) { printf("Kept on reaction %s\n", exit.name.c_str()); }
       }
     }
   }
 
-  if(_db.PRINTSHOULDGROW) { MATLAB_out("./outputs/Pre_gapfill", model.fullrxns.rxns); }
+  if(_db.PRINTSHOULDGROW) { MATLAB_out("./outputs/Pre_gapfill", model.metabolites, model.fullrxns.rxns); }
 
   /* DATA struct with the exits actually turned off */
   GLPKDATA data2(model.fullrxns, model.metabolites, obj, coeff, 1);
@@ -549,7 +783,7 @@ vector<GAPFILLRESULT> gapFindGapFill(PROBLEM &model, const PROBLEM &problemSpace
       /* FIXME: Why does the fillGapWithDijkstras sometimes give us empty results at the end of vectors with non-empty results? */
       if(dijkstrasSln[j].empty()) { continue; }
       if(_db.PRINTGAPFILLRESULTS) { printf("Dijkstras solution for exit of metabolite %s (magic exit): \n", 
-					  model.metabolites.metFromId(*it).name);
+					  model.metabolites.metFromId(*it).name.c_str());
 	printRxnsFromIntVector(dijkstrasSln[j], problemSpace.fullrxns);
       }
       completeList.push_back(dijkstrasSln[j]);
@@ -561,7 +795,7 @@ vector<GAPFILLRESULT> gapFindGapFill(PROBLEM &model, const PROBLEM &problemSpace
       dijkstrasSln = fillGapWithDijkstras(model.fullrxns, model.metabolites, tmpProblem, *it, -1, gapfillK);
       for(int j=0; j<dijkstrasSln.size(); j++) {
 	if(_db.PRINTGAPFILLRESULTS) {
-	  printf("Dijkstras solution for exit of metabolite %s (magic entrance): \n", tmpMet.name);
+	  printf("Dijkstras solution for exit of metabolite %s (magic entrance): \n", tmpMet.name.c_str());
 	  printRxnsFromIntVector(dijkstrasSln[j], problemSpace.fullrxns); }
 	completeList.push_back(dijkstrasSln[j]); 
       }
@@ -591,8 +825,8 @@ vector<vector<int> > fillGapWithDijkstras(RXNSPACE &workingRxns, METSPACE &worki
   /* Cutoff - if the total cost of a gap becomes more than badCut * the shortest path, we just throw it out */
   double badCut = 2;
 
-  /* Replace stoich_part with stoich */
-  for(int i=0; i<wholeProblem.fullrxns.rxns.size(); i++) { wholeProblem.fullrxns.rxns[i].stoich_part = wholeProblem.fullrxns.rxns[i].stoich;  }
+  /* Let Dijkstras see the secondary metabolites too */
+  for(int i=0; i<wholeProblem.fullrxns.rxns.size(); i++) { wholeProblem.fullrxns.rxns[i].includeSecondaries();  }
 
   vector<vector<int> > rxnsFillingGap;
   double minLength(10000.0f);
@@ -600,7 +834,7 @@ vector<vector<int> > fillGapWithDijkstras(RXNSPACE &workingRxns, METSPACE &worki
   int origRxnSize = workingRxns.rxns.size();  int origMetSize = workingMets.mets.size();
 
   /* Find the magic exit for the given metabolite toFix, and turn it off */
-  int meId = FindExchange4Metabolite(workingRxns.rxns, toFix);
+  int meId = FindExchange4Metabolite(workingRxns, toFix);
   double oldLb(-1.0f), oldUb(-1.0f);
   if(meId == -1) {
      printf("WARNING: metabolite %d was passed to fillGapWithDijkstras but does not have an exchange reaction to turn off in workingRxns\n", toFix);
@@ -669,8 +903,7 @@ vector<vector<int> > fillGapWithDijkstras(RXNSPACE &workingRxns, METSPACE &worki
     /* Check that gapfill reactions carry flux - add them if they do this and they satisfy
        the likelihood cutoff compared to the best solution */
     vector<int> obj(1, result[i].rxnIds[0]);  vector<double> coeff(1, 1.0f);
-    GLPKDATA data(workingRxns, workingMets, obj, coeff, 1);
-    vector<double> fbaResult = data.FBA_SOLVE();
+    vector<double> fbaResult = FBA_SOLVE(workingRxns, workingMets, obj, coeff, 1);
     if( rougheq(fbaResult[workingRxns.idxFromId(result[i].rxnIds[0])], 0.0f, _db.FLUX_CUTOFF) == 0 ) {
       /* Apply cost cutoff */
       double totalCost = 0.0f;
@@ -706,27 +939,29 @@ vector<vector<int> > fillGapWithDijkstras(RXNSPACE &workingRxns, METSPACE &worki
     workingRxns.rxnPtrFromId(meId)->lb = oldLb;
     workingRxns.rxnPtrFromId(meId)->ub = oldUb;
   }
+  workingRxns.syncAttributes();
+  allRxns.syncAttributes();
 
   return rxnsFillingGap;
 }
 
 void setSpecificGrowthConditions(PROBLEM &model, const GROWTH &growth) {
   /* Turn off exchange reactions (aside from those that are magic exits / entrances) */
-  for(int i=0; i<model.fullrxns.rxns.size(); i++) {
-    if(model.fullrxns.rxns[i].id >= _db.BLACKMAGICFACTOR && model.fullrxns.rxns[i].id < _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) {  continue;    }
-    if(model.fullrxns.rxns[i].isExchange) {
-      model.fullrxns.rxns[i].lb = 0;
-      model.fullrxns.rxns[i].net_reversible = 1;
-    }
+  const vector<int> &exchangeIdx = model.fullrxns.idxOfKind(RXN_EXCHANGE);
+  for(int i=0; i<exchangeIdx.size(); i++) {
+    REACTION &exchange = model.fullrxns.rxns[exchangeIdx[i]];
+    if(exchange.kind & RXN_MAGICEXIT) {  continue;    }
+    exchange.lb = 0;
+    exchange.net_reversible = 1;
   }
 
   /* Set the media components to be uptaken at specified rates (negative because they are uptaken) */
   map <int,bool> meList;
   for(int i=0; i<growth.media.size(); i++) {
-    int meId = FindExchange4Metabolite(model.fullrxns.rxns, growth.media[i].id);
+    int meId = FindExchange4Metabolite(model.fullrxns, growth.media[i].id);
     if(meId == 0) { 
       printf("ERROR: No exchange present for media condition %s after calling checkExchangesAndTransports \n", 
-	     model.metabolites.metFromId(growth.media[i].id).name);
+	     model.metabolites.metFromId(growth.media[i].id).name.c_str());
       assert(false);
     }
     model.fullrxns.rxnPtrFromId(meId) -> lb =  -growth.media[i].rate;
@@ -738,10 +973,10 @@ void setSpecificGrowthConditions(PROBLEM &model, const GROWTH &growth) {
 
   /* Set the byproducts to be output at non-specified rates */
   for(int i=0; i<growth.byproduct.size(); i++) {
-    int meId = FindExchange4Metabolite(model.fullrxns.rxns, growth.byproduct[i].id);
+    int meId = FindExchange4Metabolite(model.fullrxns, growth.byproduct[i].id);
     if(meId == 0) { 
       printf("ERROR: No exchange present for byproduct %s after calling checkExchangesAndTransports \n", 
-	     model.metabolites.metFromId(growth.byproduct[i].id).name);
+	     model.metabolites.metFromId(growth.byproduct[i].id).name.c_str());
       assert(false);
     }
     model.fullrxns.rxnPtrFromId(meId) -> ub =  1000.0f;
@@ -750,9 +985,10 @@ void setSpecificGrowthConditions(PROBLEM &model, const GROWTH &growth) {
       model.fullrxns.rxns[i].net_reversible = 1;
     }
     else{
-      printf("WARNING: %s both a byproduct and a media component.\n",model.metabolites.metFromId(growth.byproduct[i].id).name);
+      printf("WARNING: %s both a byproduct and a media component.\n",model.metabolites.metFromId(growth.byproduct[i].id).name.c_str());
     }
   }
+  model.fullrxns.syncAttributes();
 }
 
 void addATPM(PROBLEM &A, ANSWER &B){
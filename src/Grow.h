@@ -40,6 +40,11 @@ vector<vector<int> > fillGapWithDijkstras(RXNSPACE &workingRxns, METSPACE &worki
 void addGapfillResultToProblem(PROBLEM &model, const PROBLEM &problemSpace, 
 			       const GAPFILLRESULT &gapfillResult, int whichK);
 vector<int> minimizeExits(PROBLEM &model);
+/* [inner loop] One MILP in place of the Dijkstras answers + genetic algorithm (see _db.MILP_GAPFILL) */
+vector<int> milpGapfill(PROBLEM &model, const PROBLEM &problemSpace, const vector<int> &startIds, vector<int> &usedExits);
+/* Split a milpGapfill answer up by the gaps in res (for ANSWER::fixedGaps / fixes) */
+void milpFixes(const vector<GAPFILLRESULT> &res, const vector<int> &added, const PROBLEM &problemSpace,
+	       vector<int> &fixedGaps, vector<vector<int> > &fixes);
 
 /* [inner loop] Genetic algorithm helper functions */
 vector<int> findSolutionsMinimizingExits(const PROBLEM &baseModel, const PROBLEM &problemSpace, const vector<GAPFILLRESULT> &res, vector<int> &essential);
@@ -53,7 +58,12 @@ INNERPOPSTORE mutate(const vector<INNERPOPSTORE> &parents, const vector<GAPFILLR
 void setSpecificGrowthConditions(PROBLEM &model, const GROWTH &growth);
 
 /* Test if knockout of a particular gene is predicted to be lethal in the given PROBLEM... */
-bool knockoutLethality(PROBLEM &modified, const map<string, vector<VALUESTORE> > &geneRxnMap, const string &genename);
+bool knockoutLethality(PROBLEM &modified, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, STRINGID geneId);
+/* Same for many genes at once (one batched FBA) */
+vector<bool> knockoutLethality(PROBLEM &modified, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, const vector<STRINGID> &geneIds);
+/* The reactions each single-gene knockout turns off (a reaction with another annotated gene stays on) */
+void knockoutVariants(const RXNSPACE &rxnspace, const map<STRINGID, vector<VALUESTORE> > &geneRxnMap, const vector<STRINGID> &geneIds,
+		      vector<vector<BOUNDOVERRIDE> > &variants);
 
 /* Modify the GAM or NGAM values */
 void addATPM(PROBLEM &A, ANSWER &B);
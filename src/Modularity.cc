@@ -2,6 +2,9 @@
 #include"XML_loader.h"
 #include"pathUtils.h"
 
+#include<algorithm>
+#include<queue>
+
 /*Functions*/
 
 void AllHardIncludes(const vector<REACTION> &biglist, vector<REACTION> &small_list){
@@ -21,3 +24,85 @@ void SynIncludes(PROBLEM &Model){
 }
 
 
+
+/* Orders indexes by the degree stored for them */
+class DEGREEORDER{
+ public:
+  const vector<int> &degree;
+  DEGREEORDER(const vector<int> &d) : degree(d) {}
+  bool operator()(int a, int b) const { return degree[a] < degree[b]; }
+};
+
+/* Reverse Cuthill-McKee order of the (non-secondary) metabolite-reaction graph: breadth-first from the lowest-degree
+   metabolite of each connected piece, visiting neighbours lowest degree first, then reversed. Metabolites and reactions
+   that are close in the network end up close in storage. Anything only connected through secondary metabolites goes at 
+   the end in its original order. rxnOrder[i] / metOrder[i] are the current index of what should go at index i */
+void localityOrder(const RXNSPACE &rxnspace, const METSPACE &metspace, vector<int> &rxnOrder, vector<int> &metOrder){
+  int numRxns = rxnspace.rxns.size();
+  int numMets = metspace.mets.size();
+  vector<vector<int> > metAdj(numMets), rxnAdj(numRxns);
+  for(int r=0; r<numRxns; r++) {
+    const vector<STOICH> &stoich = rxnspace.rxns[r].stoich;
+    for(int j=0; j<stoich.size(); j++) {
+      if(stoich[j].secondary || !metspace.idIn(stoich[j].met_id)) { continue; }
+      int m = metspace.idxFromId(stoich[j].met_id);
+      metAdj[m].push_back(r);
+      rxnAdj[r].push_back(m);
+    }
+  }
+  vector<int> metDegree(numMets), rxnDegree(numRxns);
+  for(int m=0; m<numMets; m++) { metDegree[m] = metAdj[m].size(); }
+  for(int r=0; r<numRxns; r++) { rxnDegree[r] = rxnAdj[r].size(); }
+  for(int m=0; m<numMets; m++) { std::stable_sort(metAdj[m].begin(), metAdj[m].end(), DEGREEORDER(rxnDegree)); }
+  for(int r=0; r<numRxns; r++) { std::stable_sort(rxnAdj[r].begin(), rxnAdj[r].end(), DEGREEORDER(metDegree)); }
+
+  vector<int> seeds(numMets);
+  for(int m=0; m<numMets; m++) { seeds[m] = m; }
+  std::stable_sort(seeds.begin(), seeds.end(), DEGREEORDER(metDegree));
+
+  vector<bool> metSeen(numMets, false), rxnSeen(numRxns, false);
+  rxnOrder.clear();
+  metOrder.clear();
+  /* Reactions are queued as -(index+1) so both kinds fit in one queue */
+  std::queue<int> toVisit;
+  for(int s=0; s<numMets; s++) {
+    if(metSeen[seeds[s]] || metDegree[seeds[s]] == 0) { continue; }
+    metSeen[seeds[s]] = true;
+    toVisit.push(seeds[s]);
+    while(!toVisit.empty()) {
+      int next = toVisit.front();
+      toVisit.pop();
+      if(next >= 0) {
+	metOrder.push_back(next);
+	for(int k=0; k<metAdj[next].size(); k++) {
+	  int r = metAdj[next][k];
+	  if(rxnSeen[r]) { continue; }
+	  rxnSeen[r] = true;
+	  toVisit.push(-(r+1));
+	}
+      } else {
+	int r = -next - 1;
+	rxnOrder.push_back(r);
+	for(int k=0; k<rxnAdj[r].size(); k++) {
+	  int m = rxnAdj[r][k];
+	  if(metSeen[m]) { continue; }
+	  metSeen[m] = true;
+	  toVisit.push(m);
+	}
+      }
+    }
+  }
+  std::reverse(metOrder.begin(), metOrder.end());
+  std::reverse(rxnOrder.begin(), rxnOrder.end());
+  for(int m=0; m<numMets; m++) {  if(!metSeen[m]) { metOrder.push_back(m); }  }
+  for(int r=0; r<numRxns; r++) {  if(!rxnSeen[r]) { rxnOrder.push_back(r); }  }
+}
+
+/* Renumber the storage of fullrxns and metabolites so neighbours in the network are neighbours in memory (see localityOrder).
+   Only indexes change, never IDs - call it right after loading, before anything holds on to indexes */
+void reorderForLocality(PROBLEM &ProblemSpace){
+  vector<int> rxnOrder, metOrder;
+  localityOrder(ProblemSpace.fullrxns, ProblemSpace.metabolites, rxnOrder, metOrder);
+  ProblemSpace.fullrxns.reorder(rxnOrder);
+  ProblemSpace.metabolites.reorder(metOrder);
+}
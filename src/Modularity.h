@@ -7,5 +7,7 @@
 
 void AllHardIncludes(const vector<REACTION> &biglist, vector<REACTION> &smalllist);
 void SynIncludes(PROBLEM &Model);
+void localityOrder(const RXNSPACE &rxnspace, const METSPACE &metspace, vector<int> &rxnOrder, vector<int> &metOrder);
+void reorderForLocality(PROBLEM &ProblemSpace);
 
 #endif
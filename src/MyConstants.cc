@@ -11,6 +11,41 @@ DEBUGFLAGS::DEBUGFLAGS() {
   /******************* K-shortest parameters *********/
   INITIAL_K = 1;
   GAPFILL_K = 3;
+  /* Memory (in MB) the candidate queue of a single K-shortest query may use before the least likely
+     half of it is thrown away. Only matters for very large K - results past that point may miss some paths */
+  KSHORTEST_MAXQUEUE_MB = 512;
+  /* How K-shortest finds its spur paths. BATCH_SPURS: SPUR_LANES at a time with batchShortestPaths (one pass over the
+     network for several exclusions). Otherwise one Dijkstras per spur - from scratch, or with INCREMENTAL_SPURS by
+     repairing the labels of the path they branch from (repairShortestPath). INCREMENTAL_SPURS only matters with
+     BATCH_SPURS off, and the batched search does not use the repaired labels, so with the defaults the repair path
+     (and the SSSPSTATE that findShortestPath fills for it) is never run - it is legacy, kept only so SpurBench can
+     compare against it. SpurBench (default network, one thread) times all three: from scratch 12.9s, repaired 5.7s,
+     batched 0.58s with -mavx2 (55.4s / 21.6s / 2.1s without) */
+  BATCH_SPURS = true;
+  INCREMENTAL_SPURS = false;
+  /* Networks with at least this many reactions get the first path of each K-shortest query from parallelShortestPath
+     (all threads on one search) instead of findShortestPath */
+  PARALLEL_SEARCH_MIN_RXNS = 20000;
+  /* True to renumber reactions and metabolites after loading so neighbours in the network sit together in memory
+     (see reorderForLocality). IDs are unchanged but anything that depends on storage order - e.g. which of several
+     equally good FBA solutions GLPK returns - may change */
+  REORDER_FOR_LOCALITY = false;
+  /* Number of landmarks used to bound the distance to the output in the spur searches of multi-output K-shortest queries
+     (they share one table). Single-output queries use one backward search from their output instead. 0 turns goal
+     direction off for both */
+  NUM_LANDMARKS = 4;
+  /* Number of threads GLPKDATA::batchSolve spreads the variants of one model over. GLPK can only be called from
+     several threads at once if it was built with thread-local storage - leave this at 1 otherwise */
+  LP_THREADS = 1;
+  /* True to have minimizeExits and knockoutLethality solve a compressed copy of the model (blocked reactions and dead-end
+     metabolites removed, linear chains lumped - see compressModel). The growth they compute should not change. Nothing
+     else is compressed - the FBA_SOLVE calls in measureScore and fillGapWithDijkstras always solve the full model.
+     CompressTester compares the compressed and full growth rates - off until it has been run against GLPK */
+  COMPRESS_LP = false;
+  /* Number of FBA_SOLVE answers kept for models that come up again (same reactions, bounds and objective) - the GA scores
+     the same model for many genomes, for one. Each keeps a copy of its model's bounds and stoichiometry (about 80 KB
+     for a 1000-reaction model). 0 turns the cache off */
+  FBA_CACHE_SIZE = 64;
 
   /* Annotation cutoff - remove annotations that are less than this
      probability compared to the maximum  [one reaction --> multiple genes cutoff]
@@ -24,6 +59,14 @@ DEBUGFLAGS::DEBUGFLAGS() {
   /******************** Algorithmic switches *********/
   /* True if you want to use maximum-parsimony instaed of maximum-likelihood */
   PARSIMONY = false;
+  /* True to pick the magic exits to keep before gapfilling with one LP (gapFindSplitLinprog - minimum total exit flux)
+     instead of FVA followed by the bonus / penalty LP in gapFindLinprog. See zGapFindCompare.cc */
+  GAPFIND_SPLIT_LP = false;
+  /* True to have gapfillWrapper choose the reactions to add with one MILP (milpGapfill) instead of picking among the
+     Dijkstras answers with the genetic algorithm. The Dijkstras answers are still found and used as its starting point */
+  MILP_GAPFILL = false;
+  /* Seconds the gapfill MILP may run before the best solution found so far is used */
+  MILP_TIME_LIMIT = 600;
 
   /************ Output file switches ******************/
   /* True if you want to output visualization of paths */
@@ -13,6 +13,18 @@ class DEBUGFLAGS{
 
   int GAPFILL_K;
   int INITIAL_K;
+  int KSHORTEST_MAXQUEUE_MB;
+  bool INCREMENTAL_SPURS;
+  bool BATCH_SPURS;
+  int PARALLEL_SEARCH_MIN_RXNS;
+  bool REORDER_FOR_LOCALITY;
+  int NUM_LANDMARKS;
+  int LP_THREADS;
+  bool COMPRESS_LP;
+  int FBA_CACHE_SIZE;
+  bool GAPFIND_SPLIT_LP;
+  bool MILP_GAPFILL;
+  int MILP_TIME_LIMIT;
   double ANNOTE_CUTOFF_1;
   double ANNOTE_CUTOFF_2;
 
@@ -32,20 +32,22 @@ vector<int> findRxnsToIncludeFromSyn(const REACTION &TMPSYN, const RXNSPACE &ful
   
   /* Un-Synonymize - ensure correct direction [or reversible] */
   if(TMPSYN.id >= _db.SYNFACTOR && TMPSYN.id <= _db.SYNFACTOR + _db.MINFACTORSPACING ){ 
+    STOICH synFirst = TMPSYN.stoichPart()[0];
     for(int j=0;j<TMPSYN.syn.size();j++) {
 
       /* Find one metabolite in common between the synrxn and its full version */
       REACTION TMPRXN = fullrxns.rxnFromId(TMPSYN.syn[j]);
       int metIdx;
-      for(int k=0;k<TMPRXN.stoich_part.size();k++) {
-	if(TMPRXN.stoich_part[k].met_id == TMPSYN.stoich_part[0].met_id) {
+      for(int k=0;k<TMPRXN.stoich.size();k++) {
+	if(TMPRXN.stoich[k].secondary) { continue; }
+	if(TMPRXN.stoich[k].met_id == synFirst.met_id) {
 	  metIdx = k;  break;  }
       }
       
       /* Identify if the reactions go the same way */
       bool sameDir = false;
-      if( ( TMPRXN.net_reversible == 1 && TMPRXN.stoich_part[metIdx].rxn_coeff*TMPSYN.stoich_part[0].rxn_coeff > 0 ) ||
-	  ( TMPRXN.net_reversible == -1 && TMPRXN.stoich_part[metIdx].rxn_coeff*TMPSYN.stoich_part[0].rxn_coeff < 0) ) {
+      if( ( TMPRXN.net_reversible == 1 && TMPRXN.stoich[metIdx].rxn_coeff*synFirst.rxn_coeff > 0 ) ||
+	  ( TMPRXN.net_reversible == -1 && TMPRXN.stoich[metIdx].rxn_coeff*synFirst.rxn_coeff < 0) ) {
 	/* Both reactions go the same way */
 	sameDir = true;
       }
@@ -93,26 +95,27 @@ vector<int> fillMagicBridges(const PATHSUMMARY &currentPsum, const vector<PATHSU
   METSPACE allMets = ProblemSpace.metabolites;
   calcMetRxnRelations(ProblemSpace.fullrxns, allMets);
 
-  REACTION bridge = ProblemSpace.synrxns.rxnFromId(abs(bridgeToFill));
+  const REACTION &bridge = ProblemSpace.synrxns.rxnFromId(abs(bridgeToFill));
   
   /* We want the filling reaction to contain [metToConsume --> metToProduce] */
   int metToProduce; int metToConsume;
-  for(int i=0; i<bridge.stoich_part.size(); i++) {
+  for(int i=0; i<bridge.stoich.size(); i++) {
+    if(bridge.stoich[i].secondary) { continue; }
     if(bridgeToFill < 0) { 
-      if(bridge.stoich_part[i].rxn_coeff < 0) { metToProduce = bridge.stoich_part[i].met_id;   }
-      else                                    { metToConsume = bridge.stoich_part[i].met_id;   }
+      if(bridge.stoich[i].rxn_coeff < 0) { metToProduce = bridge.stoich[i].met_id;   }
+      else                               { metToConsume = bridge.stoich[i].met_id;   }
     } else {
-      if(bridge.stoich_part[i].rxn_coeff < 0) { metToConsume = bridge.stoich_part[i].met_id;   }
-      else                                    { metToProduce = bridge.stoich_part[i].met_id;   }
+      if(bridge.stoich[i].rxn_coeff < 0) { metToConsume = bridge.stoich[i].met_id;   }
+      else                               { metToProduce = bridge.stoich[i].met_id;   }
     }
   }
 
-  vector<int> rxnsWithProdMet = allMets.metFromId(metToConsume).rxnsInvolved_nosec;
+  const vector<int> &rxnsWithProdMet = allMets.metFromId(metToConsume).rxnsInvolved_nosec;
 
   vector<int> tmpSuggested;
   vector<bool> allCof;
   for(int i=0; i<rxnsWithProdMet.size(); i++) {
-    REACTION tmp = ProblemSpace.fullrxns.rxnFromId(rxnsWithProdMet[i]);
+    const REACTION &tmp = ProblemSpace.fullrxns.rxnFromId(rxnsWithProdMet[i]);
 
     /* don't try to fill with the biomass equation. That's bad. */
     if(tmp.id == _db.BIOMASS) { continue; }
@@ -159,7 +162,7 @@ vector<int> fillMagicBridges(const PATHSUMMARY &currentPsum, const vector<PATHSU
 
     bool metsIn = true;
     for(int j=0; j<tmp.stoich.size(); j++) {
-      METABOLITE tmpMet = ProblemSpace.metabolites.metFromId(tmp.stoich[j].met_id);
+      const METABOLITE &tmpMet = ProblemSpace.metabolites.metFromId(tmp.stoich[j].met_id);
       if(tmpMet.secondary_lone == 1 | (!tmpMet.secondary_pair.empty())) { continue; }
       if(!modelSynMets.idIn(tmpMet.id)) { metsIn = false; break; }
     }
@@ -175,7 +178,7 @@ vector<int> fillMagicBridges(const PATHSUMMARY &currentPsum, const vector<PATHSU
        and the only exception was accoa/coa, which was filled by PDH. */
     bool oneAllCof = true;
     for(int j=0; j<tmp.stoich.size(); j++) {
-      METABOLITE tmpMet = ProblemSpace.metabolites.metFromId(tmp.stoich[j].met_id);
+      const METABOLITE &tmpMet = ProblemSpace.metabolites.metFromId(tmp.stoich[j].met_id);
       if(tmpMet.secondary_lone == 1 | (!tmpMet.secondary_pair.empty())) { continue; }
       oneAllCof = false;
       break;
@@ -270,9 +273,9 @@ vector<int> fillMagicBridges(const PATHSUMMARY &currentPsum, const vector<PATHSU
   }
 
   if(_db.DEBUGBRIDGES) {
-    printf("Suggested reaction(s) to fill magic exit %s:\n", bridge.name);
+    printf("Suggested reaction(s) to fill magic exit %s:\n", bridge.name.c_str());
     for(int i=0; i<suggestedRxnIds.size(); i++) {
-      printf("%s(%1.3f)\t", ProblemSpace.fullrxns.rxnFromId(suggestedRxnIds[i]).name, ProblemSpace.fullrxns.rxnFromId(suggestedRxnIds[i]).init_likelihood);
+      printf("%s(%1.3f)\t", ProblemSpace.fullrxns.rxnFromId(suggestedRxnIds[i]).name.c_str(), ProblemSpace.fullrxns.rxnFromId(suggestedRxnIds[i]).init_likelihood);
     }
     printf("\n");
   }
@@ -540,7 +543,7 @@ void checkExchangesAndTransporters(PROBLEM &working, const PROBLEM &ProblemSpace
     // Could cause issues if someone passes both a metabolite and its pair as mets to check so we check for that 
     // condition here  
     int pairId = inOutPair(metsToCheck[i], allMets);
-    if(pairId == -1) { printf("ERROR: Metabolite %s (%d) has no internal metabolite\n", allMets.metFromId(metsToCheck[i]).name, metsToCheck[i]); throw; }
+    if(pairId == -1) { printf("ERROR: Metabolite %s (%d) has no internal metabolite\n", allMets.metFromId(metsToCheck[i]).name.c_str(), metsToCheck[i]); throw; }
     if(!workingMets.idIn(pairId)) {
       workingMets.addMetabolite(allMets.metFromId(pairId));
     }
@@ -578,5 +581,6 @@ void checkExchangesAndTransporters(PROBLEM &working, const PROBLEM &ProblemSpace
       }
     }
   }
+  workingRxns.syncAttributes();
   return;
 }
@@ -51,10 +51,10 @@ void printIntSet(const set<int> &mySet) {
 
 /***************** Metablite / reaction printers ****************/
 
-void printRxnFormula(const REACTION &rxn, char* rxnString, bool printStoichPart) {
+void printRxnFormula(const METSPACE &metspace, const REACTION &rxn, char* rxnString, bool printStoichPart) {
   vector<STOICH> st;
   if(printStoichPart) {
-    st = rxn.stoich_part;
+    st = rxn.stoichPart();
   } else {
     st = rxn.stoich;
   }
@@ -66,7 +66,7 @@ void printRxnFormula(const REACTION &rxn, char* rxnString, bool printStoichPart)
       rxnCoeff *= -1;
     }
     char oneReactantString[96];
-    sprintf(oneReactantString, "%1.4f %s", rxnCoeff, st[i].met_name);
+    sprintf(oneReactantString, "%1.4f %s", rxnCoeff, metspace.metFromId(st[i].met_id).name.c_str());
     strcat(rxnString, oneReactantString);
 
     if(i != st.size() - 1) {
@@ -99,7 +99,7 @@ void printRxnFormula(const REACTION &rxn, char* rxnString, bool printStoichPart)
 
 void printMETABOLITEinputs(const METABOLITE &metabolite){
   printf("\tid: %05d\n",metabolite.id);
-  printf("\tname: %s\n",metabolite.name);
+  printf("\tname: %s\n",metabolite.name.c_str());
   printf("\tcharge: %d\n",metabolite.charge);
   printf("\tinput: %d  ",metabolite.input);
   if(metabolite.input==0){ printf("(NO)\n");} else{printf("(YES)\n");}
@@ -118,7 +118,7 @@ void printMETABOLITEinputs(const METABOLITE &metabolite){
   printf("\n");
 }
 
-void printGROWTHinputs(const GROWTH &growth){
+void printGROWTHinputs(const METSPACE &metspace, const GROWTH &growth){
   int i;
   printf("GROWTH MEDIA:\n");
   for(i=0;i<growth.media.size();i++){
@@ -137,23 +137,23 @@ void printGROWTHinputs(const GROWTH &growth){
   printf("\tnum_of_metabolites: %d\n",(int)growth.biomass.size());
   if(growth.biomass.size() > 0){
     printf("\n BIOMASS EQUATION:\n\n");
-    printSTOICHIOMETRY_by_id(growth.biomass,growth.biomass.size(),1);}
+    printSTOICHIOMETRY_by_id(metspace,growth.biomass,growth.biomass.size(),1);}
   printf("\nGROWTH RATE: %f\n\n",growth.growth_rate);
 }
 
 void printSynRxns(const RXNSPACE &synrxns, const RXNSPACE &fullrxns) {
   for(int i=0; i<synrxns.rxns.size(); i++) {
-    printf("Reaction %s (rev=%d) synrxns: ", synrxns.rxns[i].name, synrxns.rxns[i].net_reversible);
+    printf("Reaction %s (rev=%d) synrxns: ", synrxns.rxns[i].name.c_str(), synrxns.rxns[i].net_reversible);
     for(int j=0; j<synrxns.rxns[i].syn.size(); j++) {
-      printf("%s (rev=%d); ", fullrxns.rxnFromId(synrxns.rxns[i].syn[j]).name, fullrxns.rxnFromId(synrxns.rxns[i].syn[j]).net_reversible);
+      printf("%s (rev=%d); ", fullrxns.rxnFromId(synrxns.rxns[i].syn[j]).name.c_str(), fullrxns.rxnFromId(synrxns.rxns[i].syn[j]).net_reversible);
     }
     printf("\n");
   }
 }
 
-void printREACTIONintermediates(const REACTION &reaction, int print_type){
+void printREACTIONintermediates(const METSPACE &metspace, const REACTION &reaction, int print_type){
   printf("\tid: %05d\n",reaction.id);
-  printf("\tname: %s\n",reaction.name);
+  printf("\tname: %s\n",reaction.name.c_str());
   printf("\treversible: %d  ",reaction.net_reversible);
   if(reaction.net_reversible==0){ printf("(YES)\n");}
   if(reaction.net_reversible==-1){ printf("(NO - BACKWARDS)\n");}
@@ -171,16 +171,17 @@ void printREACTIONintermediates(const REACTION &reaction, int print_type){
   if(reaction.stoich.size() > 0){
     if(print_type==1){
       printf("\n STOICHIOMETRY:\n\n");
-      printSTOICHIOMETRY_by_id(reaction.stoich,reaction.stoich.size(),
+      printSTOICHIOMETRY_by_id(metspace,reaction.stoich,reaction.stoich.size(),
                                reaction.init_reversible);}
   }
   printf("\n");
-  printf("\tnum_of_non_secondary_metabolites: %d\n", (int)reaction.stoich_part.size());
-  if(reaction.stoich_part.size() > 0){
+  vector<STOICH> stoichPart = reaction.stoichPart();
+  printf("\tnum_of_non_secondary_metabolites: %d\n", (int)stoichPart.size());
+  if(stoichPart.size() > 0){
     if(print_type==1){
       printf("\n STOICHIOMETRY:\n\n");
-      printSTOICHIOMETRY_by_id(reaction.stoich_part,
-                               reaction.stoich_part.size(),
+      printSTOICHIOMETRY_by_id(metspace,stoichPart,
+                               stoichPart.size(),
                                reaction.init_reversible);}
   }
   printf("\n");
@@ -195,7 +196,7 @@ void printREACTIONintermediates(const REACTION &reaction, int print_type){
 }
 
 
-void printSTOICHIOMETRY_by_id(const vector<STOICH> &stoich, int num_met, int rev){
+void printSTOICHIOMETRY_by_id(const METSPACE &metspace, const vector<STOICH> &stoich, int num_met, int rev){
   unsigned int i;
   STOICH temps;
   vector<STOICH> tempv = stoich;
@@ -215,26 +216,26 @@ void printSTOICHIOMETRY_by_id(const vector<STOICH> &stoich, int num_met, int rev
   /* Print reaction */
   i=0;
   while(tempv[i].rxn_coeff<0){
-    printf("%2.2f %s ",tempv[i].rxn_coeff,tempv[i].met_name);
+    printf("%2.2f %s ",tempv[i].rxn_coeff,metspace.metFromId(tempv[i].met_id).name.c_str());
     if(tempv[i+1].rxn_coeff<0){ printf("+ ");}
     i++;}
   if(rev==-1){ printf(" <--  ");}
   if(rev==0) { printf(" <--> ");}
   if(rev==1) { printf("  --> ");}
   while(tempv[i].rxn_coeff>0 && i<tempv.size()){
-    printf("%2.2f %s ",tempv[i].rxn_coeff,tempv[i].met_name);
+    printf("%2.2f %s ",tempv[i].rxn_coeff,metspace.metFromId(tempv[i].met_id).name.c_str());
     if(i!=(tempv.size()-1)){ printf("+ ");}
     i++;}
   printf("\n");
 }
 
-void printREACTIONvector(const vector<REACTION> &reaction, int print_type) {
-  for(unsigned int i=0; i<reaction.size(); i++) { printREACTIONinputs(reaction[i], print_type);}
+void printREACTIONvector(const METSPACE &metspace, const vector<REACTION> &reaction, int print_type) {
+  for(unsigned int i=0; i<reaction.size(); i++) { printREACTIONinputs(metspace, reaction[i], print_type);}
 }
 
-void printREACTIONinputs(const REACTION &reaction, int print_type){
+void printREACTIONinputs(const METSPACE &metspace, const REACTION &reaction, int print_type){
   printf("\tid: %05d\n",reaction.id);
-  printf("\tname: %s\n",reaction.name);
+  printf("\tname: %s\n",reaction.name.c_str());
   printf("\tinit_reversible: %d  ",reaction.init_reversible);
   if(reaction.init_reversible==0){ printf("(YES)\n");}
   if(reaction.init_reversible==-1){ printf("(NO - BACKWARDS)\n");}
@@ -271,16 +272,17 @@ void printREACTIONinputs(const REACTION &reaction, int print_type){
   if(reaction.stoich.size() > 0){
     if(print_type==1){
       printf("\n STOICHIOMETRY:\n\n");
-      printSTOICHIOMETRY_by_id(reaction.stoich,reaction.stoich.size(),
+      printSTOICHIOMETRY_by_id(metspace,reaction.stoich,reaction.stoich.size(),
                                reaction.init_reversible);}
   }
   printf("\n");
-  printf("\tnum_of_non_secondary_metabolites: %d\n", (int)reaction.stoich_part.size());
-  if(reaction.stoich_part.size() > 0){
+  vector<STOICH> stoichPart = reaction.stoichPart();
+  printf("\tnum_of_non_secondary_metabolites: %d\n", (int)stoichPart.size());
+  if(stoichPart.size() > 0){
     if(print_type==1){
       printf("\n STOICHIOMETRY:\n\n");
-      printSTOICHIOMETRY_by_id(reaction.stoich_part,
-                               reaction.stoich_part.size(),
+      printSTOICHIOMETRY_by_id(metspace,stoichPart,
+                               stoichPart.size(),
                                reaction.init_reversible);}
   }
   printf("\n");
@@ -290,7 +292,7 @@ void printREACTIONinputs(const REACTION &reaction, int print_type){
 void printRxnsFromIntVector(const vector<int> &intVector, const RXNSPACE &rxnspace) {
   if(intVector.empty()) {printf("EMPTY\n"); return;}
   for(int i=0;i<intVector.size();i++){
-    printf("%s(%4.3f) ", rxnspace.rxnFromId(abs(intVector[i])).name, rxnspace.rxnFromId(abs(intVector[i])).init_likelihood);
+    printf("%s(%4.3f) ", rxnspace.rxnFromId(abs(intVector[i])).name.c_str(), rxnspace.rxnFromId(abs(intVector[i])).init_likelihood);
   }
   printf("\n");
 }
@@ -298,7 +300,7 @@ void printRxnsFromIntVector(const vector<int> &intVector, const RXNSPACE &rxnspa
 void printRxnsFromIntSet(const set<int> &intSet, const RXNSPACE &rxnspace) {
   if(intSet.empty()) { printf("EMPTY\n"); return; }
   for(set<int>::iterator it=intSet.begin(); it!=intSet.end(); it++) {
-    printf("%s(%4.3f) ", rxnspace.rxnFromId(*it).name, rxnspace.rxnFromId(*it).init_likelihood);
+    printf("%s(%4.3f) ", rxnspace.rxnFromId(*it).name.c_str(), rxnspace.rxnFromId(*it).init_likelihood);
   }
   printf("\n");
   return;
@@ -307,7 +309,7 @@ void printRxnsFromIntSet(const set<int> &intSet, const RXNSPACE &rxnspace) {
 void printMetsFromIntVector(const vector<int> &intVector, const PROBLEM &ProblemSpace) {
   if(intVector.empty()) {printf("EMPTY\n"); return;}
   for(int i=0;i<intVector.size();i++){
-    printf("%s ", ProblemSpace.metabolites.metFromId(intVector[i]).name);
+    printf("%s ", ProblemSpace.metabolites.metFromId(intVector[i]).name.c_str());
   }
   printf("\n");
 }
@@ -321,7 +323,7 @@ void printDoubleVector_rxns(const RXNSPACE &rxnspace, const vector<double> &doub
   }
   for(int i=0; i<doubleVec.size(); i++) {
     if(doubleVec[i] > 0.0001 || doubleVec[i] < -0.0001) {
-      printf("%s\t%1.3f\n", rxnspace.rxns[i].name, doubleVec[i]);
+      printf("%s\t%1.3f\n", rxnspace.rxns[i].name.c_str(), doubleVec[i]);
     }
   }
   return;
@@ -336,17 +338,17 @@ void printDoubleVector_mets(const METSPACE &metspace, const vector<double> &doub
   }
   for(int i=0; i<doubleVec.size(); i++) {
     if(doubleVec[i] > 0.0001 || doubleVec[i] < -0.0001) {
-      printf("%s\t%1.3f\n", metspace.mets[i].name, doubleVec[i]);
+      printf("%s\t%1.3f\n", metspace.mets[i].name.c_str(), doubleVec[i]);
     }
   }
   return;
 }
 
 
-void printMetsFromStoich(vector<STOICH> a){
+void printMetsFromStoich(const METSPACE &metspace, vector<STOICH> a){
   int i;
   for(i=0;i<a.size();i++){
-    printf("%s ",a[i].met_name);
+    printf("%s ",metspace.metFromId(a[i].met_id).name.c_str());
   }
   printf("\n");
   return;
@@ -360,7 +362,7 @@ void printNetReactionVector(const vector<NETREACTION> &netReactions, const PROBL
     printf("ETC %d: ", i);
     for(int j=0; j<netReactions[i].rxnDirIds.size(); j++) {
       REACTION tmpRxn = problemSpace.fullrxns.rxnFromId(abs(netReactions[i].rxnDirIds[j]));
-      printf("%s(%4.3f)\t", tmpRxn.name, tmpRxn.init_likelihood);
+      printf("%s(%4.3f)\t", tmpRxn.name.c_str(), tmpRxn.init_likelihood);
     }
     printf("\n");
   }
@@ -438,7 +440,7 @@ void printPathResults(const vector<PATH> &path, PROBLEM &ProblemSpace) {
 /* ALso prints reaction likelihoods from rxnspace (why do we need this if the rxnspace is also found in PROBLEMSPACE?) */
 void printPathResults(const vector<PATH> &path, PROBLEM &ProblemSpace, RXNSPACE &rxnspace) {
   for(unsigned int i=0;i<path.size();i++) {
-    printf("Path number: %d corresponding to output %s...\n", i, ProblemSpace.metabolites.metFromId(path[i].outputId).name);
+    printf("Path number: %d corresponding to output %s...\n", i, ProblemSpace.metabolites.metFromId(path[i].outputId).name.c_str());
     printf("Inputs required to reach output: "); 
     printMetsFromIntVector(path[i].inputIds,ProblemSpace);
     printf("Number of reactions: ");
@@ -482,10 +484,10 @@ void PrintPathSummary2(const vector<vector<vector<PATHSUMMARY> > > &psum, PROBLE
 void PrintGapfillResult(const vector<GAPFILLRESULT> &res, const PROBLEM &problemSpace, const vector<int> &kToPrint) {
   for(int j=0; j<res.size(); j++) {
     if(res[j].deadEndSolutions.size() == 0) { continue; }
-    printf("%s (k=%d) --> ", problemSpace.metabolites.metFromId(res[j].deadMetId).name, kToPrint[j]);
+    printf("%s (k=%d) --> ", problemSpace.metabolites.metFromId(res[j].deadMetId).name.c_str(), kToPrint[j]);
     for(int n=0; n<res[j].deadEndSolutions[kToPrint[j]].size(); n++) {
       REACTION tmp = problemSpace.fullrxns.rxnFromId(res[j].deadEndSolutions[kToPrint[j]][n]);
-      printf("%s(%4.3f)\t", tmp.name, tmp.init_likelihood);
+      printf("%s(%4.3f)\t", tmp.name.c_str(), tmp.init_likelihood);
     }
     printf("\n");
   }
@@ -494,7 +496,7 @@ void PrintGapfillResult(const vector<GAPFILLRESULT> &res, const PROBLEM &problem
 /******************** Output files ***************/
 
 /* Output reactions in InRxns to a text file (including name and direction) */
-void MATLAB_out(const char* fileName, const vector<REACTION> &InRxns){
+void MATLAB_out(const char* fileName, const METSPACE &metspace, const vector<REACTION> &InRxns){
   unsigned int i,j,k;
   STOICH temps;
   vector<STOICH> stoich;
@@ -525,12 +527,12 @@ void MATLAB_out(const char* fileName, const vector<REACTION> &InRxns){
     }
 
     /* 1st column: Print out name */
-    fprintf(output,"%s\t",InRxns[i].name);
+    fprintf(output,"%s\t",InRxns[i].name.c_str());
 
     /* 2nd column: Print out reaction */
     for(j=0,k=0;j<stoich.size();j++){
       if(stoich[j].rxn_coeff < 0.0f){
-        fprintf(output,"%1.8f %s",-stoich[j].rxn_coeff,stoich[j].met_name);
+        fprintf(output,"%1.8f %s",-stoich[j].rxn_coeff,metspace.metFromId(stoich[j].met_id).name.c_str());
         if((j+1) < stoich.size() && stoich[j+1].rxn_coeff < 0.0f){ fprintf(output," + ");}
       }
       /* If either 1) the sign changes between the current and next STOICH, or
@@ -543,7 +545,7 @@ void MATLAB_out(const char* fileName, const vector<REACTION> &InRxns){
         if(InRxns[i].net_reversible==-1){fprintf(output," <-- ");}
       }
       if(stoich[j].rxn_coeff > 0.0f){
-        fprintf(output,"%1.8f %s",stoich[j].rxn_coeff,stoich[j].met_name);
+        fprintf(output,"%1.8f %s",stoich[j].rxn_coeff,metspace.metFromId(stoich[j].met_id).name.c_str());
         if((j+1) < stoich.size()){ fprintf(output," + ");}
       }
     }
@@ -587,7 +589,7 @@ void PATHS_rxns_out(const char* fileName, const vector<PATHSUMMARY> &psum, const
   for(int i=0; i<psum.size(); i++) {
     for(int j=0; j<psum[i].rxnDirIds.size(); j++) {
       fprintf(output, "%ld\t%d\t%s\t%d\t%s\t%d\t%4.3f\n",
-	      psum[i].id, psum[i].growthIdx[0], metspace.metFromId(psum[i].outputId).name, psum[i].k_number, rxnspace.rxnFromId(abs(psum[i].rxnDirIds[j])).name, psum[i].rxnDirIds[j], 
+	      psum[i].id, psum[i].growthIdx[0], metspace.metFromId(psum[i].outputId).name.c_str(), psum[i].k_number, rxnspace.rxnFromId(abs(psum[i].rxnDirIds[j])).name.c_str(), psum[i].rxnDirIds[j], 
 	      rxnspace.rxnFromId(abs(psum[i].rxnDirIds[j])).init_likelihood);
     }
   }
@@ -615,7 +617,7 @@ void PATHS_mets_out(const char* fileName, const vector<PATHSUMMARY> &psum, const
       REACTION tmp = rxnspace.rxnFromId(abs(psum[i].rxnDirIds[j]));
       for(int k=0; k<tmp.stoich.size(); k++) {
 	fprintf(output, "%ld\t%d\t%s\t%d\t%s\t%s\n",
-		psum[i].id, psum[i].growthIdx[0], metspace.metFromId(psum[i].outputId).name, psum[i].k_number, metspace.metFromId(tmp.stoich[k].met_id).name, tmp.name);
+		psum[i].id, psum[i].growthIdx[0], metspace.metFromId(psum[i].outputId).name.c_str(), psum[i].k_number, metspace.metFromId(tmp.stoich[k].met_id).name.c_str(), tmp.name.c_str());
       }
     }
   }
@@ -630,7 +632,7 @@ void ANNOTATIONS_out(const char* filename, const vector<REACTION> &annotated_rea
   fprintf(output, "%s\t%s\t%s\n", "REACTION", "ANNOTATION", "GENE_PROBABILITY");
   for(int i=0; i<annotated_reaction_list.size(); i++) {
     for(int j=0; j<annotated_reaction_list[i].annote.size(); j++) {
-      fprintf(output, "%s\t%s\t%4.3f\n", annotated_reaction_list[i].name, annotated_reaction_list[i].annote[j].genename.c_str(), annotated_reaction_list[i].annote[j].probability);
+      fprintf(output, "%s\t%s\t%4.3f\n", annotated_reaction_list[i].name.c_str(), annotated_reaction_list[i].annote[j].genename.c_str(), annotated_reaction_list[i].annote[j].probability);
     }
   }
   fclose(output);
@@ -1,6 +1,7 @@
 #include "DataStructures.h"
 #include "kShortest.h"
 #include "genericLinprog.h"
+#include "Modularity.h"
 #include "MyConstants.h"
 #include "Paths2Model.h"
 #include "pathUtils.h"
@@ -41,6 +42,7 @@ void InputSetup(int argc, char *argv[], PROBLEM &ProblemSpace) {
   /* Parse XML files and do some of the initial setup steps (which should be moved here) */
   parseALL(docName, docName2, ProblemSpace);
   ProblemSpace.fullrxns.rxnMap();
+  if(_db.REORDER_FOR_LOCALITY) { reorderForLocality(ProblemSpace); }
 
   /* Ensure that exchangers and transprots exist for everything in the GROWTH conditions (media and byproducts) */
   vector<GROWTH> &growth = ProblemSpace.growth;
@@ -71,7 +73,7 @@ void InputSetup(int argc, char *argv[], PROBLEM &ProblemSpace) {
 	printf("SYN %d: ", ProblemSpace.synrxns.rxns[i].id);
 	for(int j=0;j<ProblemSpace.synrxns.rxns[i].syn.size();j++) {
 	  printf("%s(%d) ;  ", 
-		 ProblemSpace.fullrxns.rxnFromId(ProblemSpace.synrxns.rxns[i].syn[j]).name, 
+		 ProblemSpace.fullrxns.rxnFromId(ProblemSpace.synrxns.rxns[i].syn[j]).name.c_str(), 
 		 ProblemSpace.synrxns.rxns[i].syn[j]);
 	}
 	printf("\n");
@@ -82,7 +84,7 @@ void InputSetup(int argc, char *argv[], PROBLEM &ProblemSpace) {
   if(_db.DEBUGSYN) {
     printf("METRXNRELATIONS:\n");
     for(int i=0;i<ProblemSpace.metabolites.mets.size();i++) {
-      printf("%s:  ", ProblemSpace.metabolites.mets[i].name);
+      printf("%s:  ", ProblemSpace.metabolites.mets[i].name.c_str());
       printIntVector(ProblemSpace.metabolites.mets[i].rxnsInvolved_nosec);
     }
   }
@@ -123,12 +125,15 @@ void InputSetup(int argc, char *argv[], PROBLEM &ProblemSpace) {
     for(int i=0; i<ProblemSpace.synrxns.rxns.size(); i++) { ProblemSpace.synrxns.rxns[i].current_likelihood = 1;}
     for(int i=0; i<ProblemSpace.synrxnsR.rxns.size(); i++) { ProblemSpace.synrxnsR.rxns[i].current_likelihood = 1; }
     for(int i=0; i<ProblemSpace.fullrxns.rxns.size(); i++) { ProblemSpace.fullrxns.rxns[i].current_likelihood = 1; }
+    ProblemSpace.synrxns.syncAttributes();
+    ProblemSpace.synrxnsR.syncAttributes();
+    ProblemSpace.fullrxns.syncAttributes();
   } else {
-    /* void adjustLikelihoods(vector<REACTION> &rxnList, double spont_likely, double black_magic_likely,
+    /* void adjustLikelihoods(RXNSPACE &rxnspace, double spont_likely, double black_magic_likely,
        double hard_include_likely, double no_likely, bool adjustNonspecial) */
-    adjustLikelihoods(ProblemSpace.synrxns.rxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
-    adjustLikelihoods(ProblemSpace.synrxnsR.rxns,  1.0f, -3.0f, 1.1f, -10.0f, true);
-    adjustLikelihoods(ProblemSpace.fullrxns.rxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
+    adjustLikelihoods(ProblemSpace.synrxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
+    adjustLikelihoods(ProblemSpace.synrxnsR,  1.0f, -3.0f, 1.1f, -10.0f, true);
+    adjustLikelihoods(ProblemSpace.fullrxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
   }
 
   return;
@@ -165,7 +170,7 @@ void Run_K(PROBLEM &ProblemSpace, vector<MEDIA> &media, RXNSPACE &rxnspace, int
     #pragma omp parallel for
     for(int j=0;j<kpaths.size();j++){
       char s[128];
-      sprintf(s, "./outputs/path_%s_k%d.dot", ProblemSpace.metabolites.metFromId(outputId).name, j);
+      sprintf(s, "./outputs/path_%s_k%d.dot", ProblemSpace.metabolites.metFromId(outputId).name.c_str(), j);
       VisualizePath2File(s, s, kpaths[j], ProblemSpace, 1);
     }
   }
@@ -250,7 +255,7 @@ void FirstKPass(PROBLEM &ProblemSpace, int K, vector<vector<vector<PATHSUMMARY>
     for(int j=0;j<outputIds.size();j++){
       if(_db.DEBUGPATHS) {
 	printf("FirstKPass: growth %d of %d   output %d(%s) of %d\n",i+1,(int)ProblemSpace.growth.size(),j+1,
-	       ProblemSpace.metabolites.metFromId(outputIds[j]).name,
+	       ProblemSpace.metabolites.metFromId(outputIds[j]).name.c_str(),
 	       (int)outputIds.size());
       }
       vector<PATHSUMMARY> tempP1;
@@ -290,7 +295,7 @@ void SecondKPass(PROBLEM &ProblemSpace, int K, vector<vector<vector<PATHSUMMARY>
     for(int j=0;j<psum[i].size();j++){
       if(_db.DEBUGPATHS) {
 	printf("SecondKPass: growth %d of %d   output %s (%d of %d)\n",i+1,(int)psum.size(),
-	       ProblemSpace.metabolites.metFromId(outputIds[i][j]).name, 
+	       ProblemSpace.metabolites.metFromId(outputIds[i][j]).name.c_str(), 
 	       j+1,(int)psum[i].size());
       }
 
@@ -328,14 +333,13 @@ REACTION MagicExit(const vector<REACTION> &reaction, int met_id, const char* nam
   rxn_add.id = _db.BLACKMAGICFACTOR + met_id;
 
   sprintf(temp,"%s%s","MagicExit_",name);
-  strcpy(rxn_add.name,temp);
+  rxn_add.name = temp;
 
 
   stoich_add.met_id = met_id;
   stoich_add.rxn_coeff = -1;
-  sprintf(stoich_add.met_name,"%s",name);
+  stoich_add.secondary = false;
   rxn_add.stoich.push_back(stoich_add);
-  rxn_add.stoich_part.push_back(stoich_add);
 
   return rxn_add;
 }
@@ -353,17 +357,15 @@ REACTION GrowthExit(const vector<REACTION> &reaction, int met_id, int reversible
 
   /* could be an issue in case of long met names */
   sprintf(temp, "%s%s", "GrowthExit_", name); 
-  strcpy(rxn_add.name,temp);
+  rxn_add.name = temp;
  //printf("Made GrowthExit: %s\n",rxn_add.name);
   rxn_add.init_reversible = reversible;
   rxn_add.net_reversible = reversible;
   rxn_add.id = _db.BLACKMAGICFACTOR + met_id;
   stoich_add.met_id = met_id;
   stoich_add.rxn_coeff = -1;
-  /* No need to cut off here, name same from a size-64 string and being printed into the same */
-  sprintf(stoich_add.met_name,"%s",name);
+  stoich_add.secondary = false;
   rxn_add.stoich.push_back(stoich_add);
-  rxn_add.stoich_part.push_back(stoich_add);
   if(reversible > 0) { rxn_add.lb = 0.0f; } else { rxn_add.lb = -fluxBound; }
   if(reversible < 0) { rxn_add.ub = 0.0f; } else { rxn_add.ub = fluxBound;  }
 
@@ -376,9 +378,13 @@ as specified in the vector<stoich> */
 REACTION MakeObjRxn(const vector<STOICH> &stoichVec) {
   REACTION obj;
   obj.id = _db.BIOMASS;
-  strcpy(obj.name, "BIOMASS_CUST");
-  obj.stoich = stoichVec;
-  obj.stoich_part = stoichVec;
+  obj.name = "BIOMASS_CUST";
+  /* Every metabolite in the objective is primary (the STOICHs passed in may carry flags from the reactions they came from) */
+  for(int i=0; i<stoichVec.size(); i++) {
+    STOICH st = stoichVec[i];
+    st.secondary = false;
+    obj.stoich.push_back(st);
+  }
   obj.net_reversible = 1;
   obj.init_reversible = 1;
   /* Set these to make it consistent with the reversibility */
@@ -398,17 +404,21 @@ REACTION MakeBiomassFromGrowth(const GROWTH &growth){
 int inOutPair(int met_id, const METSPACE &metspace){ 
   unsigned int i;
   int flag;
-  bool isExternal = isExternalMet(metspace.metFromId(met_id).name, _db.E_tag);
+  const char *metName = metspace.metFromId(met_id).name;
+  bool isExternal = isExternalMet(metName, _db.E_tag);
   char tempS[64] = {0};
   if(isExternal){
-    strncpy(tempS,metspace.metFromId(met_id).name,(int)strlen(metspace.metFromId(met_id).name)-3);
+    strncpy(tempS,metName,(int)strlen(metName)-3);
   } else {
-    strcat(tempS,metspace.metFromId(met_id).name);
+    strcat(tempS,metName);
     strcat(tempS,_db.E_tag);
   }
 
+  /* Names are interned so the pair (if it exists at all) has a handle we can compare against */
+  STRINGID pairName = findInternedString(tempS);
+  if(pairName == 0) { return -1; }
   for(i=0;i<metspace.mets.size();i++){
-    if(strcmp(tempS,metspace.mets[i].name)==0){
+    if(metspace.mets[i].name.id() == pairName){
       return metspace.mets[i].id;
     } 
   }
@@ -457,7 +467,9 @@ void GoodReversible(PROBLEM &ProblemSpace){
 	temp = ProblemSpace.synrxnsR.rxns[i];
 	temp.id += _db.REVFACTOR;
 	temp.init_likelihood = -3; /* BLACK MAGIC */
-	strcat(temp.name,"_REV");
+	char revName[80];
+	sprintf(revName, "%s_REV", temp.name.c_str());
+	temp.name = revName;
 	ProblemSpace.synrxnsR.addReaction(temp);
 	ProblemSpace.synrxnsR.changeReversibility(temp.id, temp.init_reversible * -1);
       }
@@ -492,10 +504,11 @@ NO LIKELIHOODS (-5): no_likely [suggested: some negative number, probably -1 or
 
 Everything else: just leave it the way it is
 
-Suggested sample: adjustLikelihoods(rxnList, 1.0f, -2.0f, 1.1f, -2.0f, true) */
+Suggested sample: adjustLikelihoods(rxnspace, 1.0f, -2.0f, 1.1f, -2.0f, true) */
 
-void adjustLikelihoods(vector<REACTION> &rxnList, double spont_likely, double black_magic_likely,
+void adjustLikelihoods(RXNSPACE &rxnspace, double spont_likely, double black_magic_likely,
                        double hard_include_likely, double no_likely, bool adjustNonspecial) {
+  vector<REACTION> &rxnList = rxnspace.rxns;
   unsigned int i;
   for(i=0;i<rxnList.size();i++) {
     if(rxnList[i].init_likelihood < -4.1) {
@@ -520,9 +533,10 @@ void adjustLikelihoods(vector<REACTION> &rxnList, double spont_likely, double bl
       }
     }
   }
+  rxnspace.syncAttributes();
 }
 
-/* Same as below, but with stoich instead of stoich_part */
+/* Same as below, but with all of stoich (including secondaries) */
 void calcMetRxnRelations(const RXNSPACE &rxnspace, METSPACE &metspace) {
 
   unsigned int rxnSize = rxnspace.rxns.size();
@@ -547,7 +561,7 @@ void calcMetRxnRelations(const RXNSPACE &rxnspace, METSPACE &metspace) {
 
 }
 
-/* Same as above, but using stoich_part instead of stoich [so that reactions in which a metabolite is
+/* Same as above, but skipping the STOICHs flagged secondary [so that reactions in which a metabolite is
    a secondary_lone or secondary_pair are excluded] */
 void calcMetRxnRelations_nosec(const RXNSPACE &rxnspace, METSPACE &metspace) {
 
@@ -562,8 +576,9 @@ void calcMetRxnRelations_nosec(const RXNSPACE &rxnspace, METSPACE &metspace) {
 
   for(int i=0;i<rxnSize;i++) {
     const REACTION& currentRxn = rxnspace.rxns[i];
-    for(int j=0;j<currentRxn.stoich_part.size();j++) {
-      int metIdx = metspace.idxFromId(currentRxn.stoich_part[j].met_id);
+    for(int j=0;j<currentRxn.stoich.size();j++) {
+      if(currentRxn.stoich[j].secondary) { continue; }
+      int metIdx = metspace.idxFromId(currentRxn.stoich[j].met_id);
       metspace.mets[metIdx].rxnsInvolved_nosec.push_back(currentRxn.id);
     }
   }
@@ -71,7 +71,7 @@ REACTION MakeBiomassFromGrowth(const GROWTH &growth);
 
 REACTION GrowthExit(const vector<REACTION> &reaction, int met_id, int reversible, 
 		    double fluxBound, const char* name);
-void adjustLikelihoods(vector<REACTION> &rxnList, double spont_likely, double black_magic_likely, double hard_include_likely, double no_likely, bool adjustNonspecial);
+void adjustLikelihoods(RXNSPACE &rxnspace, double spont_likely, double black_magic_likely, double hard_include_likely, double no_likely, bool adjustNonspecial);
 void calcMetRxnRelations(const RXNSPACE &rxnspace, METSPACE &mets);
 void calcMetRxnRelations_nosec(const RXNSPACE &rxns, METSPACE &mets);
 
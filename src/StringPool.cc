@@ -0,0 +1,135 @@
+#include "StringPool.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+using std::map;
+
+/* Handles index into fixed-size chunks of pointers, and the characters themselves live in
+   large blocks. Neither ever moves once written, so internedString() can be called without
+   locking while another thread is interning new strings. */
+static const unsigned int POOLCHUNK = 4096;
+static const unsigned int POOLMAXCHUNKS = 4096;
+static const unsigned int POOLBLOCK = 65536;
+
+struct CSTRLESS{
+  bool operator()(const char *a, const char *b) const { return strcmp(a, b) < 0; }
+};
+
+static const char **poolChunks[POOLMAXCHUNKS];
+static unsigned int poolSize = 1; /* Slot 0 is the empty string */
+static char *poolBlock = NULL;
+static unsigned int poolBlockUsed = POOLBLOCK;
+static map<const char*, STRINGID, CSTRLESS> poolLookup;
+
+/* Copy str into the character blocks. Must be called inside the stringpool critical section */
+static const char* poolStore(const char *str) {
+  unsigned int len = strlen(str) + 1;
+  if(len > POOLBLOCK / 4) {
+    char *own = new char[len];
+    memcpy(own, str, len);
+    return own;
+  }
+  if(poolBlockUsed + len > POOLBLOCK) {
+    poolBlock = new char[POOLBLOCK];
+    poolBlockUsed = 0;
+  }
+  char *copy = poolBlock + poolBlockUsed;
+  memcpy(copy, str, len);
+  poolBlockUsed += len;
+  return copy;
+}
+
+STRINGID internString(const char *str) {
+  if(str == NULL || str[0] == '\0') { return 0; }
+  STRINGID id = 0;
+#pragma omp critical(stringpool)
+  {
+    map<const char*, STRINGID, CSTRLESS>::iterator it = poolLookup.find(str);
+    if(it != poolLookup.end()) {
+      id = it->second;
+    } else {
+      if(poolSize >= POOLCHUNK * POOLMAXCHUNKS) {
+	printf("ERROR: String pool is full (%d strings)\n", poolSize);
+	assert(false);
+      }
+      if(poolChunks[poolSize / POOLCHUNK] == NULL) {
+	poolChunks[poolSize / POOLCHUNK] = new const char*[POOLCHUNK];
+      }
+      const char *copy = poolStore(str);
+      poolChunks[poolSize / POOLCHUNK][poolSize % POOLCHUNK] = copy;
+      poolLookup[copy] = poolSize;
+      id = poolSize;
+      poolSize++;
+    }
+  }
+  return id;
+}
+
+const char* internedString(STRINGID id) {
+  if(id == 0) { return ""; }
+  return poolChunks[id / POOLCHUNK][id % POOLCHUNK];
+}
+
+STRINGID findInternedString(const char *str) {
+  if(str == NULL || str[0] == '\0') { return 0; }
+  STRINGID id = 0;
+#pragma omp critical(stringpool)
+  {
+    map<const char*, STRINGID, CSTRLESS>::iterator it = poolLookup.find(str);
+    if(it != poolLookup.end()) { id = it->second; }
+  }
+  return id;
+}
+
+int stringPoolSize() {
+  return poolSize - 1;
+}
+
+NAMEREF::NAMEREF() {
+  handle = 0;
+}
+
+NAMEREF::NAMEREF(const char *str) {
+  handle = internString(str);
+}
+
+NAMEREF::NAMEREF(const NAMEREF &other) {
+  handle = other.handle;
+}
+
+NAMEREF& NAMEREF::operator=(const NAMEREF &rhs) {
+  handle = rhs.handle;
+  return *this;
+}
+
+NAMEREF& NAMEREF::operator=(const char *str) {
+  handle = internString(str);
+  return *this;
+}
+
+const char* NAMEREF::c_str() const {
+  return internedString(handle);
+}
+
+NAMEREF::operator const char*() const {
+  return internedString(handle);
+}
+
+STRINGID NAMEREF::id() const {
+  return handle;
+}
+
+bool NAMEREF::empty() const {
+  return handle == 0;
+}
+
+bool NAMEREF::operator==(const NAMEREF &rhs) const {
+  return handle == rhs.handle;
+}
+
+bool NAMEREF::operator!=(const NAMEREF &rhs) const {
+  return handle != rhs.handle;
+}
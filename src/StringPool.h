@@ -0,0 +1,42 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+/* StringPool.h - process-wide pool of interned strings (reaction / metabolite names,
+   chemical formulas and gene names).
+
+   Every distinct string is stored once and referred to by a 32-bit handle, so copying a
+   REACTION or METABOLITE copies a few ints instead of 64-byte character arrays. Strings are
+   never freed, so a const char* obtained from the pool stays valid for the life of the program. */
+
+typedef unsigned int STRINGID;
+
+/* Handle 0 is always the empty string */
+STRINGID internString(const char *str);
+const char* internedString(STRINGID id);
+/* Returns the handle for str if it has been interned already and 0 otherwise (does not add it) */
+STRINGID findInternedString(const char *str);
+int stringPoolSize();
+
+/* Name stored as a handle into the string pool. It converts to const char* where one is
+   needed (strcmp, strcpy source, etc.) - but NOT through "..." so use c_str() for printf */
+class NAMEREF{
+ public:
+  NAMEREF();
+  NAMEREF(const char *str);
+  NAMEREF(const NAMEREF &other);
+  NAMEREF& operator=(const NAMEREF &rhs);
+  NAMEREF& operator=(const char *str);
+
+  const char* c_str() const;
+  operator const char*() const;
+  STRINGID id() const;
+  bool empty() const;
+
+  /* Interned strings are equal if and only if their handles are */
+  bool operator==(const NAMEREF &rhs) const;
+  bool operator!=(const NAMEREF &rhs) const;
+ private:
+  STRINGID handle;
+};
+
+#endif
@@ -40,25 +40,19 @@ PROBLEM readReactionTable(const char* filename) {
     rxn_coeff = atof(rxnCoeffStr);
 
     STOICH curStoich;
-    sprintf(curStoich.met_name, "%s", metName);
     curStoich.met_id = metId;
     curStoich.rxn_coeff = rxn_coeff;
+    curStoich.secondary = (secondary != 0);
 
     if(fullrxn.idIn(rxnId)) {
       fullrxn.rxnPtrFromId(rxnId)->stoich.push_back(curStoich);
-      if(!secondary) {
-	fullrxn.rxnPtrFromId(rxnId)->stoich_part.push_back(curStoich);
-      }
     } else {
       REACTION newrxn;
       newrxn.id = rxnId;
       newrxn.init_reversible = net_reversible;
       newrxn.net_reversible = net_reversible;
-      sprintf(newrxn.name, "%s", rxnName);      
+      newrxn.name = rxnName;
       newrxn.stoich.push_back(curStoich);
-      if(!secondary) {
-	newrxn.stoich_part.push_back(curStoich);
-      }
       fullrxn.addReaction(newrxn);
       /* Set lb and ub appropriately according to the chosen reversibility... */
       fullrxn.changeReversibility(rxnId, net_reversible);
@@ -67,7 +61,7 @@ PROBLEM readReactionTable(const char* filename) {
       /* Note - because we're curating now, the secondary and secondary_pair fields became useless */
       METABOLITE newmet;
       newmet.id = metId;
-      sprintf(newmet.name, "%s", metName);
+      newmet.name = metName;
       fullmets.addMetabolite(newmet);
     }
     /* This is needed to ensure that anything that is treated as a secondary potentially gets a magic entrance. */
@@ -76,6 +70,9 @@ PROBLEM readReactionTable(const char* filename) {
     }
   }
 
+  /* Stoichs were appended to reactions already in the RXNSPACE, so the exchange / transporter lookups need rebuilding */
+  if(!fullrxn.rxns.empty()) { fullrxn.rxnMap(); }
+
   printf("Number of fullrxns: %d\n Number of Metabolites: %d\n", (int)result.fullrxns.rxns.size(), (int)result.metabolites.mets.size());
   fclose(fid);
 
@@ -112,8 +109,10 @@ void readLikelihoodTable(PROBLEM &ProblemSpace, const char* filename) {
 
 /* Find a reaction by name and return the ID (-1 if none is found) */
 int rxnByName(const RXNSPACE &rxnspace, const char* name) {
+  STRINGID nameId = findInternedString(name);
+  if(nameId == 0) { return -1; }
   for(int i=0; i<rxnspace.rxns.size(); i++) {
-    if(strcmp(rxnspace.rxns[i].name, name) == 0) {
+    if(rxnspace.rxns[i].name.id() == nameId) {
       return rxnspace.rxns[i].id;
     }
   }
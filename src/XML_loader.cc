@@ -41,11 +41,7 @@ void parseALL(char* file1, char* file2, PROBLEM &ProblemSpace){
   parseDoc(file1, fullrxns, metspace);
   parseData(file2, growth);
 
-  /* Mostly for reference, copy metabolite names over to the STOICHs from the METABOLITEs */
-  addMetNameToStoichs(ProblemSpace.fullrxns.rxns, ProblemSpace.metabolites);
-  addMetNameToStoichs(ProblemSpace.growth, ProblemSpace.metabolites);
-
-  /* Now that the names are added... lets check and make sure we're not putting in insane inputs 
+  /* Check and make sure we're not putting in insane inputs 
    and make sure that we actually have all the required special metabolites from DEBUGFLAGS in our metabolite list */
   checkConsistency(ProblemSpace);
 
@@ -89,13 +85,13 @@ void parseMETABOLITE (xmlDocPtr doc, xmlNodePtr cur, METSPACE &metspace) {
     if ((!xmlStrcmp(cur->name, (const xmlChar *)"name"))) {
       key = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
       /* printf("name: %s\n", key); */
-      strcpy(tempm.name,(char*)key);
+      tempm.name = (char*)key;
       xmlFree(key);
     }
     if ((!xmlStrcmp(cur->name, (const xmlChar *)"chemform"))) {
       key = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
       /* printf("chemform: %s\n", key); */
-      strcpy(tempm.chemform,(char*)key);
+      tempm.chemform = (char*)key;
       xmlFree(key);
     }
     if ((!xmlStrcmp(cur->name, (const xmlChar *)"secondary"))) {
@@ -186,7 +182,7 @@ void parseREACTION (xmlDocPtr doc, xmlNodePtr cur, RXNSPACE &rxnspace) {
     if ((!xmlStrcmp(cur->name, (const xmlChar *)"name"))) {
       key = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
       /* printf("name: %s\n", key); */ 
-      strcpy(tempr.name,(char*)key);
+      tempr.name = (char*)key;
       xmlFree(key);
     }
     if ((!xmlStrcmp(cur->name, (const xmlChar *)"s"))) {
@@ -429,11 +425,12 @@ void identifyFreeReactions(vector<REACTION> &reactions) {
     bool hasReactant = false;
     bool hasProduct = false;
 
-    for(int j=0; j<reactions[i].stoich_part.size(); j++) {
-      if(reactions[i].stoich_part[j].rxn_coeff < 0) { 
+    for(int j=0; j<reactions[i].stoich.size(); j++) {
+      if(reactions[i].stoich[j].secondary) { continue; }
+      if(reactions[i].stoich[j].rxn_coeff < 0) { 
 	hasReactant = true;
       }
-      if(reactions[i].stoich_part[j].rxn_coeff > 0) {
+      if(reactions[i].stoich[j].rxn_coeff > 0) {
 	hasProduct = true;
       }
     }
@@ -463,7 +460,7 @@ void identifyFreeReactions(vector<REACTION> &reactions) {
   }
 }
 
-/* Load stoich_part as stoichiometry without secondary metabolites 
+/* Flag the secondary metabolites in each reaction's stoich (STOICH::secondary) - Dijkstras skips over them
 ID of all secondaries now occurs internally in this function
 
 1-16-12 - TEST of the "synthesis reaction" concept
@@ -507,29 +504,27 @@ void Load_Stoic_Part(vector<REACTION> &reaction,
     }
 
     for(int j=0;j<reaction[i].stoich.size();j++) {
-      STOICH tempPart;
+      STOICH &curStoich = reaction[i].stoich[j];
+      curStoich.secondary = true;
 
-      /* Test for double secondary and don't copy if it's part of a secondary pair in that reaction */
-      if( secondaryPairPresent(secondaryPair_ID1, secondaryPair_ID2, reaction[i], reaction[i].stoich[j].met_id, metId2StoichIdx) ) { 
+      /* Test for double secondary and flag it if it's part of a secondary pair in that reaction */
+      if( secondaryPairPresent(secondaryPair_ID1, secondaryPair_ID2, reaction[i], curStoich.met_id, metId2StoichIdx) ) { 
 	continue; 
       }
 
-      /* Single secondary - don't copy (do this second to allow for cases with both single and double secondaries) */
-      vector<int>::iterator iter = find(singleSecondary_ID.begin(), singleSecondary_ID.end(), reaction[i].stoich[j].met_id);
+      /* Single secondary - flag it (do this second to allow for cases with both single and double secondaries) */
+      vector<int>::iterator iter = find(singleSecondary_ID.begin(), singleSecondary_ID.end(), curStoich.met_id);
       if(iter != singleSecondary_ID.end()) {
-	/* NEW 1-17-2012 - skip over it if it is considered a synthesis reaction for that metabolite */
+	/* NEW 1-17-2012 - don't flag it if it is considered a synthesis reaction for that metabolite */
 	if(_db.TEST_SYNTHESIS) {
-	  if(reaction[i].synthesis != reaction[i].stoich[j].met_id) { continue; }
+	  if(reaction[i].synthesis != curStoich.met_id) { continue; }
 	} else {
 	  continue; 
 	}
       };
       
-      /* Otherwise just copy it */
-      tempPart.met_id = reaction[i].stoich[j].met_id;
-      tempPart.rxn_coeff = reaction[i].stoich[j].rxn_coeff;
-      sprintf(tempPart.met_name, "%s", reaction[i].stoich[j].met_name);
-      reaction[i].stoich_part.push_back(tempPart);
+      /* Otherwise it is a primary metabolite */
+      curStoich.secondary = false;
     }
   }
 }
@@ -568,34 +563,6 @@ bool secondaryPairPresent(const vector<int> &secondaryList1, const vector<int> &
   return false;
 }
 
-/* Add metabolite names to the stoich structure */
-void addMetNameToStoichs(vector<REACTION> &reaction, METSPACE &metspace) {
-
-  for(int i=0;i<reaction.size();i++) {
-    REACTION tmpRxn = reaction[i];
-    /* Update stoich */
-    for(int j=0;j<tmpRxn.stoich.size();j++) {
-      sprintf(reaction[i].stoich[j].met_name, "%s",  metspace.metFromId(tmpRxn.stoich[j].met_id).name);
-    }
-    /* Update stoich_part */
-    for(int j=0;j<tmpRxn.stoich_part.size();j++) {
-      sprintf(reaction[i].stoich_part[j].met_name, "%s", metspace.metFromId(tmpRxn.stoich_part[j].met_id).name);
-    }
-  }
-  return;
-}
-
-/* Add metabolite names to the stoich structure */
-void addMetNameToStoichs(vector<GROWTH> &growth, METSPACE &metspace) {
-
-  for(int j=0;j<growth.size();j++){
-    for(int i=0;i<growth[j].biomass.size();i++) {
-      sprintf(growth[j].biomass[i].met_name,"%s", metspace.metFromId(growth[j].biomass[i].met_id).name);
-    }
-  }
-  return;
-}
-
 /* Fill the inputIds and outputIds vectors with the input and biomass (output) IDs declared in growth[growthIdx]
 Also puts whether the metabolite is an input/output or not into the appropriate places in "metabolite".
 The latter must be done for visualization only.
@@ -656,8 +623,10 @@ void makeMagicBridges(PROBLEM &ProblemSpace) {
 
       /* Add a reaction from A to B (irreversible)  */
       tmp_rxn.id = ctr + flag;
-      sprintf(tmp_rxn.name, "MAGICBRIDGE_%s_%s",  metabolite[i].name, 
-	      metabolite[metId2Idx[metabolite[i].secondary_pair[j]]].name);
+      char bridgeName[160];
+      sprintf(bridgeName, "MAGICBRIDGE_%s_%s",  metabolite[i].name.c_str(), 
+	      metabolite[metId2Idx[metabolite[i].secondary_pair[j]]].name.c_str());
+      tmp_rxn.name = bridgeName;
       tmp_rxn.init_reversible = 0; /* Reversible */
       tmp_rxn.net_reversible = tmp_rxn.init_reversible; 
       tmp_rxn.init_likelihood = 1.0f; /* Likely (net_likelihood will be gotten later) */
@@ -666,18 +635,15 @@ void makeMagicBridges(PROBLEM &ProblemSpace) {
       /* A */
       tmp_stoich.met_id = metabolite[i].id;
       tmp_stoich.rxn_coeff = -1;
-      sprintf(tmp_stoich.met_name, "%s", metabolite[i].name);
       tmp_stoich_vec.push_back(tmp_stoich);
       /* B */
       tmp_stoich.reset();
       tmp_stoich.rxn_coeff = 1;
       tmp_stoich.met_id = metabolite[i].secondary_pair[j];
-      sprintf(tmp_stoich.met_name, "%s", ProblemSpace.metabolites.metFromId(metabolite[i].secondary_pair[j]).name);
       tmp_stoich_vec.push_back(tmp_stoich);
       
+      /* Nothing is flagged secondary - allows it to actually be used in Dijkstras */
       tmp_rxn.stoich = tmp_stoich_vec;
-      // Allows it to actually be used in Dijkstras
-      tmp_rxn.stoich_part = tmp_stoich_vec;
       
       reaction.push_back(tmp_rxn);
       ctr++;
@@ -762,8 +728,7 @@ void setUpMaintenanceReactions(PROBLEM &ProblemSpace) {
     if(!requiredPresent[j]) { 
       STOICH tmpStoich;
       METABOLITE tmpMet = ProblemSpace.metabolites.metFromId(mustIds[j]);
-      printf("WARNING: Biomass seems to be missing a metabolite %s that is required for NGAM calculations - adding to the biomass equation\n", tmpMet.name);
-      sprintf(tmpStoich.met_name, "%s", tmpMet.name);
+      printf("WARNING: Biomass seems to be missing a metabolite %s that is required for NGAM calculations - adding to the biomass equation\n", tmpMet.name.c_str());
       tmpStoich.met_id = tmpMet.id;
       tmpStoich.rxn_coeff = 0.0f;
     }
@@ -792,12 +757,7 @@ void checkConsistency(const PROBLEM &ProblemSpace) {
       int growthId = growth[i].biomass[j].met_id;
       if(!metspace.idIn(growthId)) {
 	printf("ERROR: The provided InputData and Database XML files have inconsistent IDs, this program will now terminate\n");
-	printf("Inconsistent name: %s in the biomass had no corresponding ID in the metabolite file \n", growth[i].biomass[j].met_name);
-	assert(false);
-      }
-      if( strcmp( metspace.metFromId(growthId).name , growth[i].biomass[j].met_name ) != 0 ) {
-	printf("ERROR: The provided InputData and Database XML files have inconsistent IDs, this program will now terminate\n");
-	printf("Inconsistent name: %s in the biomass did not correspond with %s in the metabolite file despite both having the same ID \n", growth[i].biomass[j].met_name, metspace.metFromId(growthId).name);
+	printf("Inconsistent ID: %d in the biomass had no corresponding ID in the metabolite file \n", growthId);
 	assert(false);
       }
     }
@@ -812,7 +772,7 @@ void checkConsistency(const PROBLEM &ProblemSpace) {
       }
       if( strcmp( metspace.metFromId(growthId).name , growth[i].byproduct[j].name ) != 0 ) {
 	printf("ERROR: The provided InputData and Database XML files have inconsistent IDs, this program will now terminate\n");
-	printf("Inconsistent name: %s in the byproducts did not correspond with %s in the metabolite file despite both having the same ID \n", growth[i].byproduct[j].name, metspace.metFromId(growthId).name);
+	printf("Inconsistent name: %s in the byproducts did not correspond with %s in the metabolite file despite both having the same ID \n", growth[i].byproduct[j].name, metspace.metFromId(growthId).name.c_str());
 	assert(false);
       }
     }
@@ -827,7 +787,7 @@ void checkConsistency(const PROBLEM &ProblemSpace) {
       }
       if( strcmp( metspace.metFromId(growthId).name , growth[i].media[j].name ) != 0 ) {
         printf("ERROR: The provided InputData and Database XML files have inconsistent IDs, this program will now terminate\n");
-        printf("Inconsistent name: %s in the media did not correspond with %s in the metabolite file despite both having the same ID \n", growth[i].media[j].name, metspace.metFromId(growthId).name);
+        printf("Inconsistent name: %s in the media did not correspond with %s in the metabolite file despite both having the same ID \n", growth[i].media[j].name, metspace.metFromId(growthId).name.c_str());
         assert(false);
       }
     }
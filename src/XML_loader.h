@@ -12,8 +12,6 @@ void parseALL(char* file1, char* file2, PROBLEM &ProblemSpace);
 void parseData(char *docname, vector<GROWTH> &growth);
 void setUpMaintenanceReactions(PROBLEM &ProblemSpace);
 void Load_Stoic_Part(vector<REACTION> &reaction, const vector<METABOLITE> &metabolite);
-void addMetNameToStoichs(vector<REACTION> &reaction, METSPACE &metspace);
-void addMetNameToStoichs(vector<GROWTH> &growth, METSPACE &metspace);
 void loadInputsOutputs(vector<GROWTH> &growth, int growthIdx, METSPACE &metspace, vector<int> &inputIds, vector<int> &outputIds);
 void makeMagicBridges(PROBLEM &ProblemSpace);
 void identifyFreeReactions(vector<REACTION> &reactions);
@@ -3,7 +3,10 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <glpk.h>
+#include <list>
+#include <map>
 #include <vector>
 
 #include "DataStructures.h"
@@ -16,16 +19,172 @@
 #include "RunK.h"
 #include "Grow.h"
 
+using std::list;
+
 /* Useful plug-in functions */
+
+LPBACKEND::~LPBACKEND() {
+}
+
+/* Only GLPK for now - another solver goes in here along with the rule for which models it gets */
+LPBACKEND* newLpBackend(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &objId, const vector<double> &objCoeff, int sense) {
+  return new GLPKDATA(rxnspace, metspace, objId, objCoeff, sense);
+}
+
+/* Everything FBA_SOLVE's answer depends on, flattened: the reactions in order (ID, number of stoichiometry entries and
+   their metabolite IDs; bounds and coefficients), then the objective and its sense. -0 is stored as 0 */
+struct FBACACHEKEY {
+  vector<int> ints;
+  vector<double> reals;
+  bool operator==(const FBACACHEKEY &rhs) const { return ints == rhs.ints && reals == rhs.reals; }
+};
+
+static double keyValue(double value) {
+  return (value == 0.0f) ? 0.0f : value;
+}
+
+static void modelKey(const RXNSPACE &rxnspace, const vector<int> &objId, const vector<double> &objCoeff, int sense, FBACACHEKEY &key) {
+  key.ints.clear();  key.reals.clear();
+  key.ints.push_back(rxnspace.rxns.size());
+  for(int i=0; i<rxnspace.rxns.size(); i++) {
+    const REACTION &rxn = rxnspace.rxns[i];
+    key.ints.push_back(rxn.id);
+    key.ints.push_back(rxn.stoich.size());
+    key.reals.push_back(keyValue(rxn.lb));
+    key.reals.push_back(keyValue(rxn.ub));
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      key.ints.push_back(rxn.stoich[j].met_id);
+      key.reals.push_back(keyValue(rxn.stoich[j].rxn_coeff));
+    }
+  }
+  key.ints.push_back(objId.size());
+  for(int i=0; i<objId.size(); i++) {
+    key.ints.push_back(objId[i]);
+    key.reals.push_back(keyValue(objCoeff[i]));
+  }
+  key.ints.push_back(sense);
+}
+
+/* FNV-1a over the bytes of the key - only picks the bucket, FBA_SOLVE compares the whole key before using an entry */
+static const unsigned long long FINGERPRINT_SEED = 14695981039346656037ULL;
+static const unsigned long long FINGERPRINT_PRIME = 1099511628211ULL;
+
+static void fingerprintBytes(unsigned long long &hash, const void *data, int size) {
+  const unsigned char *bytes = (const unsigned char*)data;
+  for(int i=0; i<size; i++) {
+    hash ^= bytes[i];
+    hash *= FINGERPRINT_PRIME;
+  }
+}
+
+static unsigned long long keyFingerprint(const FBACACHEKEY &key) {
+  unsigned long long hash = FINGERPRINT_SEED;
+  if(!key.ints.empty()) { fingerprintBytes(hash, &key.ints[0], key.ints.size()*sizeof(int)); }
+  if(!key.reals.empty()) { fingerprintBytes(hash, &key.reals[0], key.reals.size()*sizeof(double)); }
+  return hash;
+}
+
+unsigned long long modelFingerprint(const RXNSPACE &rxnspace, const vector<int> &objId, const vector<double> &objCoeff, int sense) {
+  FBACACHEKEY key;
+  modelKey(rxnspace, objId, objCoeff, sense, key);
+  return keyFingerprint(key);
+}
+
+/* The FBA_SOLVE cache: most recently used at the front of fbaCacheOrder, found by fingerprint through fbaCacheIndex. Each
+   entry keeps its full key, so two models with the same fingerprint never share an answer (the newer one replaces the
+   older). It is shared by all threads - only touch it inside critical(fbacache) */
+struct FBACACHEENTRY {
+  unsigned long long fingerprint;
+  FBACACHEKEY key;
+  vector<double> flux;
+};
+static list<FBACACHEENTRY> fbaCacheOrder;
+static map<unsigned long long, list<FBACACHEENTRY>::iterator> fbaCacheIndex;
+static int fbaCacheHits = 0;
+static int fbaCacheMisses = 0;
+
+/* Answers come from the cache when the same model (reactions, bounds and objective - see modelKey) was solved
+   recently, without setting up an LP at all */
+vector<double> FBA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &objId, const vector<double> &objCoeff,
+			 int sense) {
+  FBACACHEKEY key;
+  unsigned long long fingerprint = 0;
+  bool found = false;
+  vector<double> result;
+  if(_db.FBA_CACHE_SIZE > 0) {
+    modelKey(rxnspace, objId, objCoeff, sense, key);
+    fingerprint = keyFingerprint(key);
+#pragma omp critical(fbacache)
+    {
+      map<unsigned long long, list<FBACACHEENTRY>::iterator>::iterator it = fbaCacheIndex.find(fingerprint);
+      if(it != fbaCacheIndex.end() && it->second->key == key) {
+	fbaCacheOrder.splice(fbaCacheOrder.begin(), fbaCacheOrder, it->second);
+	result = it->second->flux;
+	found = true;
+	fbaCacheHits++;
+      } else {
+	fbaCacheMisses++;
+      }
+    }
+    if(found) { return result; }
+  }
+
+  LPBACKEND *prob = newLpBackend(rxnspace, metspace, objId, objCoeff, sense);
+  result = prob->FBA_SOLVE();
+  delete prob;
+
+  if(_db.FBA_CACHE_SIZE > 0) {
+#pragma omp critical(fbacache)
+    {
+      map<unsigned long long, list<FBACACHEENTRY>::iterator>::iterator it = fbaCacheIndex.find(fingerprint);
+      /* Another thread may have solved the same model in the meantime - a different model with the same fingerprint
+	 makes way for this one */
+      if(it == fbaCacheIndex.end() || !(it->second->key == key)) {
+	if(it != fbaCacheIndex.end()) {
+	  fbaCacheOrder.erase(it->second);
+	  fbaCacheIndex.erase(it);
+	}
+	fbaCacheOrder.push_front(FBACACHEENTRY());
+	FBACACHEENTRY &entry = fbaCacheOrder.front();
+	entry.fingerprint = fingerprint;
+	entry.key.ints.swap(key.ints);
+	entry.key.reals.swap(key.reals);
+	entry.flux = result;
+	fbaCacheIndex[fingerprint] = fbaCacheOrder.begin();
+	while((int)fbaCacheIndex.size() > _db.FBA_CACHE_SIZE) {
+	  fbaCacheIndex.erase(fbaCacheOrder.back().fingerprint);
+	  fbaCacheOrder.pop_back();
+	}
+      }
+    }
+  }
+  return result;
+}
+
+void fbaCacheStats(int &hits, int &misses) {
+#pragma omp critical(fbacache)
+  {
+    hits = fbaCacheHits;
+    misses = fbaCacheMisses;
+  }
+}
+
+void clearFbaCache() {
+#pragma omp critical(fbacache)
+  {
+    fbaCacheOrder.clear();
+    fbaCacheIndex.clear();
+    fbaCacheHits = 0;
+    fbaCacheMisses = 0;
+  }
+}
+
 /* For backwards compatibility - assumes that you want db.BIOMASS as the objective
  with a coefficient of 1 and a sense of 1 (MAX) */
 vector<double> FBA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace) {
   vector<int> obj(1, _db.BIOMASS);
   vector<double> coeff(1, 1.0f);
-  GLPKDATA prob(rxnspace, metspace, obj, coeff, 1);
-  vector<double> result = prob.FBA_SOLVE();
-
-  return result;
+  return FBA_SOLVE(rxnspace, metspace, obj, coeff, 1);
 }
 
 vector<double> FBA_SOLVE(const vector<REACTION> &rxnList, const METSPACE &metspace) {
@@ -37,19 +196,292 @@ vector<double> FBA_SOLVE(const vector<REACTION> &rxnList, const METSPACE &metspa
 /* Assumes you want db.BIOMASS as the objective to compare against when running FVA, and a coefficient of 1 for that objective */
 void FVA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, double optPct, vector<double> &minflux, 
 	       vector<double> &maxflux) {
+  vector<int> rxnIds;
+  for(int i=0; i<rxnspace.rxns.size(); i++) { rxnIds.push_back(rxnspace.rxns[i].id); }
+  FVA_SOLVE(rxnspace, metspace, optPct, rxnIds, minflux, maxflux);
+}
+
+void FVA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, double optPct, const vector<int> &rxnIds,
+	       vector<double> &minflux, vector<double> &maxflux) {
   minflux.clear(); maxflux.clear();
   vector<int> obj(1, _db.BIOMASS);
   vector<double> coeff(1, 1.0f);
-  GLPKDATA prob(rxnspace, metspace, obj, coeff, 1);
-  prob.FVA_SOLVE(minflux, maxflux, optPct);
-  return;
+  LPBACKEND *prob = newLpBackend(rxnspace, metspace, obj, coeff, 1);
+  prob->FVA_SOLVE(minflux, maxflux, optPct, rxnIds);
+  delete prob;
+}
+
+/* One column of the model while compressModel works on it */
+struct COMPRESSCOL{
+  int rep; /* Index (in the original rxnspace) of the reaction whose ID the column keeps */
+  map<int, double> stoich; /* Metabolite ID --> coefficient */
+  double lb;  double ub;
+  bool alive;
+  bool kept;
+  vector<int> members; /* Indexes of the original reactions lumped into this column */
+};
+
+/* Alive columns with a (nonzero) coefficient for metabolite metId */
+static vector<int> liveColumnsOf(const vector<COMPRESSCOL> &cols, const vector<int> &touching, int metId) {
+  vector<int> live;
+  for(int i=0; i<touching.size(); i++) {
+    const COMPRESSCOL &col = cols[touching[i]];
+    if(col.alive && col.stoich.find(metId) != col.stoich.end()) { live.push_back(touching[i]); }
+  }
+  custom_unique(live);
+  return live;
+}
+
+/* Compress a model once so that the LPs solved on it are smaller, repeating until nothing changes:
+   - Reactions with both bounds at zero are blocked (taken out)
+   - Dead-end metabolites (one reaction left, or nothing that can make it or nothing that can use it) are taken out along
+     with every reaction that touches them - at steady state those can't carry flux whatever their bounds
+   - A metabolite with exactly two reactions left forces the flux of one to be a fixed multiple of the other, so the two
+     are lumped into one column (the metabolite cancels out and the bounds are intersected)
+
+   Reactions in keepIds are never lumped and are treated as if they could go either way, so batchSolve can change their
+   bounds to anything. The objective and anything whose bounds are overridden (other than closing it) must be in keepIds.
+   compressed.expansion maps flux on the compressed model back to every reaction in rxnspace - GLPKDATA built from
+   "compressed" takes care of that itself. */
+void compressModel(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &keepIds, COMPRESSEDMODEL &compressed) {
+  const double tol = _db.FLUX_CUTOFF;
+  int numRxns = rxnspace.rxns.size();
+
+  vector<COMPRESSCOL> cols(numRxns);
+  vector<double> factor(numRxns, 1.0f);
+  map<int, vector<int> > metCols; /* Metabolite ID --> columns that touch (or once touched) it */
+  for(int i=0; i<numRxns; i++) {
+    const REACTION &rxn = rxnspace.rxns[i];
+    COMPRESSCOL &col = cols[i];
+    col.rep = i;
+    col.lb = rxn.lb;  col.ub = rxn.ub;
+    col.alive = true;
+    col.kept = find(keepIds.begin(), keepIds.end(), rxn.id) != keepIds.end();
+    col.members.push_back(i);
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      if(fabs(rxn.stoich[j].rxn_coeff) < 1E-8) { continue; }
+      col.stoich[rxn.stoich[j].met_id] += rxn.stoich[j].rxn_coeff;
+      metCols[rxn.stoich[j].met_id].push_back(i);
+    }
+  }
+
+  int numBlocked = 0, numDeadEnd = 0, numLumped = 0;
+  bool changed = true;
+  while(changed) {
+    changed = false;
+
+    for(int c=0; c<numRxns; c++) {
+      COMPRESSCOL &col = cols[c];
+      if(!col.alive || col.kept) { continue; }
+      if(fabs(col.lb) <= tol && fabs(col.ub) <= tol) { col.alive = false; numBlocked++; changed = true; }
+    }
+
+    for(map<int, vector<int> >::iterator it = metCols.begin(); it != metCols.end(); it++) {
+      vector<int> live = liveColumnsOf(cols, it->second, it->first);
+      if(live.empty()) { continue; }
+      bool canMake = false, canUse = false;
+      for(int i=0; i<live.size(); i++) {
+	const COMPRESSCOL &col = cols[live[i]];
+	double coeff = col.stoich.find(it->first)->second;
+	bool forward = col.kept || col.ub > tol;
+	bool backward = col.kept || col.lb < -tol;
+	if( (coeff > 0 && forward) || (coeff < 0 && backward) ) { canMake = true; }
+	if( (coeff < 0 && forward) || (coeff > 0 && backward) ) { canUse = true; }
+      }
+      if(live.size() > 1 && canMake && canUse) { continue; }
+      for(int i=0; i<live.size(); i++) { cols[live[i]].alive = false; }
+      numDeadEnd++;
+      changed = true;
+    }
+
+    for(map<int, vector<int> >::iterator it = metCols.begin(); it != metCols.end(); it++) {
+      vector<int> live = liveColumnsOf(cols, it->second, it->first);
+      if(live.size() != 2) { continue; }
+      COMPRESSCOL &keep = cols[live[0]];
+      COMPRESSCOL &gone = cols[live[1]];
+      if(keep.kept || gone.kept) { continue; }
+
+      /* flux(gone) = f * flux(keep) */
+      double f = -keep.stoich[it->first] / gone.stoich[it->first];
+      double goneLb = (f > 0) ? gone.lb / f : gone.ub / f;
+      double goneUb = (f > 0) ? gone.ub / f : gone.lb / f;
+      double newLb = std::max(keep.lb, goneLb);
+      double newUb = std::min(keep.ub, goneUb);
+      /* No flux satisfies both - leave it for the LP to find out */
+      if(newLb > newUb + tol) { continue; }
+
+      for(map<int, double>::iterator st = gone.stoich.begin(); st != gone.stoich.end(); st++) {
+	if(keep.stoich.find(st->first) == keep.stoich.end()) { metCols[st->first].push_back(live[0]); }
+	keep.stoich[st->first] += f * st->second;
+      }
+      for(map<int, double>::iterator st = keep.stoich.begin(); st != keep.stoich.end(); ) {
+	if(fabs(st->second) < 1E-8) { keep.stoich.erase(st++); }
+	else { st++; }
+      }
+      keep.lb = newLb;  keep.ub = std::max(newLb, newUb);
+      for(int i=0; i<gone.members.size(); i++) {
+	factor[gone.members[i]] *= f;
+	keep.members.push_back(gone.members[i]);
+      }
+      gone.members.clear();
+      gone.alive = false;
+      numLumped++;
+      changed = true;
+    }
+  }
+
+  /* Build the compressed model from what is left */
+  compressed.rxnspace = RXNSPACE();
+  FLUXEXPANSION &expansion = compressed.expansion;
+  expansion = FLUXEXPANSION();
+  expansion.originalIds.resize(numRxns);
+  expansion.column.assign(numRxns, -1);
+  expansion.factor = factor;
+  vector<int> metIds;
+  for(int c=0; c<numRxns; c++) {
+    const COMPRESSCOL &col = cols[c];
+    if(!col.alive) { continue; }
+    REACTION rxn = rxnspace.rxns[col.rep];
+    rxn.stoich.clear();
+    for(map<int, double>::const_iterator st = col.stoich.begin(); st != col.stoich.end(); st++) {
+      STOICH entry;
+      entry.met_id = st->first;
+      entry.rxn_coeff = st->second;
+      rxn.stoich.push_back(entry);
+      metIds.push_back(st->first);
+    }
+    rxn.lb = col.lb;  rxn.ub = col.ub;
+    if(rxn.lb < -tol && rxn.ub > tol) { rxn.net_reversible = 0; }
+    else if(rxn.lb < -tol) { rxn.net_reversible = -1; }
+    else { rxn.net_reversible = 1; }
+    for(int i=0; i<col.members.size(); i++) { expansion.column[col.members[i]] = compressed.rxnspace.rxns.size(); }
+    expansion.columnSize.push_back(col.members.size());
+    compressed.rxnspace.addReaction(rxn);
+  }
+  for(int i=0; i<numRxns; i++) {
+    expansion.originalIds[i] = rxnspace.rxns[i].id;
+    expansion.originalIdx[rxnspace.rxns[i].id] = i;
+  }
+  custom_unique(metIds);
+  compressed.metspace = METSPACE(metspace, metIds);
+
+  if(_db.DEBUGFBA) {
+    printf("Compressed %d reactions x %d metabolites to %d x %d (%d blocked, %d dead-end metabolites, %d lumped)\n",
+	   numRxns, (int)metspace.mets.size(), (int)compressed.rxnspace.rxns.size(), (int)compressed.metspace.mets.size(),
+	   numBlocked, numDeadEnd, numLumped);
+  }
+}
+
+/**************** Solver sessions ****************/
+
+/* OpenMP keeps its threads between parallel regions, so a thread finds the same session (and its spare problems) again
+   the next time it solves something */
+static LPSESSION *threadSession = NULL;
+#pragma omp threadprivate(threadSession)
+static int numSessions = 0;
+
+/* Most problems that are handed back get asked for again soon - this many are kept per thread */
+static const int LPSESSION_SPARES = 8;
+
+static int suppressGLPKOutput(void *info, const char *s) {
+  /* GLPK doesn't print if this function returns 1 so that's what I do */
+  return 1;
+}
+
+LPSESSION::LPSESSION() {
+  numCreated = 0;
+  numReused = 0;
+  numOutstanding = 0;
+  /* The terminal hook is part of this thread's GLPK environment, so it only has to be set once */
+  int (*func)(void*, const char *) = &suppressGLPKOutput;
+  if(!_db.DEBUGFBA) { glp_term_hook(func, NULL); }
+}
+
+LPSESSION::~LPSESSION() {
+  for(int i=0; i<spare.size(); i++) { glp_delete_prob(spare[i]); }
+}
+
+glp_prob* LPSESSION::getProblem() {
+  numOutstanding++;
+  if(spare.empty()) {
+    numCreated++;
+    return glp_create_prob();
+  }
+  glp_prob *lp = spare.back();
+  spare.pop_back();
+  numReused++;
+  return lp;
+}
+
+void LPSESSION::returnProblem(glp_prob *lp) {
+  if(lp == NULL) { return; }
+  numOutstanding--;
+  if(spare.size() >= LPSESSION_SPARES) {
+    glp_delete_prob(lp);
+    return;
+  }
+  glp_erase_prob(lp);
+  spare.push_back(lp);
+}
+
+LPSESSION& solverSession() {
+  if(threadSession == NULL) {
+    threadSession = new LPSESSION();
+#pragma omp atomic
+    numSessions++;
+  }
+  return *threadSession;
+}
+
+void closeSolverSession() {
+  if(threadSession == NULL) { return; }
+  /* glp_free_env would free those problems out from under whoever has them */
+  if(threadSession->numOutstanding != 0) {
+    printf("ERROR: closeSolverSession called with %d LP problems still in use on this thread\n", threadSession->numOutstanding);
+    assert(threadSession->numOutstanding == 0);
+  }
+  delete threadSession;
+  threadSession = NULL;
+#pragma omp atomic
+  numSessions--;
+  glp_free_env();
+}
+
+int numSolverSessions() {
+  return numSessions;
 }
 
 /**************** Public Methods ****************/
 
 GLPKDATA::~GLPKDATA() {
-  free(lb);  free(ub);  free(ar);  free(ia); free(ja);
-  glp_delete_prob(problem);
+  free(lb);  free(ub);  free(ar);  free(ia); free(colStart);
+  solverSession().returnProblem(problem);
+  if(batchBase != NULL) { solverSession().returnProblem(batchBase); }
+}
+
+GLPKDATA::GLPKDATA(const GLPKDATA &other) {
+  numrows = other.numrows;  numcols = other.numcols;
+  totalDataSize = other.totalDataSize;
+  lb = (double*) malloc(sizeof(double) * (numcols + 1));
+  ub = (double*) malloc(sizeof(double) * (numcols + 1));
+  colStart = (int*) malloc(sizeof(int) * (numcols + 2));
+  ia = (int*) malloc(sizeof(int) * (totalDataSize + 1));
+  ar = (double*) malloc(sizeof(double) * (totalDataSize + 1));
+  memcpy(lb, other.lb, sizeof(double) * (numcols + 1));
+  memcpy(ub, other.ub, sizeof(double) * (numcols + 1));
+  memcpy(colStart, other.colStart, sizeof(int) * (numcols + 2));
+  memcpy(ia, other.ia, sizeof(int) * (totalDataSize + 1));
+  memcpy(ar, other.ar, sizeof(double) * (totalDataSize + 1));
+
+  colIds = other.colIds;  colKinds = other.colKinds;  colNames = other.colNames;
+  colFromId = other.colFromId;
+  rxnsUsed = other.rxnsUsed;  metsUsed = other.metsUsed;
+  objIdx = other.objIdx;  objCoef = other.objCoef;  objSense = other.objSense;
+  expansion = other.expansion;
+
+  /* The solved batch base stays with the original - the copy solves its own the first time it needs one */
+  problem = solverSession().getProblem();
+  batchBase = NULL;
 }
 
 GLPKDATA::GLPKDATA() {
@@ -59,9 +491,33 @@ GLPKDATA::GLPKDATA() {
 
 /* Objectives are all assumed to be zero except for IDs listed in objId */
 GLPKDATA::GLPKDATA(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &objId, const vector<double> &objCoeff, int sense) {
+  batchBase = NULL;
   initialize(metspace, rxnspace, objId, objCoeff, sense);
 }
 
+/* Objectives on reactions lumped together are added up (scaled by their factors) and ones on blocked reactions dropped */
+GLPKDATA::GLPKDATA(const COMPRESSEDMODEL &compressed, const vector<int> &objId, const vector<double> &objCoeff, int sense) {
+  batchBase = NULL;
+  if(compressed.expansion.empty()) {
+    initialize(compressed.metspace, compressed.rxnspace, objId, objCoeff, sense);
+    return;
+  }
+  if(objId.size() != objCoeff.size()) { printf("ERROR: In initializing GLPKDATA, provided objective IDs and objective Coefficients did not have the same size!\n"); assert(false); }
+  vector<int> colIds;
+  vector<double> colCoeff;
+  for(int i=0; i<objId.size(); i++) {
+    double f;
+    int col = compressed.expansion.columnOf(objId[i], f);
+    if(col == -1) { continue; }
+    int id = compressed.rxnspace.rxns[col].id;
+    vector<int>::iterator it = find(colIds.begin(), colIds.end(), id);
+    if(it == colIds.end()) { colIds.push_back(id); colCoeff.push_back(f * objCoeff[i]); }
+    else { colCoeff[it - colIds.begin()] += f * objCoeff[i]; }
+  }
+  initialize(compressed.metspace, compressed.rxnspace, colIds, colCoeff, sense);
+  expansion = compressed.expansion;
+}
+
 /* Solve the simplex problem vanilla */
 vector<double> GLPKDATA::FBA_SOLVE() {
   setUpProblem();
@@ -102,6 +558,7 @@ vector<double> GLPKDATA::FBA_SOLVE() {
   if(res!=0) { printf("ERROR: Numerical issues with solution... such cases are treated the same as NO GROWTH cases \n");
     printGlpkError(res);
     glp_write_lp(problem, NULL, "PROBLEMATIC_PROBLEM");
+    expandFlux(fluxResult);
     return fluxResult;
   }
 
@@ -113,25 +570,208 @@ vector<double> GLPKDATA::FBA_SOLVE() {
   if(_db.DEBUGFBA) {
     printDoubleVector_rxns(rxnsUsed, fluxResult);
   }
+  expandFlux(fluxResult);
   return fluxResult;
 }
 
 void GLPKDATA::FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage) {
+  vector<int> rxnIds = expansion.empty() ? colIds : expansion.originalIds;
+  FVA_SOLVE(minFlux, maxFlux, optPercentage, rxnIds);
+}
+
+/* FVA on the reactions in rxnIds only. The min and max of every other reaction are just its bounds (on a compressed model
+   they are the range of its column, or zero if it is blocked) */
+void GLPKDATA::FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage, const vector<int> &rxnIds) {
 
   /* You can't have a negative percent or get an objective value more than 100% of the maximum */
   assert(optPercentage >= 0.0f & optPercentage <= 100.0f);
 
+  vector<int> colIdx;
+  for(int i=0; i<rxnIds.size(); i++) {
+    double f;
+    int col = columnOfRxn(rxnIds[i], f);
+    if(col != -1) { colIdx.push_back(col); }
+  }
+  custom_unique(colIdx);
+
   setUpProblem();
-  int status = FastFVA(minFlux, maxFlux, optPercentage);
+  int status = FastFVA(minFlux, maxFlux, optPercentage, colIdx);
   assert(status == 0);
 
-  for(int i=0; i<rxnsUsed.rxns.size(); i++) { 
-    if(_db.DEBUGFVA) { printf("FVA rxn %s min = %4.5f max = %4.3f lb = %4.3f ub = %4.3f\n", rxnsUsed.rxns[i].name, minFlux[i], maxFlux[i], rxnsUsed.rxns[i].lb, rxnsUsed.rxns[i].ub); }
+  if(!expansion.empty()) {
+    vector<double> colMin = minFlux, colMax = maxFlux;
+    expansion.expand(colMin, minFlux);
+    expansion.expand(colMax, maxFlux);
+    /* A negative factor turns the column's minimum into the reaction's maximum */
+    for(int i=0; i<expansion.originalIds.size(); i++) {
+      if(minFlux[i] > maxFlux[i]) { std::swap(minFlux[i], maxFlux[i]); }
+    }
+    return;
+  }
+
+  for(int i=0; i<numcols; i++) { 
+    if(_db.DEBUGFVA) { printf("FVA rxn %s min = %4.5f max = %4.3f lb = %4.3f ub = %4.3f\n", colNames[i].c_str(), minFlux[i], maxFlux[i], lb[i+1], ub[i+1]); }
   }
 
   return;
 }
 
+/* Solve the model once for each set of bound overrides in variants (by reaction ID - every bound that is not overridden
+   stays what this GLPKDATA was built with) and return the objective value and GLPK solution status (GLP_OPT, GLP_NOFEAS,
+   GLP_UNBND...) of each. A variant whose solve fails gets GLP_UNDEF, and anything that is not GLP_OPT gets an objective
+   of 0 (the same answer FBA_SOLVE gives for a failed solve). If fluxes is not NULL the flux vector of each variant is
+   returned too.
+
+   On a compressed model an override on a blocked reaction only checks that zero flux is allowed (the variant is
+   GLP_NOFEAS otherwise), and a reaction lumped with others can only be closed - give it in keepIds to override it
+   with anything else.
+
+   The base model is solved once and kept for later calls. Only bounds differ between variants, so each one is a dual
+   simplex warm-started from the basis the previous one left behind. Variants are spread over _db.LP_THREADS threads,
+   each working on its own copy of the solved base. */
+void GLPKDATA::batchSolve(const vector<vector<BOUNDOVERRIDE> > &variants, vector<double> &objValues, vector<int> &statuses,
+			  vector<vector<double> > *fluxes) {
+  int numVariants = variants.size();
+  objValues.assign(numVariants, 0.0f);
+  statuses.assign(numVariants, GLP_UNDEF);
+  if(fluxes != NULL) { fluxes->assign(numVariants, vector<double>(numcols, 0.0f)); }
+  if(numVariants == 0) { return; }
+
+  /* Look up the (one-based) columns here so the threads don't touch colFromId. which[v][i] is the override that sets
+     column cols[v][i] */
+  vector<vector<int> > cols(numVariants), which(numVariants);
+  vector<bool> noZeroFlux(numVariants, false);
+  for(int v=0; v<numVariants; v++) {
+    for(int i=0; i<variants[v].size(); i++) {
+      const BOUNDOVERRIDE &bound = variants[v][i];
+      double f;
+      int col = columnOfRxn(bound.rxnId, f);
+      bool closing = rougheq(bound.lb, 0.0f, _db.FLUX_CUTOFF) == 1 && rougheq(bound.ub, 0.0f, _db.FLUX_CUTOFF) == 1;
+      if(col == -1) {
+	if(bound.lb > _db.FLUX_CUTOFF || bound.ub < -_db.FLUX_CUTOFF) { noZeroFlux[v] = true; }
+	continue;
+      }
+      if(!closing && !expansion.empty() && expansion.columnSize[col] > 1) {
+	printf("ERROR: batchSolve can only close reaction %d because it is lumped with others in the compressed model\n", bound.rxnId);
+	assert(false);
+      }
+      cols[v].push_back(col + 1);
+      which[v].push_back(i);
+    }
+  }
+
+  if(batchBase == NULL) { solveBatchBase(); }
+
+  int numThreads = std::max(1, std::min(_db.LP_THREADS, numVariants));
+
+#pragma omp parallel num_threads(numThreads)
+  {
+    glp_prob *lp = batchBase;
+    if(numThreads > 1) {
+      lp = solverSession().getProblem();
+      glp_copy_prob(lp, batchBase, GLP_OFF);
+    }
+
+#pragma omp for schedule(dynamic)
+    for(int v=0; v<numVariants; v++) {
+      if(noZeroFlux[v]) { statuses[v] = GLP_NOFEAS; continue; }
+      for(int i=0; i<cols[v].size(); i++) {
+	const BOUNDOVERRIDE &bound = variants[v][which[v][i]];
+	setColumnBounds(lp, cols[v][i], bound.lb, bound.ub);
+      }
+      statuses[v] = warmSolve(lp, GLP_DUALP);
+      if(statuses[v] == GLP_OPT) {
+	objValues[v] = glp_get_obj_val(lp);
+	if(fluxes != NULL) {
+	  for(int j=0; j<numcols; j++) { (*fluxes)[v][j] = glp_get_col_prim(lp, j+1); }
+	}
+      }
+      /* Put the bounds back - the basis stays as the start for the next variant */
+      for(int i=0; i<cols[v].size(); i++) { setColumnBounds(lp, cols[v][i], lb[cols[v][i]], ub[cols[v][i]]); }
+    }
+
+    if(lp != batchBase) { solverSession().returnProblem(lp); }
+  }
+
+  if(fluxes != NULL) {
+    for(int v=0; v<numVariants; v++) { expandFlux((*fluxes)[v]); }
+  }
+
+  if(_db.DEBUGFBA) {
+    for(int v=0; v<numVariants; v++) { printf("Batch variant %d: status %d objective %4.5f\n", v, statuses[v], objValues[v]); }
+  }
+}
+
+/* Maximize the flux through each reaction in targetIds in turn and return the maximum (0 if the LP has no optimum) and the
+   GLPK status for each - producibility screening for many targets at once. If closeOtherTargets is true every target is
+   held at zero flux except the one being maximized (use this when the targets are sinks added for the screen).
+   If fluxes is not NULL the flux vector at each optimum is returned too. On a compressed model a blocked target has a
+   maximum of 0 - put the targets in keepIds if closeOtherTargets is used so that no two of them share a column.
+
+   Like FastFVA this keeps one LP loaded and only moves the objective, so every solve is a primal simplex warm-started
+   from the previous optimum. The model's own objective is put back afterwards. */
+void GLPKDATA::objectiveSweep(const vector<int> &targetIds, bool closeOtherTargets, vector<double> &maxFlux, vector<int> &statuses,
+			      vector<vector<double> > *fluxes) {
+  int numTargets = targetIds.size();
+  maxFlux.assign(numTargets, 0.0f);
+  statuses.assign(numTargets, GLP_UNDEF);
+  if(fluxes != NULL) { fluxes->assign(numTargets, vector<double>(numcols, 0.0f)); }
+  if(numTargets == 0) { return; }
+
+  /* One-based columns and the factor from each column's flux to its target's flux (column 0 for blocked targets) */
+  vector<int> cols;
+  vector<double> factors;
+  for(int t=0; t<numTargets; t++) {
+    double f;
+    cols.push_back(columnOfRxn(targetIds[t], f) + 1);
+    factors.push_back(f);
+  }
+
+  if(batchBase == NULL) { solveBatchBase(); }
+  glp_prob *lp = batchBase;
+
+  for(int i=0; i<objIdx.size(); i++) { glp_set_obj_coef(lp, objIdx[i], 0.0f); }
+  glp_set_obj_dir(lp, GLP_MAX);
+  if(closeOtherTargets) {
+    for(int t=0; t<numTargets; t++) {
+      if(cols[t] != 0) { setColumnBounds(lp, cols[t], 0.0f, 0.0f); }
+    }
+  }
+
+  for(int t=0; t<numTargets; t++) {
+    if(cols[t] == 0) {
+      /* Blocked in the compressed model - its flux is always zero */
+      statuses[t] = GLP_OPT;
+      continue;
+    }
+    if(closeOtherTargets) { setColumnBounds(lp, cols[t], lb[cols[t]], ub[cols[t]]); }
+    glp_set_obj_coef(lp, cols[t], factors[t]);
+    statuses[t] = warmSolve(lp, GLP_PRIMAL);
+    if(statuses[t] == GLP_OPT) {
+      maxFlux[t] = glp_get_obj_val(lp);
+      if(fluxes != NULL) {
+	for(int j=0; j<numcols; j++) { (*fluxes)[t][j] = glp_get_col_prim(lp, j+1); }
+      }
+    }
+    glp_set_obj_coef(lp, cols[t], 0.0f);
+    if(closeOtherTargets) { setColumnBounds(lp, cols[t], 0.0f, 0.0f); }
+    if(_db.DEBUGFBA) { printf("Sweep target %s: status %d max flux %4.5f\n", colNames[cols[t]-1].c_str(), statuses[t], maxFlux[t]); }
+  }
+
+  /* Back to the model as it was built */
+  if(closeOtherTargets) {
+    for(int t=0; t<numTargets; t++) {
+      if(cols[t] != 0) { setColumnBounds(lp, cols[t], lb[cols[t]], ub[cols[t]]); }
+    }
+  }
+  for(int i=0; i<objIdx.size(); i++) { glp_set_obj_coef(lp, objIdx[i], objCoef[i]); }
+  glp_set_obj_dir(lp, (objSense == -1) ? GLP_MIN : GLP_MAX);
+
+  if(fluxes != NULL) {
+    for(int t=0; t<numTargets; t++) { expandFlux((*fluxes)[t]); }
+  }
+}
+
 /* Returns a list of reaction IDs for unnecessary magic exits *
  Requires the metspace and rxnspace in GLPKDATA 
 
@@ -152,6 +792,8 @@ void GLPKDATA::FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, doubl
 int GLPKDATA::gapFindLinprog(vector<int> &usedExits) {
 
   usedExits.clear();
+  /* Needs the exits as columns of their own */
+  assert(expansion.empty());
 
   if(objIdx.size() > 1) { printf("ERROR: gapFindLinprog only supports single-reaction objectives\n"); assert(false); }
   assert(objSense == 1);
@@ -162,14 +804,20 @@ int GLPKDATA::gapFindLinprog(vector<int> &usedExits) {
   double normal_bonus = 100.0f;
   double exit_penalty = 100.0f;
 
-  /* Needed for re-initializing to the previous state from before */
-  vector<int> origIds; 
-  for(int i=0; i<objIdx.size(); i++) { origIds.push_back(rxnsUsed.rxns[objIdx[i]-1].id); }
+  /* Needed for putting back the previous state from before */
+  vector<int> origIdx = objIdx;
   vector<double> origCoeff = objCoef;
+  vector<double> origLb, origUb;
+  for(int i=0; i<objIdx.size(); i++) { origLb.push_back(lb[objIdx[i]]); origUb.push_back(ub[objIdx[i]]); }
 
-  /* Get minimum and maximum possible fluxes - need this to ensure that the reaction is going the right direction */
+  /* Get minimum and maximum possible fluxes - need this to ensure that the reaction is going the right direction
+     (only normal reactions and magic exits get a coefficient below so those are the only ones we need) */
+  vector<int> fvaIds;
+  for(int i=0; i<numcols; i++) {
+    if(colKinds[i] & (RXN_NORMAL | RXN_MAGICEXIT)) { fvaIds.push_back(colIds[i]); }
+  }
   vector<double> minflux; vector<double> maxflux;
-  FVA_SOLVE(minflux, maxflux, 0.0f);
+  FVA_SOLVE(minflux, maxflux, 0.0f, fvaIds);
 
   /* Change the LB and the UB for the original objective(s) before we change them (this is the part I'm not sure how to do if we allow multi-rxn objectives) */
   for(int i=0; i<objIdx.size(); i++) {
@@ -179,36 +827,40 @@ int GLPKDATA::gapFindLinprog(vector<int> &usedExits) {
   /* Identify coefficients that are going the opposite way from how they should, and switch them to go the other way 
    Also, find reactions that only can go one way (either forward or reverse) and add them to the coefficient list */
   objIdx.clear(); objCoef.clear();
-  for(int i=0; i<rxnsUsed.rxns.size(); i++) {
+  for(int i=0; i<numcols; i++) {
     if(minflux[i] < -1E-5 && maxflux[i] < 1E-5) { /* These get a negative coefficient because they will have a negative flux [FIXME - also need to exclude exchanges?] */
-      if(rxnsUsed.rxns[i].id < _db.MINFACTORSPACING) {
+      if(colKinds[i] & RXN_NORMAL) {
 	objIdx.push_back(i+1); objCoef.push_back(-normal_bonus);
-      } else if(rxnsUsed.rxns[i].id >= _db.BLACKMAGICFACTOR && rxnsUsed.rxns[i].id < _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) { 
+      } else if(colKinds[i] & RXN_MAGICEXIT) { 
 	objIdx.push_back(i+1); objCoef.push_back(exit_penalty);
       }
     } else if(minflux[i] > -1E-5 & maxflux[i] > 1E-5) { /* These get positive coefficients because they will have a positive flux */
-      if(rxnsUsed.rxns[i].id < _db.MINFACTORSPACING) {
+      if(colKinds[i] & RXN_NORMAL) {
 	objIdx.push_back(i+1); objCoef.push_back(normal_bonus);
       }
-      else if(rxnsUsed.rxns[i].id >= _db.BLACKMAGICFACTOR && rxnsUsed.rxns[i].id < _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) { 
+      else if(colKinds[i] & RXN_MAGICEXIT) { 
 	objIdx.push_back(i+1); objCoef.push_back(-exit_penalty);
       }
     }
   }
 
   vector<double> result = this->FBA_SOLVE();
-  if( result[rxnsUsed.idxFromId(_db.BIOMASS)] < _db.GROWTH_CUTOFF ) { printf("ERROR: Gapfind failed to return a solution...\n"); return -1; }
 
-  /* Re-initialize */
-  this->initialize(metsUsed, rxnsUsed, origIds, origCoeff, objSense);
+  /* Put the objective and its bounds back */
+  for(int i=0; i<origIdx.size(); i++) { lb[origIdx[i]] = origLb[i]; ub[origIdx[i]] = origUb[i]; }
+  changeObjective(origIdx, origCoeff);
+  setUpProblem();
+
+  double biomassFactor;
+  if( result[columnOfRxn(_db.BIOMASS, biomassFactor)] < _db.GROWTH_CUTOFF ) { printf("ERROR: Gapfind failed to return a solution...\n"); return -1; }
 
   /* Add needed magic exits to the list of exits that are used */
-  for(int i=0; i<result.size(); i++) {
-    if( rougheq(result[i], 0.0f, _db.FLUX_CUTOFF)) { continue; }
-    if( _db.DEBUGGAPFILL ) { printf("Reaction %s - gapFindLinprog result = %4.3f\n", rxnsUsed.rxns[i].name, result[i]); }
-    if(rxnsUsed.rxns[i].id < _db.BLACKMAGICFACTOR || rxnsUsed.rxns[i].id > _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) { continue; }
+  for(int i=0; i<numcols; i++) {
+    if(!(colKinds[i] & RXN_MAGICEXIT)) { continue; }
     /* If the min flux is close to 0 ignore it - it is not needed (1E-5 is OK as long as we do the conditioning step above making all the coeffs = 1) */
-    usedExits.push_back(rxnsUsed.rxns[i].id);
+    if( rougheq(result[i], 0.0f, _db.FLUX_CUTOFF)) { continue; }
+    if( _db.DEBUGGAPFILL ) { printf("Reaction %s - gapFindLinprog result = %4.3f\n", colNames[i].c_str(), result[i]); }
+    usedExits.push_back(colIds[i]);
   }
 
   custom_unique(usedExits);
@@ -216,6 +868,218 @@ int GLPKDATA::gapFindLinprog(vector<int> &usedExits) {
   return 1;
 }
 
+/* Single-LP alternative to gapFindLinprog (choose it with _db.GAPFIND_SPLIT_LP). Same arguments and return values.
+
+ MINIMIZE sum(EF + ER)
+
+ subject to S*v = 0, the bounds, v_objective >= objMin and v_e = EF_e - ER_e for every magic exit e, with EF and ER >= 0.
+
+ Splitting every exit into a forward and a reverse part makes the objective the total absolute flux through the magic
+ exits, so (unlike gapFindLinprog) we don't need FVA first to know which way each one goes, and nothing has to be
+ re-initialized afterwards. The exits carrying flux in the optimum are the ones that are used. */
+int GLPKDATA::gapFindSplitLinprog(vector<int> &usedExits) {
+
+  usedExits.clear();
+  /* Needs the exits as columns of their own */
+  assert(expansion.empty());
+
+  if(objIdx.size() > 1) { printf("ERROR: gapFindSplitLinprog only supports single-reaction objectives\n"); assert(false); }
+  assert(objSense == 1);
+
+  /* Minimum possible value of objective function (forces solutions that grow) - same as gapFindLinprog */
+  double objMin = 1.0f;
+
+  setUpProblem();
+  glp_set_obj_dir(problem, GLP_MIN);
+  for(int i=1; i<numcols+1; i++) { glp_set_obj_coef(problem, i, 0.0f); }
+  for(int i=0; i<objIdx.size(); i++) { setColumnBounds(problem, objIdx[i], objMin, 1000.0f); }
+
+  /* Split columns go after the reactions and the rows tying them to their exit go after the metabolites */
+  vector<int> exitIdx;
+  for(int i=0; i<numcols; i++) {
+    if(colKinds[i] & RXN_MAGICEXIT) { exitIdx.push_back(i); }
+  }
+  int numExits = exitIdx.size();
+  if(numExits > 0) {
+    int firstSplit = glp_add_cols(problem, 2*numExits);
+    int firstLink = glp_add_rows(problem, numExits);
+    int ind[4]; double val[4];
+    for(int e=0; e<numExits; e++) {
+      int fwd = firstSplit + 2*e;
+      int rev = fwd + 1;
+      glp_set_col_bnds(problem, fwd, GLP_LO, 0.0f, 0.0f);
+      glp_set_col_bnds(problem, rev, GLP_LO, 0.0f, 0.0f);
+      glp_set_obj_coef(problem, fwd, 1.0f);
+      glp_set_obj_coef(problem, rev, 1.0f);
+      /* v_e - EF_e + ER_e = 0 */
+      ind[1] = exitIdx[e] + 1;  val[1] = 1.0f;
+      ind[2] = fwd;             val[2] = -1.0f;
+      ind[3] = rev;             val[3] = 1.0f;
+      glp_set_row_bnds(problem, firstLink + e, GLP_FX, 0.0f, 0.0f);
+      glp_set_mat_row(problem, firstLink + e, 3, ind, val);
+    }
+  }
+
+  /* Solve the same way as FBA_SOLVE */
+  glp_smcp param;
+  glp_init_smcp(&param);
+  param.presolve = GLP_ON;
+  param.meth = GLP_DUALP;
+  glp_std_basis(problem);
+  glp_scale_prob(problem, GLP_SF_EQ);
+  int res = glp_simplex(problem, &param);
+  if(res != 0 || glp_get_status(problem) != GLP_OPT) {
+    printf("ERROR: Gapfind failed to return a solution...\n");
+    if(res != 0) { printGlpkError(res); }
+    setUpProblem();
+    return -1;
+  }
+
+  for(int e=0; e<numExits; e++) {
+    int i = exitIdx[e];
+    double flux = glp_get_col_prim(problem, i+1);
+    if( rougheq(flux, 0.0f, _db.FLUX_CUTOFF)) { continue; }
+    if( _db.DEBUGGAPFILL ) { printf("Reaction %s - gapFindSplitLinprog result = %4.3f\n", colNames[i].c_str(), flux); }
+    usedExits.push_back(colIds[i]);
+  }
+
+  custom_unique(usedExits);
+
+  /* Back to the problem as it was built (without the split columns) */
+  setUpProblem();
+
+  return 1;
+}
+
+/* Starting point handed to glp_intopt through milpCallback (x is one-based like GLPK's columns) */
+struct MILPSTART{
+  vector<double> x;
+  bool given;
+};
+
+/* Minimum-cost reaction addition as a MILP, solved with GLPK's branch-and-cut.
+
+ MINIMIZE sum(addCost_i * z_i)
+
+ subject to S*v = 0, the bounds, v_objective >= minGrowth and lb_i*z_i <= v_i <= ub_i*z_i, z_i binary, for every column
+ with addCost_i >= 0. Columns with a negative addCost are already in the model and get no binary.
+
+ startIds are the costed reactions that are on in a solution we already know (e.g. from Dijkstras). If the model grows
+ with only those on, that solution is given to glp_intopt as its first incumbent, so it only has to prove (or find)
+ something cheaper. The search stops after _db.MILP_TIME_LIMIT seconds with the best solution found so far.
+
+ Returns 1 and the IDs of the costed reactions that are on in onIds, or -1 if no solution was found */
+int GLPKDATA::minCostMilp(const vector<double> &addCost, double minGrowth, const vector<int> &startIds, vector<int> &onIds) {
+
+  onIds.clear();
+  assert(expansion.empty());
+  assert(addCost.size() == numcols);
+  if(objIdx.size() > 1) { printf("ERROR: minCostMilp only supports single-reaction objectives\n"); assert(false); }
+
+  vector<int> costed;
+  for(int i=0; i<numcols; i++) {
+    if(addCost[i] >= 0.0f) { costed.push_back(i); }
+  }
+  int numCosted = costed.size();
+
+  /* Fluxes of the starting solution: FBA with every costed reaction outside startIds closed */
+  MILPSTART start;
+  start.given = true;
+  vector<bool> inStart(numcols, false);
+  for(int i=0; i<startIds.size(); i++) {
+    if(hasColumn(startIds[i])) { double f; inStart[columnOfRxn(startIds[i], f)] = true; }
+  }
+  setUpProblem();
+  for(int q=0; q<numCosted; q++) {
+    if(!inStart[costed[q]]) { setColumnBounds(problem, costed[q]+1, 0.0f, 0.0f); }
+  }
+  glp_smcp lpParam;
+  glp_init_smcp(&lpParam);
+  lpParam.presolve = GLP_ON;
+  lpParam.meth = GLP_DUALP;
+  glp_std_basis(problem);
+  int res = glp_simplex(problem, &lpParam);
+  if(res == 0 && glp_get_status(problem) == GLP_OPT && !objIdx.empty() && glp_get_col_prim(problem, objIdx[0]) >= minGrowth) {
+    start.x.assign(numcols + numCosted + 1, 0.0f);
+    for(int i=0; i<numcols; i++) { start.x[i+1] = glp_get_col_prim(problem, i+1); }
+    /* A reaction is only switched on in the start if it carries flux */
+    for(int q=0; q<numCosted; q++) {
+      if(fabs(start.x[costed[q]+1]) > 1E-9) { start.x[numcols + q + 1] = 1.0f; }
+      else { start.x[costed[q]+1] = 0.0f; }
+    }
+    start.given = false;
+  } else {
+    printf("WARNING: The starting solution for the MILP does not grow - starting from scratch\n");
+  }
+
+  /* The MILP itself: a binary after the reactions for each costed column, and two rows tying it to its flux */
+  setUpProblem();
+  glp_set_obj_dir(problem, GLP_MIN);
+  for(int i=1; i<numcols+1; i++) { glp_set_obj_coef(problem, i, 0.0f); }
+  for(int i=0; i<objIdx.size(); i++) { setColumnBounds(problem, objIdx[i], std::max(lb[objIdx[i]], minGrowth), ub[objIdx[i]]); }
+
+  if(numCosted > 0) {
+    int firstBin = glp_add_cols(problem, numCosted);
+    int firstLink = glp_add_rows(problem, 2*numCosted);
+    int ind[3]; double val[3];
+    for(int q=0; q<numCosted; q++) {
+      int col = costed[q] + 1;
+      int bin = firstBin + q;
+      glp_set_col_kind(problem, bin, GLP_BV);
+      glp_set_obj_coef(problem, bin, addCost[costed[q]]);
+      /* v - ub*z <= 0 */
+      ind[1] = col;  val[1] = 1.0f;
+      ind[2] = bin;  val[2] = -ub[col];
+      glp_set_row_bnds(problem, firstLink + 2*q, GLP_UP, 0.0f, 0.0f);
+      glp_set_mat_row(problem, firstLink + 2*q, 2, ind, val);
+      /* v - lb*z >= 0 */
+      val[2] = -lb[col];
+      glp_set_row_bnds(problem, firstLink + 2*q + 1, GLP_LO, 0.0f, 0.0f);
+      glp_set_mat_row(problem, firstLink + 2*q + 1, 2, ind, val);
+    }
+  }
+
+  /* glp_intopt needs the LP relaxation solved first when its own presolver is off (it has to be off for the starting
+     solution to be in terms of our columns) */
+  glp_std_basis(problem);
+  glp_scale_prob(problem, GLP_SF_EQ);
+  lpParam.presolve = GLP_OFF;
+  res = glp_simplex(problem, &lpParam);
+  if(res != 0 || glp_get_status(problem) != GLP_OPT) {
+    printf("ERROR: The LP relaxation of the gapfill MILP has no solution\n");
+    if(res != 0) { printGlpkError(res); }
+    setUpProblem();
+    return -1;
+  }
+
+  glp_iocp param;
+  glp_init_iocp(&param);
+  param.presolve = GLP_OFF;
+  param.mip_gap = 0.0f;
+  param.tm_lim = 1000 * _db.MILP_TIME_LIMIT;
+  param.cb_func = &milpCallback;
+  param.cb_info = &start;
+  if(!_db.DEBUGFBA) { param.msg_lev = GLP_MSG_OFF; }
+  res = glp_intopt(problem, &param);
+
+  int status = glp_mip_status(problem);
+  if( (res != 0 && res != GLP_ETMLIM) || (status != GLP_OPT && status != GLP_FEAS) ) {
+    printf("ERROR: GLPK found no solution to the gapfill MILP\n");
+    if(res != 0) { printGlpkError(res); }
+    setUpProblem();
+    return -1;
+  }
+  if(status == GLP_FEAS) { printf("WARNING: MILP time limit reached - using the best solution found (may not be optimal)\n"); }
+
+  for(int q=0; q<numCosted; q++) {
+    if(glp_mip_col_val(problem, numcols + q + 1) > 0.5f) { onIds.push_back(colIds[costed[q]]); }
+  }
+  if(_db.DEBUGGAPFILL) { printf("MILP gapfill: %d of %d costed reactions on, cost %4.3f\n", (int)onIds.size(), numCosted, glp_mip_obj_val(problem)); }
+
+  setUpProblem();
+  return 1;
+}
+
 /************************ Private Methods ************************/
 
 /* This code is modified from FastFVA by S. Gudmundsson and I. Theile - see  S. Gudmundsson and I. Thiele. Computationally efficient flux variability analysis, BMC Bioinformatics, 2010, 11:489
@@ -229,10 +1093,16 @@ int GLPKDATA::gapFindLinprog(vector<int> &usedExits) {
 #define FVA_MODIFIED_FAIL  2
 #define TIME_RESTART_LIM   60
 
-int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage) {
+int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage, const vector<int> &colIdx) {
 
-  minFlux.clear(); minFlux.assign(numcols, 0.0f);
-  maxFlux.clear(); maxFlux.assign(numcols, 0.0f);
+  /* Columns not asked for just get their bounds */
+  minFlux.clear(); maxFlux.clear();
+  for(int k=0; k<numcols; k++) { minFlux.push_back(lb[k+1]); maxFlux.push_back(ub[k+1]); }
+  vector<bool> needMin(numcols, false);
+  vector<bool> needMax(numcols, false);
+  for(int q=0; q<colIdx.size(); q++) { needMin[colIdx[q]] = true; needMax[colIdx[q]] = true; }
+  int numSolved = 0;
+  int numInspected = 0;
 
   // Parameters for the glpk optimizer, use mostly default settings
   glp_smcp param;
@@ -256,6 +1126,9 @@ int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double o
     if(ret != 0) {    printGlpkError(ret); return FVA_INIT_FAIL; }
   }
 
+  /* Any column sitting at one of its bounds in a feasible solution has that bound as its min (or max) - no LP needed */
+  numInspected += inspectFvaSolution(needMin, needMax, minFlux, maxFlux);
+
   double z = glp_get_obj_val(this->problem);
   
   // Determine the value of objective function bound
@@ -293,7 +1166,10 @@ int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double o
   
   for (int iRound = 0; iRound < 2; iRound++)  {
     glp_set_obj_dir(this->problem, (iRound==0) ? GLP_MIN : GLP_MAX);
-    for (int k = 0; k < this->numcols; k++) {
+    vector<bool> &need = (iRound==0) ? needMin : needMax;
+    for (int q = 0; q < colIdx.size(); q++) {
+      int k = colIdx[q];
+      if(!need[k]) { continue; }
       glp_set_obj_coef(this->problem, k+1, 1.0f);
       ret = glp_simplex(this->problem, &param);
       if (ret != 0) {
@@ -314,9 +1190,14 @@ int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double o
       glp_set_obj_coef(this->problem, k+1, 0.0f);      
       if (glp_get_obj_dir(this->problem) == GLP_MIN)  {  minFlux[k]= glp_get_obj_val(this->problem); }
       else{ maxFlux[k]=glp_get_obj_val(this->problem);  }
+      need[k] = false;
+      numSolved++;
+      numInspected += inspectFvaSolution(needMin, needMax, minFlux, maxFlux);
     }
   }
 
+  if(_db.DEBUGFVA) { printf("FVA: %d LPs solved, %d of %d skipped by solution inspection\n", numSolved, numInspected, 2*(int)colIdx.size()); }
+
   /* Reset the problem, because we don't want the added row to mess things up for us... */
   setUpProblem();
   
@@ -324,18 +1205,30 @@ int GLPKDATA::FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double o
 }
 
 
+/* Solution inspection for FastFVA: every column still in needMin (needMax) whose flux in the current solution of
+   "problem" is at its lower (upper) bound gets that bound as its minimum (maximum) and is dropped from the list.
+   Returns the number of LPs saved */
+int GLPKDATA::inspectFvaSolution(vector<bool> &needMin, vector<bool> &needMax, vector<double> &minFlux, vector<double> &maxFlux) {
+  int saved = 0;
+  for(int k=0; k<numcols; k++) {
+    if(!needMin[k] && !needMax[k]) { continue; }
+    double flux = glp_get_col_prim(this->problem, k+1);
+    if(needMin[k] && flux <= lb[k+1] + _db.FLUX_CUTOFF) { minFlux[k] = lb[k+1]; needMin[k] = false; saved++; }
+    if(needMax[k] && flux >= ub[k+1] - _db.FLUX_CUTOFF) { maxFlux[k] = ub[k+1]; needMax[k] = false; saved++; }
+  }
+  return saved;
+}
+
 /* Set up the glp_prob "problem" to have all the data it needs to run a simulation based on the current arrays 
  Also has the possibility of deleting the old problem and starting fresh IF you don't modify any of those private variables! 
 
 Uses the following class variables: problem (resets before using)
  numrows, numcols
  lb, ub
- ia, ja, ar 
- totalDataSize 
+ colStart, ia, ar 
  objIdx, objCoef */
 void GLPKDATA:: setUpProblem() {
-  glp_delete_prob(problem);
-  problem = glp_create_prob();
+  glp_erase_prob(problem);
 
   if(objSense == -1) { glp_set_obj_dir(problem, GLP_MIN); } 
   else { glp_set_obj_dir(problem, GLP_MAX); }
@@ -348,27 +1241,101 @@ void GLPKDATA:: setUpProblem() {
   for(int i=1; i<numrows+1; i++) {    glp_set_row_bnds(problem, i, GLP_FX, 0.0f, 0.0f);   }
   
   /* Columns (reactions) get bounded according to the assigned LB and UB */
-  for(int i=1; i<numcols+1; i++) {
-    if( rougheq(lb[i] - ub[i], 0.0f, _db.FLUX_CUTOFF) == 1 ) {  glp_set_col_bnds(problem, i, GLP_FX, lb[i], lb[i]); }
-    else { glp_set_col_bnds(problem, i, GLP_DB, lb[i], ub[i]); }
-  }
-
-  /* Objective function - all zeros except for the stated objectives, which have the desired coefficients */
-  vector<int>::iterator it;
-  for(int i=1; i<numcols+1; i++) {
-    it = find(objIdx.begin(), objIdx.end(), i);
-    if(it == objIdx.end()) { glp_set_obj_coef(problem, i, 0); }
-    else {
-      glp_set_obj_coef(problem, i, objCoef[(int)(it-objIdx.begin())]); 
-    }
+  for(int i=1; i<numcols+1; i++) {  setColumnBounds(problem, i, lb[i], ub[i]);  }
+
+  /* Objective function - new columns start at zero so only the stated objectives need setting */
+  for(int i=0; i<objIdx.size(); i++) { glp_set_obj_coef(problem, objIdx[i], objCoef[i]); }
+
+  /* The S matrix itself, a column at a time (GLPK reads ind[1..len] and val[1..len]) */
+  for(int j=1; j<numcols+1; j++) {
+    glp_set_mat_col(problem, j, colStart[j+1] - colStart[j], ia + colStart[j] - 1, ar + colStart[j] - 1);
   }
 
-  /* The S matrix itself */
-  glp_load_matrix(problem, totalDataSize, ia, ja, ar);
+}
 
-  int (*func)(void*, const char *) = &suppressGLPKOutput;
-  if(!_db.DEBUGFBA) { glp_term_hook(func, NULL); }
+/* Build batchBase from the current arrays and solve it the same way FBA_SOLVE does, so the variants in batchSolve
+   start from an optimal basis of the base model */
+void GLPKDATA::solveBatchBase() {
+  setUpProblem();
+  batchBase = solverSession().getProblem();
+  glp_copy_prob(batchBase, problem, GLP_OFF);
 
+  glp_smcp param;
+  glp_init_smcp(&param);
+  param.presolve = GLP_ON;
+  param.meth = GLP_DUALP;
+
+  glp_std_basis(batchBase);
+  glp_scale_prob(batchBase, GLP_SF_EQ);
+  int res = glp_simplex(batchBase, &param);
+  if(res != 0) {
+    /* The presolver doesn't leave a basis behind if the base model has no solution - the variants start from scratch instead */
+    if(_db.DEBUGFBA) { printGlpkError(res); }
+    glp_std_basis(batchBase);
+  }
+}
+
+/* Re-solve lp starting from whatever basis it has. Use GLP_DUALP after changing bounds (the old basis is still dual
+   feasible) and GLP_PRIMAL after changing the objective (it is still primal feasible) - either way it usually takes only a
+   few pivots. Returns the GLPK solution status, or GLP_UNDEF if the solver could not finish. */
+int GLPKDATA::warmSolve(glp_prob *lp, int method) {
+  glp_smcp param;
+  glp_init_smcp(&param);
+  param.presolve = GLP_OFF;
+  param.meth = method;
+  if(!_db.DEBUGFBA) { param.msg_lev = GLP_MSG_OFF; }
+
+  int res = glp_simplex(lp, &param);
+  if(res == 0) { return glp_get_status(lp); }
+
+  /* Recover the same way FastFVA does - start again from a standard basis with the presolver on */
+  glp_std_basis(lp);
+  param.presolve = GLP_ON;
+  res = glp_simplex(lp, &param);
+  if(res == 0) { return glp_get_status(lp); }
+  if(res == GLP_ENOPFS) { return GLP_NOFEAS; }
+  if(res == GLP_ENODFS) { return GLP_UNBND; }
+  return GLP_UNDEF;
+}
+
+/* Zero-based column of reaction rxnId (-1 if compressing the model blocked it) and the factor from the column's flux to
+   the reaction's flux */
+int GLPKDATA::columnOfRxn(int rxnId, double &rxnFactor) {
+  if(!expansion.empty()) { return expansion.columnOf(rxnId, rxnFactor); }
+  rxnFactor = 1.0f;
+  mapColumns();
+  map<int,int>::const_iterator it = colFromId.find(rxnId);
+  if(it == colFromId.end()) {
+    printf("FAILURE: Attempt to get a column for reaction ID %d that is not in the problem\n", rxnId);
+    assert(false);
+  }
+  return it->second;
+}
+
+/* Is rxnId a column of its own (uncompressed models only)? */
+bool GLPKDATA::hasColumn(int rxnId) {
+  mapColumns();
+  return colFromId.find(rxnId) != colFromId.end();
+}
+
+/* Fill colFromId - it is only needed by the solves that take reaction IDs, so initialize doesn't */
+void GLPKDATA::mapColumns() {
+  if(!colFromId.empty() || numcols == 0) { return; }
+  for(int i=0; i<numcols; i++) { colFromId[colIds[i]] = i; }
+}
+
+/* Flux over the columns --> flux over the reactions of the model that was compressed (nothing to do if it wasn't) */
+void GLPKDATA::expandFlux(vector<double> &flux) const {
+  if(expansion.empty()) { return; }
+  vector<double> full;
+  expansion.expand(flux, full);
+  flux.swap(full);
+}
+
+/* Fixed if the bounds are (nearly) equal and double-bounded otherwise. col is one-based */
+void GLPKDATA::setColumnBounds(glp_prob *lp, int col, double colLb, double colUb) {
+  if( rougheq(colLb - colUb, 0.0f, _db.FLUX_CUTOFF) == 1 ) {  glp_set_col_bnds(lp, col, GLP_FX, colLb, colLb); }
+  else { glp_set_col_bnds(lp, col, GLP_DB, colLb, colUb); }
 }
 
 /******* All of these functions expect one-based indexes (one reason I made them private... )*******/
@@ -385,17 +1352,25 @@ void GLPKDATA::changeObjective(vector<int> newIdx, vector<double> newCoeffs) {
 void GLPKDATA::validateSense(int sense) {
   assert(sense == -1 | sense == 1);
 }
-int GLPKDATA::suppressGLPKOutput(void *info, const char *s) {
-  /* GLPK doesn't print if this function returns 1 so that's what I do */
-  return 1;
+/* Gives glp_intopt the starting solution (a MILPSTART) the first time it asks for a heuristic one */
+void GLPKDATA::milpCallback(glp_tree *tree, void *info) {
+  MILPSTART *start = (MILPSTART*) info;
+  if(start->given || glp_ios_reason(tree) != GLP_IHEUR) { return; }
+  glp_ios_heur_sol(tree, &start->x[0]);
+  start->given = true;
 }
 
 /* (Re)-initialize based on the given data 
  I did nto pass by reference because it causes problems with re-initializign from values already in the class (causes an easy bug to make) */
 void GLPKDATA::initialize(const METSPACE &metspace, const RXNSPACE &rxnspace, vector<int> objId, vector<double> objCoeff, int sense) {
 
-  rxnsUsed = rxnspace;
-  metsUsed = metspace;
+  /* Full copies of the model are only kept for the debugging printouts */
+  if(_db.DEBUGFBA) {
+    rxnsUsed = rxnspace;
+    metsUsed = metspace;
+  }
+  /* Anything batchSolve kept from before is for the old problem */
+  if(batchBase != NULL) { solverSession().returnProblem(batchBase); batchBase = NULL; }
 
   if(objId.size() != objCoeff.size()) { printf("ERROR: In initializing GLPKDATA, provided objective IDs and objective Coefficients did not have the same size!\n"); assert(false); }
   
@@ -411,8 +1386,8 @@ void GLPKDATA::initialize(const METSPACE &metspace, const RXNSPACE &rxnspace, ve
   int total = 1;
   for(int i=0; i<numcols; i++) { total += rxnspace.rxns[i].stoich.size();  }
 
+  colStart = (int*) malloc( sizeof(int)*(numcols + 2));
   ia = (int*) malloc( sizeof(int)*total);
-  ja = (int*) malloc( sizeof(int)*total);
   ar = (double*) malloc( sizeof(double)*total);
 
   /************** Fill up data ******************/
@@ -422,39 +1397,67 @@ void GLPKDATA::initialize(const METSPACE &metspace, const RXNSPACE &rxnspace, ve
   for(int i=0; i<objId.size(); i++) { objIdx.push_back(rxnspace.idxFromId(objId[i]) + 1);  }
   this->objCoef = objCoeff;
 
-  /* Fill LB and UB from reaction data */
-  for(int i=0; i<numcols; i++) { lb[i+1] = rxnspace.rxns[i].lb; ub[i+1] = rxnspace.rxns[i].ub; }
+  /* Fill LB and UB and what we need to know about each column from reaction data. Read the bounds from rxns itself -
+     they may have been changed there directly */
+  colIds.resize(numcols);  colKinds.resize(numcols);  colNames.resize(numcols);
+  colFromId.clear();
+  for(int i=0; i<numcols; i++) {
+    const REACTION &rxn = rxnspace.rxns[i];
+    lb[i+1] = rxn.lb; ub[i+1] = rxn.ub;
+    colIds[i] = rxn.id;  colKinds[i] = rxn.kind;  colNames[i] = rxn.name;
+  }
+
+  /* Row of each metabolite by ID, so the matrix can be filled without a lookup per entry */
+  int minMetId = INT_MAX, maxMetId = INT_MIN;
+  for(int i=0; i<numrows; i++) {
+    minMetId = std::min(minMetId, metspace.mets[i].id);
+    maxMetId = std::max(maxMetId, metspace.mets[i].id);
+  }
+  vector<int> metRow;
+  if(numrows > 0) { metRow.assign(maxMetId - minMetId + 1, 0); }
+  for(int i=0; i<numrows; i++) { metRow[metspace.mets[i].id - minMetId] = i + 1; }
 
-  /* Fill up ia (row counter), ja (column counter) and ar (stoich coeff) from the stoich data */
+  /* Fill up the S matrix by column: the entries of (one-based) column j are ia[colStart[j]] ... ia[colStart[j+1] - 1]
+     (metabolite rows) and the same places in ar (stoich coeffs) */
   int counter=0;
   for(int j=0; j<numcols; j++) {
-    for(int i=0; i < rxnspace.rxns[j].stoich.size(); i++){
+    colStart[j+1] = counter + 1;
+    const vector<STOICH> &stoich = rxnspace.rxns[j].stoich;
+    for(int i=0; i < stoich.size(); i++){
       /* Don't allow 0's to mess things up... */
-      if(rxnspace.rxns[j].stoich[i].rxn_coeff < 1E-8 && rxnspace.rxns[j].stoich[i].rxn_coeff > -1E-8) { continue; }
+      if(stoich[i].rxn_coeff < 1E-8 && stoich[i].rxn_coeff > -1E-8) { continue; }
+      int metId = stoich[i].met_id;
+      int row = (metId >= minMetId && metId <= maxMetId) ? metRow[metId - minMetId] : 0;
+      if(row == 0) {
+	printf("FAIL: Attempted to access metabolite %d that is not present in the metabolite struct...\n", metId);
+	assert(false);
+      }
       int idx = counter + 1;
-      ia[idx] = metspace.idxFromId(rxnspace.rxns[j].stoich[i].met_id)+1; // Rows: Metabolites
-      ja[idx] = j+1; // Columns = reactions
-      ar[idx] = rxnspace.rxns[j].stoich[i].rxn_coeff;
+      ia[idx] = row;
+      ar[idx] = stoich[i].rxn_coeff;
       counter++;
     }
   }
+  colStart[numcols+1] = counter + 1;
   totalDataSize = counter;
-  problem = glp_create_prob();
+  problem = solverSession().getProblem();
 }
 
 /* Print out all those lovely private variables */
 void GLPKDATA::printPrivateStuff() {
   for(int i=1; i<numcols + 1; i++) {
-    printf("REACTION: %s ... ", rxnsUsed.rxns[i-1].name);
+    printf("REACTION: %s ... ", colNames[i-1].c_str());
     printf("LB = %4.3f; UB = %4.3f \n", lb[i], ub[i]);
   }
-  for(int i=0; i< totalDataSize; i++) {
-    printf("Reaction INDEX %d (NAME: %s ) and metabolite INDEX %d (NAME: %s) had coefficient %4.3f\n", 
-	   ja[i+1]-1  , rxnsUsed.rxns[ja[i+1]-1].name, ia[i+1]-1, metsUsed.mets[ia[i+1] - 1].name, ar[i+1]);
+  for(int j=1; j<numcols + 1; j++) {
+    for(int k=colStart[j]; k<colStart[j+1]; k++) {
+      printf("Reaction INDEX %d (NAME: %s ) and metabolite INDEX %d (NAME: %s) had coefficient %4.3f\n", 
+	     j-1, colNames[j-1].c_str(), ia[k]-1, metsUsed.mets.empty() ? "" : metsUsed.mets[ia[k] - 1].name.c_str(), ar[k]);
+    }
   }
   printf("OBJECTIVES:\n");
   for(int i=0; i<objIdx.size(); i++){
-    printf("%s (coefficient = %4.3f)\n", rxnsUsed.rxns[objIdx[i]-1].name, objCoef[i]);
+    printf("%s (coefficient = %4.3f)\n", colNames[objIdx[i]-1].c_str(), objCoef[i]);
   }
 
 }
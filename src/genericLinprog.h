@@ -6,26 +6,97 @@
 #ifndef GENERICLINPROG_H
 #define GENERICLINPROG_H
 
+/* What every LP solver behind FBA_SOLVE / FVA_SOLVE provides (GLPKDATA is the only one so far) */
+class LPBACKEND {
+ public:
+  virtual ~LPBACKEND();
+  virtual vector<double> FBA_SOLVE() = 0;
+  virtual void FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage) = 0;
+  virtual void FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage, const vector<int> &rxnIds) = 0;
+};
+
+/* The backend for this model - delete it when done */
+LPBACKEND* newLpBackend(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &objId, const vector<double> &objCoeff, int sense);
+
 /* This is for reverse-compatibility */
 vector<double> FBA_SOLVE(const vector<REACTION> &rxns, const METSPACE &metspace);
 vector<double> FBA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace);
+vector<double> FBA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &objId, const vector<double> &objCoeff,
+			 int sense);
+/* Hash of everything FBA_SOLVE's answer depends on: the reactions in order with their bounds and stoichiometry, and the
+   objective. FBA_SOLVE caches its answers (_db.FBA_CACHE_SIZE of them, least recently used go first) under it, and
+   compares the whole model before it uses one */
+unsigned long long modelFingerprint(const RXNSPACE &rxnspace, const vector<int> &objId, const vector<double> &objCoeff, int sense);
+/* Times FBA_SOLVE found its answer in the cache and times it had to solve, since the start or clearFbaCache() */
+void fbaCacheStats(int &hits, int &misses);
+void clearFbaCache();
 void FVA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, double optPct, vector<double> &minflux, 
 	       vector<double> &maxflux);
+/* FVA on only the reactions in rxnIds (everything else gets its bounds as the min and max) */
+void FVA_SOLVE(const RXNSPACE &rxnspace, const METSPACE &metspace, double optPct, const vector<int> &rxnIds,
+	       vector<double> &minflux, vector<double> &maxflux);
+
+/* Take blocked reactions and dead-end metabolites out of a model and lump linear chains - see genericLinprog.cc */
+void compressModel(const RXNSPACE &rxnspace, const METSPACE &metspace, const vector<int> &keepIds, COMPRESSEDMODEL &compressed);
+
+/* A thread's GLPK state: the terminal hook of its GLPK environment and the problems it keeps for reuse. Every thread gets
+   its own from solverSession(), and a glp_prob must be deleted or returned by the thread that got it (GLPK keeps track of
+   memory per environment). Threads only run LPs at the same time safely if GLPK was built with thread-local storage */
+class LPSESSION{
+ public:
+  LPSESSION();
+  ~LPSESSION();
+  /* An empty problem - one handed back earlier if there is one */
+  glp_prob* getProblem();
+  /* Empty lp and keep it for the next getProblem */
+  void returnProblem(glp_prob *lp);
+
+  int numCreated;
+  int numReused;
+  /* Problems given out by getProblem and not handed back yet */
+  int numOutstanding;
+
+ private:
+  vector<glp_prob*> spare;
+  /* Sessions are reached through solverSession() only */
+  LPSESSION(const LPSESSION &other);
+  LPSESSION& operator=(const LPSESSION &rhs);
+};
+
+/* The calling thread's session (made the first time the thread asks) */
+LPSESSION& solverSession();
+/* Free the calling thread's session and its GLPK environment - for threads that are about to go away. Nothing GLPK made
+   for this thread may still be in use - every problem from getProblem must have been returned (asserted) */
+void closeSolverSession();
+int numSolverSessions();
 
 /* The best way to ensure consistency is perhaps to force the user to make a new one of these if the problem changes - 
    I try to enforce that with private and public here */
-class GLPKDATA {
+class GLPKDATA : public LPBACKEND {
  public:
   GLPKDATA();
   GLPKDATA(const RXNSPACE &rxns, const METSPACE &mets, const vector<int> &objId, const vector<double> &objCoeff, int sense);
+  /* IDs passed in and flux vectors returned are for the reactions of the model that was compressed */
+  GLPKDATA(const COMPRESSEDMODEL &compressed, const vector<int> &objId, const vector<double> &objCoeff, int sense);
+  /* The copy gets its own glp_prob from the calling thread's session - copy a GLPKDATA once per thread to solve it from
+     several threads. Like any GLPKDATA it must be used and destroyed in the thread that made it */
+  GLPKDATA(const GLPKDATA &other);
   ~GLPKDATA();
-  /* TODO: need copy constructor */
 
   /* Solver routines */
   int gapFindLinprog(vector<int> &usedExits);
+  int gapFindSplitLinprog(vector<int> &usedExits);
+  int minCostMilp(const vector<double> &addCost, double minGrowth, const vector<int> &startIds, vector<int> &onIds);
   vector<double> FBA_SOLVE();
   void FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage);
-  int FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage);
+  void FVA_SOLVE(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage, const vector<int> &rxnIds);
+  /* Solve the model once per set of bound overrides - see genericLinprog.cc */
+  void batchSolve(const vector<vector<BOUNDOVERRIDE> > &variants, vector<double> &objValues, vector<int> &statuses,
+		  vector<vector<double> > *fluxes = NULL);
+  /* Maximize each target reaction in turn in one LP - see genericLinprog.cc */
+  void objectiveSweep(const vector<int> &targetIds, bool closeOtherTargets, vector<double> &maxFlux, vector<int> &statuses,
+		      vector<vector<double> > *fluxes = NULL);
+  int FastFVA(vector<double> &minFlux, vector<double> &maxFlux, double optPercentage, const vector<int> &colIdx);
   void printPrivateStuff();
 
  private:
@@ -34,11 +105,19 @@ class GLPKDATA {
   double* lb;
   double* ub;
   int totalDataSize;
+  /* S matrix by column (see initialize) */
+  int* colStart;
   int* ia;
-  int* ja; 
   double* ar;
 
-  /* This is only temporary - I need it to help me debug this damned thing */
+  /* Reaction ID, RXN_* kind and name of each (zero-based) column */
+  vector<int> colIds;
+  vector<unsigned int> colKinds;
+  vector<NAMEREF> colNames;
+  /* Reaction ID --> column (filled the first time columnOfRxn needs it) */
+  map<int, int> colFromId;
+
+  /* Copies of the model for the debugging printouts - only made if _db.DEBUGFBA is on */
   RXNSPACE rxnsUsed;
   METSPACE metsUsed;
 
@@ -48,6 +127,10 @@ class GLPKDATA {
   int objSense; /* -1 = MIN, 1 = MAX */
 
   glp_prob* problem;
+  /* Solved copy of the problem that batchSolve and objectiveSweep warm-start from (NULL until one of them is used) */
+  glp_prob* batchBase;
+  /* Empty unless this was built from a COMPRESSEDMODEL */
+  FLUXEXPANSION expansion;
 
   /* I intentionally did not make a public version of this function - it is much less confusing to only have ONE place to change LB and UB
      and that is in the RXNSPACE itself. Just make a new GLPKDATA if you need to! */
@@ -57,11 +140,20 @@ class GLPKDATA {
   void validateSense(int sense);
   void initialize(const METSPACE &metspace, const RXNSPACE &rxnspace, vector<int> objId, vector<double> objCoeff, int sense);
   void setUpProblem();
+  void solveBatchBase();
+  int columnOfRxn(int rxnId, double &rxnFactor);
+  bool hasColumn(int rxnId);
+  void mapColumns();
+  void expandFlux(vector<double> &flux) const;
+  int inspectFvaSolution(vector<bool> &needMin, vector<bool> &needMax, vector<double> &minFlux, vector<double> &maxFlux);
+  static void setColumnBounds(glp_prob *lp, int col, double colLb, double colUb);
+  static int warmSolve(glp_prob *lp, int method);
+  /* Not allowed - use the copy constructor */
+  GLPKDATA& operator=(const GLPKDATA &rhs);
 
   void printGlpkError(int errorCode);
 
-  /* This has to be declared as static because we're making a function pointer to it and we can't have the address changing on us mid-program, can we? */
-  static int suppressGLPKOutput(void *info, const char *s);
+  static void milpCallback(glp_tree *tree, void *info);
 };
 
 #endif
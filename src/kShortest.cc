@@ -6,6 +6,7 @@
 #include "Printers.h"
 #include "RunK.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <omp.h>
 #include <queue>
@@ -17,21 +18,95 @@ using std::set;
 using std::queue;
 using std::vector;
 using std::map;
-using std::priority_queue;
+
+static bool lessLikelyGraph(const GRAPHSTORE &a, const GRAPHSTORE &b) {
+  return a.totalLikelihood < b.totalLikelihood;
+}
+
+/* Keep the memory used by a K-shortest query under _db.KSHORTEST_MAXQUEUE_MB. When the arena gets too big we first
+   drop everything that is no longer reachable from the queue, and if that isn't enough we also drop the least likely half of the queue. */
+static void capQueue(vector<GRAPHSTORE> &L, PATHARENA &arena) {
+  long int maxBytes = (long int)_db.KSHORTEST_MAXQUEUE_MB * 1024 * 1024;
+  if(arena.memoryUsed() <= maxBytes) { return; }
+  /* Compacting leaves L in the same (heap) order */
+  arena.compact(L);
+  if(arena.memoryUsed() <= maxBytes / 2) { return; }
+  int keep = L.size() / 2;
+  printf("WARNING: K-shortest candidate queue went over %d MB - dropping the %d least likely candidates\n", 
+	 _db.KSHORTEST_MAXQUEUE_MB, (int)L.size() - keep);
+  std::nth_element(L.begin(), L.begin() + keep, L.end(), lessLikelyGraph);
+  L.resize(keep);
+  arena.compact(L);
+  std::make_heap(L.begin(), L.end());
+}
+
+/* The landmark table only depends on the network, so build it once for all the outputs of a multi-output query */
+static void multiOutputLandmarks(RXNSPACE &rxnspace, METSPACE &metspace, LANDMARKS &landmarks) {
+  calcMetRxnRelations_nosec(rxnspace, metspace);
+  rxnspace.syncAttributes();
+  buildLandmarks(rxnspace, metspace, _db.NUM_LANDMARKS, landmarks);
+}
+
+/* Lower bounds on the cost of getting from each metabolite to output. Excluding reactions only makes paths longer, so
+   bounds for the whole network stay valid for every spur search. Uses the landmark table shared by a multi-output query
+   if there is one, and otherwise one backward search from the output, which gives the exact split-graph distances.
+   Returns NULL if NUM_LANDMARKS is 0 (no goal direction) */
+static const vector<double>* goalBounds(const RXNSPACE &rxnspace, const METSPACE &metspace, const METABOLITE &output,
+					const LANDMARKS *landmarks, vector<double> &bounds) {
+  int outputIdx = metspace.idxFromId(output.id);
+  if(_db.NUM_LANDMARKS <= 0) { return NULL; }
+  if(landmarks == NULL) {
+    SPLITGRAPH forward, backward;
+    splitGraph(rxnspace, metspace, forward, backward);
+    simpleDistances(backward, outputIdx, bounds);
+    return &bounds;
+  }
+  if(landmarks->empty()) { return NULL; }
+  landmarks->boundsTo(outputIdx, bounds);
+  return &bounds;
+}
+
+/* Spur paths for every reaction in currentRxnList, SPUR_LANES at a time (see batchShortestPaths). rxnspace has the
+   exclusions of the graph they branch from applied and is only read */
+static void batchSpurPaths(const HYPERCSR &graph, const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs,
+			   const METABOLITE &output, const vector<int> &currentRxnList, const vector<double> *bounds, vector<PATH> &spurPaths) {
+  int numBatches = (currentRxnList.size() + SPUR_LANES - 1) / SPUR_LANES;
+#pragma omp parallel for
+  for(int b=0; b<numBatches; b++) {
+    int first = b * SPUR_LANES;
+    int last = std::min((int)currentRxnList.size(), first + SPUR_LANES);
+    vector<int> lanes(currentRxnList.begin() + first, currentRxnList.begin() + last);
+    vector<PATH> lanePaths;
+    batchShortestPaths(graph, rxnspace, metspace, inputs, output, lanes, lanePaths, bounds);
+    for(int l=0; l<lanePaths.size(); l++) { spurPaths[first + l] = lanePaths[l]; }
+  }
+}
 
 /* This version of kShortest is made for the reversibility check in SecondKPass when we are trying to close
    gaps that cannot be closed without altering a reaction. NOTE: It is almost never a good idea to copy large
    chunks of code like this just to change a few lines, but this helps me avoid breaking anything while I
    figure this out. --NICK */
 void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, METABOLITE output, int K,
-		RXNSPACE &truedir) {
+		RXNSPACE &truedir, const LANDMARKS *landmarks) {
 
-  priority_queue<GRAPHSTORE> L;
-  GRAPHSTORE tmp;
+  /* Candidate queue (a heap ordered by GRAPHSTORE::operator<, exactly as priority_queue would keep it) */
+  vector<GRAPHSTORE> L;
+  /* Every candidate path and exclusion list for this query lives here - all of it is freed at once when we return */
+  PATHARENA arena;
   calcMetRxnRelations_nosec(rxnspace, metspace);
+  /* Callers often adjust likelihoods directly in rxns - make sure Dijkstras sees those costs */
+  rxnspace.syncAttributes();
+  /* Lower bounds for the spur searches */
+  vector<double> bounds;
+  const vector<double> *boundsPtr = goalBounds(rxnspace, metspace, output, landmarks, bounds);
+  /* Big networks get their first path from a search that uses all the threads (there is only one search to do) */
+  bool parallelFirst = (omp_get_max_threads() > 1 && rxnspace.rxns.size() >= _db.PARALLEL_SEARCH_MIN_RXNS);
+  HYPERCSR spurGraph;
+  if(_db.BATCH_SPURS || parallelFirst) { buildHyperCsr(rxnspace, metspace, spurGraph); }
 
   set<BADIDSTORE> badIds;
-  PATH onePath = findShortestPath(rxnspace, metspace, inputs, output, badIds);
+  PATH onePath = parallelFirst ? parallelShortestPath(spurGraph, rxnspace, metspace, inputs, output)
+    : findShortestPath(rxnspace, metspace, inputs, output, badIds);
   vector<PATH> tmpPath;
   tmpPath.push_back(onePath);
 
@@ -39,10 +114,16 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
   PATH badPath;
 
   /* Since this is the first one we leave the excluded reactions empty */
-  tmp.path = onePath;
-  L.push(tmp);
+  L.push_back(arena.addGraph(arena.addPath(onePath)));
 
   vector<int> previousGraphRxns;
+  /* Scratch copies out of the arena (reused between iterations so they stop allocating once they are big enough) */
+  vector<int> currentRxnList;
+  vector<int> excludedRxnIds;
+  vector<PATH> spurPaths;
+  /* One working copy of the reactions per thread for the whole query (instead of copying rxnspace on every iteration).
+     The batched spur search only reads the first one, so it gets just that */
+  vector<RXNSPACE> threadRxns(_db.BATCH_SPURS ? 1 : omp_get_max_threads(), rxnspace);
 
   while(true) {
 
@@ -51,8 +132,10 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
       return;
     }
 
-    GRAPHSTORE currentGraph = L.top(); /* Note - automatically takes out the shortest one */
-    L.pop();
+    GRAPHSTORE currentGraph = L.front(); /* Note - automatically takes out the shortest one */
+    std::pop_heap(L.begin(), L.end());
+    L.pop_back();
+    arena.getRxnIds(currentGraph.pathIdx, currentRxnList);
 
     /* Test if the current graph is the same as the previous best. If it is, just skip it because we already
        found all the subgraphs for that, and we don't want repeat solutions...
@@ -70,10 +153,10 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
      */
     
     bool toSkip;
-    if(previousGraphRxns.size() == currentGraph.path.rxnIds.size()) {
+    if(previousGraphRxns.size() == currentRxnList.size()) {
       toSkip = true;
       for(int i=0; i<previousGraphRxns.size(); i++) {
-	if(previousGraphRxns[i]!=currentGraph.path.rxnIds[i]) {
+	if(previousGraphRxns[i]!=currentRxnList[i]) {
 	  toSkip = false;
 	  break;
 	}
@@ -86,7 +169,7 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
 
     /* Now that it passed our sanity check, lets consider it our next optimum and then find all the subgraphs again like before */
 
-    result.push_back(currentGraph.path);
+    result.push_back(arena.getPath(currentGraph.pathIdx));
     currentK++;
 
   dontsave:
@@ -96,50 +179,66 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
     /* No more graphs to check (meaning the total number of shortest paths is less than K) */
     if(_db.DEBUGPATHS) { printf("Working on the %dth shortest...\n", currentK + 1); }
 
-    vector<int> &currentRxnList = currentGraph.path.rxnIds;
-    vector<int> &excludedRxnIds = currentGraph.excludedRxnIds;
+    arena.getExcluded(currentGraph, excludedRxnIds);
 
-    /* Set all of the specified reactions to not be included */
-    for(int i=0; i<excludedRxnIds.size();i++) {
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->old_likelihood = rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood;
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood = -1;
+    /* Set all of the specified reactions to not be included (in every working copy - rxnspace itself
+       keeps the original likelihoods so we can put them back) */
+    for(int t=0; t<threadRxns.size(); t++) {
+      for(int i=0; i<excludedRxnIds.size();i++) {
+	threadRxns[t].changeLikelihood(excludedRxnIds[i], -1);
+      }
     }
 
     /* Compute shortest paths for next iteration */
-    tmp = currentGraph;
-    /* Not allowed to save a reference as PRIVATE so I have to do this: */
-    RXNSPACE tmpRxn = rxnspace;
-
-    vector<GRAPHSTORE> temporaryList(currentRxnList.size(), currentGraph);
 
-#pragma omp parallel for shared(L, currentRxnList, temporaryList) firstprivate(tmp, onePath, tmpRxn)
-    for(int i=0; i<currentRxnList.size();i++) {
+    vector<int> currentDirection;
+    arena.getRxnDirection(currentGraph.pathIdx, currentDirection);
+    spurPaths.resize(currentRxnList.size());
+    /* Complete labels for the current graph (all the spurs differ from it by one reaction) - only for the legacy
+       INCREMENTAL_SPURS mode, the batched search doesn't use them */
+    SSSPSTATE parentState;
+    if(_db.INCREMENTAL_SPURS && !_db.BATCH_SPURS) {
       set<BADIDSTORE> dum;
-      int dir = truedir.rxnFromId(currentRxnList[i]).net_reversible;
-      if(dir!=tmp.path.rxnDirection[i] || 1){
-	tmp.excludedRxnIds.push_back(currentRxnList[i]);
-	tmpRxn.rxnPtrFromId(currentRxnList[i])->old_likelihood = tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood;
-	tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood = -1;
-	tmp.path = findShortestPath(tmpRxn, metspace, inputs, output, dum);
+      findShortestPath(threadRxns[0], metspace, inputs, output, dum, &parentState);
+    }
+
+    if(_db.BATCH_SPURS) {
+      batchSpurPaths(spurGraph, threadRxns[0], metspace, inputs, output, currentRxnList, boundsPtr, spurPaths);
+    } else {
+#pragma omp parallel for shared(currentRxnList, currentDirection, spurPaths, threadRxns, parentState)
+      for(int i=0; i<currentRxnList.size();i++) {
+	set<BADIDSTORE> dum;
+	RXNSPACE &tmpRxn = threadRxns[omp_get_thread_num()];
+	int dir = truedir.rxnFromId(currentRxnList[i]).net_reversible;
+	if(dir!=currentDirection[i] || 1){
+	  tmpRxn.changeLikelihood(currentRxnList[i], -1);
+	  if(_db.INCREMENTAL_SPURS) {
+	    spurPaths[i] = repairShortestPath(tmpRxn, metspace, output, parentState, currentRxnList[i], boundsPtr);
+	  } else {
+	    spurPaths[i] = findShortestPath(tmpRxn, metspace, inputs, output, dum, NULL, boundsPtr);
+	  }
+	  tmpRxn.changeLikelihood(currentRxnList[i], rxnspace.rxnFromId(currentRxnList[i]).current_likelihood);
+	}
+	else{
+	  spurPaths[i] = badPath;
+	}	
       }
-      else{
-	tmp.path = badPath;
-      }	
-      temporaryList[i] = tmp;
-      tmp.excludedRxnIds.pop_back();
-      tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood = tmpRxn.rxnPtrFromId(currentRxnList[i])->old_likelihood;
     }
 
-    for(int i=0; i<temporaryList.size(); i++) {
-      L.push(temporaryList[i]);
+    for(int i=0; i<spurPaths.size(); i++) {
+      L.push_back(arena.addGraph(arena.addPath(spurPaths[i]), currentGraph, currentRxnList[i]));
+      std::push_heap(L.begin(), L.end());
     }
 
     /* Reset excluded reactions for the next run */
-    for(int i=0; i < excludedRxnIds.size();i++) {
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood = rxnspace.rxnPtrFromId(excludedRxnIds[i])->old_likelihood;
+    for(int t=0; t<threadRxns.size(); t++) {
+      for(int i=0; i < excludedRxnIds.size();i++) {
+	threadRxns[t].changeLikelihood(excludedRxnIds[i], rxnspace.rxnFromId(excludedRxnIds[i]).current_likelihood);
+      }
     }
 
-    previousGraphRxns = currentGraph.path.rxnIds;
+    capQueue(L, arena);
+    previousGraphRxns = currentRxnList;
     
   } /* Until the end...... */
 
@@ -149,9 +248,11 @@ void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, ME
 void kShortest2(vector<vector<PATH> > &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, METSPACE &outputs, int K,
 	       RXNSPACE &truedir) {
   result.clear();
+  LANDMARKS landmarks;
+  multiOutputLandmarks(rxnspace, metspace, landmarks);
   for(int i=0; i<outputs.mets.size(); i++) {
     vector<PATH> tmpRes;
-    kShortest2(tmpRes, rxnspace, metspace, inputs, outputs.mets[i], K, truedir);
+    kShortest2(tmpRes, rxnspace, metspace, inputs, outputs.mets[i], K, truedir, &landmarks);
     result.push_back(tmpRes);
   }
 }
@@ -159,30 +260,51 @@ void kShortest2(vector<vector<PATH> > &result, RXNSPACE &rxnspace, METSPACE &met
 /* K-shortest on multiple outputs */
 void kShortest(vector<vector<PATH> > &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, METSPACE &outputs, int K) {
   result.clear();
+  LANDMARKS landmarks;
+  multiOutputLandmarks(rxnspace, metspace, landmarks);
   for(int i=0; i<outputs.mets.size(); i++) {
     vector<PATH> tmpRes;
-    kShortest(tmpRes, rxnspace, metspace, inputs, outputs.mets[i], K);
+    kShortest(tmpRes, rxnspace, metspace, inputs, outputs.mets[i], K, &landmarks);
     result.push_back(tmpRes);
   }
 }
 
-void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, METABOLITE output, int K) {
+void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, METABOLITE output, int K,
+	       const LANDMARKS *landmarks) {
 
   set<BADIDSTORE> badIds;
-  priority_queue<GRAPHSTORE> L;
-  GRAPHSTORE tmp;
+  /* Candidate queue (a heap ordered by GRAPHSTORE::operator<, exactly as priority_queue would keep it) */
+  vector<GRAPHSTORE> L;
+  /* Every candidate path and exclusion list for this query lives here - all of it is freed at once when we return */
+  PATHARENA arena;
   calcMetRxnRelations_nosec(rxnspace, metspace);
+  /* Callers often adjust likelihoods directly in rxns - make sure Dijkstras sees those costs */
+  rxnspace.syncAttributes();
+  /* Lower bounds for the spur searches */
+  vector<double> bounds;
+  const vector<double> *boundsPtr = goalBounds(rxnspace, metspace, output, landmarks, bounds);
+  /* Big networks get their first path from a search that uses all the threads (there is only one search to do) */
+  bool parallelFirst = (omp_get_max_threads() > 1 && rxnspace.rxns.size() >= _db.PARALLEL_SEARCH_MIN_RXNS);
+  HYPERCSR spurGraph;
+  if(_db.BATCH_SPURS || parallelFirst) { buildHyperCsr(rxnspace, metspace, spurGraph); }
 
   /* The badIds will be the same all the time if they are needed [to troubleshoot no path
-     found instances] so we only save the results of the first one (K=1) */
-  PATH onePath = findShortestPath(rxnspace, metspace, inputs, output, badIds);
+     found instances] so we only save the results of the first one (K=1) - not kept by the parallel search */
+  PATH onePath = parallelFirst ? parallelShortestPath(spurGraph, rxnspace, metspace, inputs, output)
+    : findShortestPath(rxnspace, metspace, inputs, output, badIds);
   int currentK = 0;
 
   /* Since this is the first one we leave the excluded reactions empty */
-  tmp.path = onePath;
-  L.push(tmp);
+  L.push_back(arena.addGraph(arena.addPath(onePath)));
 
   vector<int> previousGraphRxns;
+  /* Scratch copies out of the arena (reused between iterations so they stop allocating once they are big enough) */
+  vector<int> currentRxnList;
+  vector<int> excludedRxnIds;
+  vector<PATH> spurPaths;
+  /* One working copy of the reactions per thread for the whole query (instead of copying rxnspace on every iteration).
+     The batched spur search only reads the first one, so it gets just that */
+  vector<RXNSPACE> threadRxns(_db.BATCH_SPURS ? 1 : omp_get_max_threads(), rxnspace);
 
   while(true) {
 
@@ -191,8 +313,10 @@ void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, MET
       return;
     }
 
-    GRAPHSTORE currentGraph = L.top(); /* Note - automatically takes out the shortest one */
-    L.pop();
+    GRAPHSTORE currentGraph = L.front(); /* Note - automatically takes out the shortest one */
+    std::pop_heap(L.begin(), L.end());
+    L.pop_back();
+    arena.getRxnIds(currentGraph.pathIdx, currentRxnList);
 
     /* Test if the current graph is the same as the previous best. If it is, just skip it because we already
        found all the subgraphs for that, and we don't want repeat solutions...
@@ -202,10 +326,10 @@ void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, MET
        optimal away to get around them in either case. */
     
     bool toSkip;
-    if(previousGraphRxns.size() == currentGraph.path.rxnIds.size()) {
+    if(previousGraphRxns.size() == currentRxnList.size()) {
       toSkip = true;
       for(int i=0; i<previousGraphRxns.size(); i++) {
-	if(previousGraphRxns[i]!=currentGraph.path.rxnIds[i]) {
+	if(previousGraphRxns[i]!=currentRxnList[i]) {
 	  toSkip = false;
 	  break;
 	}
@@ -216,7 +340,7 @@ void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, MET
     if(toSkip) { goto dontsave; }
     
     /* Now that it passed our sanity check, lets consider it our next optimum and then find all the subgraphs again like before */
-    result.push_back(currentGraph.path);
+    result.push_back(arena.getPath(currentGraph.pathIdx));
     currentK++;
 
   dontsave:
@@ -226,45 +350,61 @@ void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, MET
     /* No more graphs to check (meaning the total number of shortest paths is less than K) */
     //printf("Working on the %dth shortest...\n", currentK + 1);
 
-    vector<int> &currentRxnList = currentGraph.path.rxnIds;
-    vector<int> &excludedRxnIds = currentGraph.excludedRxnIds;
+    arena.getExcluded(currentGraph, excludedRxnIds);
 
-    /* Set all of the specified reactions to not be included */
-    for(int i=0; i<excludedRxnIds.size();i++) {
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->old_likelihood = rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood;
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood = -1;
+    /* Set all of the specified reactions to not be included (in every working copy - rxnspace itself
+       keeps the original likelihoods so we can put them back) */
+    for(int t=0; t<threadRxns.size(); t++) {
+      for(int i=0; i<excludedRxnIds.size();i++) {
+	threadRxns[t].changeLikelihood(excludedRxnIds[i], -1);
+      }
     }
 
     /* Compute shortest paths for next iteration */
-    tmp = currentGraph;
-    /* Not allowed to save a reference as PRIVATE so I have to do this: */
-    RXNSPACE tmpRxn = rxnspace;
 
-    vector<GRAPHSTORE> temporaryList(currentRxnList.size(), currentGraph);
-
-    #pragma omp parallel for shared(L, currentRxnList, temporaryList) firstprivate(tmp, onePath, tmpRxn)
-    for(int i=0; i<currentRxnList.size();i++) {
+    spurPaths.resize(currentRxnList.size());
+    /* Complete labels for the current graph (all the spurs differ from it by one reaction) - only for the legacy
+       INCREMENTAL_SPURS mode, the batched search doesn't use them */
+    SSSPSTATE parentState;
+    if(_db.INCREMENTAL_SPURS && !_db.BATCH_SPURS) {
       set<BADIDSTORE> dum;
-      tmp.excludedRxnIds.push_back(currentRxnList[i]);
-      tmpRxn.rxnPtrFromId(currentRxnList[i])->old_likelihood = tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood;
-      tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood = -1;
-      tmp.path = findShortestPath(tmpRxn, metspace, inputs, output, dum);
-      temporaryList[i] = tmp;
-      tmp.excludedRxnIds.pop_back();
-      tmpRxn.rxnPtrFromId(currentRxnList[i])->current_likelihood = tmpRxn.rxnPtrFromId(currentRxnList[i])->old_likelihood;
+      findShortestPath(threadRxns[0], metspace, inputs, output, dum, &parentState);
+    }
+
+    if(_db.BATCH_SPURS) {
+      batchSpurPaths(spurGraph, threadRxns[0], metspace, inputs, output, currentRxnList, boundsPtr, spurPaths);
+    } else {
+      #pragma omp parallel for shared(currentRxnList, spurPaths, threadRxns, parentState)
+      for(int i=0; i<currentRxnList.size();i++) {
+	set<BADIDSTORE> dum;
+	RXNSPACE &tmpRxn = threadRxns[omp_get_thread_num()];
+	tmpRxn.changeLikelihood(currentRxnList[i], -1);
+	if(_db.INCREMENTAL_SPURS) {
+	  spurPaths[i] = repairShortestPath(tmpRxn, metspace, output, parentState, currentRxnList[i], boundsPtr);
+	} else {
+	  spurPaths[i] = findShortestPath(tmpRxn, metspace, inputs, output, dum, NULL, boundsPtr);
+	}
+	tmpRxn.changeLikelihood(currentRxnList[i], rxnspace.rxnFromId(currentRxnList[i]).current_likelihood);
+      }
     }
 
-    for(int i=0; i<temporaryList.size(); i++) {
-      if(!(temporaryList[i].path.outputId==-1)) {	L.push(temporaryList[i]);
+    /* Candidates go into the arena serially and in the same order as before, so ties in the queue come out the same way */
+    for(int i=0; i<spurPaths.size(); i++) {
+      if(!(spurPaths[i].outputId==-1)) {
+	L.push_back(arena.addGraph(arena.addPath(spurPaths[i]), currentGraph, currentRxnList[i]));
+	std::push_heap(L.begin(), L.end());
       }
     }
 
     /* Reset excluded reactions for the next run */
-    for(int i=0; i < excludedRxnIds.size();i++) {
-      rxnspace.rxnPtrFromId(excludedRxnIds[i])->current_likelihood = rxnspace.rxnPtrFromId(excludedRxnIds[i])->old_likelihood;
+    for(int t=0; t<threadRxns.size(); t++) {
+      for(int i=0; i < excludedRxnIds.size();i++) {
+	threadRxns[t].changeLikelihood(excludedRxnIds[i], rxnspace.rxnFromId(excludedRxnIds[i]).current_likelihood);
+      }
     }
 
-    previousGraphRxns = currentGraph.path.rxnIds;
+    capQueue(L, arena);
+    previousGraphRxns = currentRxnList;
     
   } /* Until the end...... */
 
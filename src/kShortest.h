@@ -11,9 +11,9 @@
 void kShortest(vector<vector<PATH> > &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, 
 	       METSPACE &outputs, int K);
 void kShortest(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, 
-	       METABOLITE output, int K);
+	       METABOLITE output, int K, const LANDMARKS *landmarks = NULL);
 void kShortest2(vector<vector<PATH> > &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, 
 	        METSPACE &outputs, int K, RXNSPACE &truedir);
 void kShortest2(vector<PATH> &result, RXNSPACE &rxnspace, METSPACE &metspace, METSPACE &inputs, 
-	        METABOLITE output, int K, RXNSPACE &truedir);
+	        METABOLITE output, int K, RXNSPACE &truedir, const LANDMARKS *landmarks = NULL);
 #endif
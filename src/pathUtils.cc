@@ -99,10 +99,13 @@ int instoich(int id, const vector<STOICH> &list){
   return -1;
 }
 
-/* Convert a metabolite name to an ID. Returns -1 on failure */
+/* Convert a metabolite name to an ID. Returns -1 on failure
+   (names are interned so comparing the handles is enough) */
 int Name2Ids(const vector<METABOLITE> &metabolite, const char *met_name){
+  STRINGID nameId = findInternedString(met_name);
+  if(nameId == 0) { return -1; }
   for(int i=0;i<metabolite.size();i++){
-    if(strcmp(met_name,metabolite[i].name)==0){
+    if(metabolite[i].name.id() == nameId){
       return metabolite[i].id;
     }
   }
@@ -110,36 +113,38 @@ int Name2Ids(const vector<METABOLITE> &metabolite, const char *met_name){
 }
 
 int Name2Ids(const vector<REACTION> &reaction, const char *rxn_name) {
+  STRINGID nameId = findInternedString(rxn_name);
+  if(nameId == 0) { return -1; }
   for(int i=0;i<reaction.size();i++){
-    if(strcmp(rxn_name,reaction[i].name)==0){
+    if(reaction[i].name.id() == nameId){
       return reaction[i].id;
     }
   }
   return -1;
 }
 
-/* 0 means they are different and 1 means they are the same (based on stoich_part) - used to synonymize */
+/* 0 means they are different and 1 means they are the same (secondaries excluded) - used to synonymize */
 int diff2rxns(const REACTION &one, const REACTION &two){
   /* Check sizes */
-  int one_stoich_size = one.stoich_part.size();
-  int two_stoich_size = two.stoich_part.size();
+  int one_stoich_size(0), two_stoich_size(0);
+  for(int i=0;i<one.stoich.size();i++){ if(!one.stoich[i].secondary) { one_stoich_size++; } }
+  for(int i=0;i<two.stoich.size();i++){ if(!two.stoich[i].secondary) { two_stoich_size++; } }
   if(one_stoich_size==0 || two_stoich_size == 0){ return 0;}
   if(one_stoich_size!=two_stoich_size){ return 0;}
-  int i,j,k[one_stoich_size];
-  /* If metabolites not the same, return difference mark (0) */
-  for(i=0;i<one.stoich_part.size();i++){
-    k[i] = instoich(one.stoich_part[i].met_id,two.stoich_part);
-    if(k[i]==-1){return 0;}
-  }
-  /* Make sure reactions have same ratio of reactants */
-  double kk[one_stoich_size];
-  for(i=0;i<one_stoich_size;i++){
-    kk[i] = (double)one.stoich_part[i].rxn_coeff/(double)two.stoich_part[k[i]].rxn_coeff;
-  }
-  double ul = kk[0] + 0.1;
-  double ll = kk[0] - 0.1;
-  for(i=0;i<one_stoich_size;i++){
-    if(kk[i]>ul || kk[i]<ll){ return 0;}
+  /* If metabolites not the same, return difference mark (0). 
+     Otherwise make sure reactions have same ratio of reactants */
+  bool first(true);
+  double ul(0.0f), ll(0.0f);
+  for(int i=0;i<one.stoich.size();i++){
+    if(one.stoich[i].secondary) { continue; }
+    int k(-1);
+    for(int j=0;j<two.stoich.size();j++){
+      if(!two.stoich[j].secondary && two.stoich[j].met_id == one.stoich[i].met_id) { k = j; break; }
+    }
+    if(k==-1){return 0;}
+    double kk = (double)one.stoich[i].rxn_coeff/(double)two.stoich[k].rxn_coeff;
+    if(first) { ul = kk + 0.1; ll = kk - 0.1; first = false; }
+    if(kk>ul || kk<ll){ return 0;}
   }
   return 1;
 }
@@ -192,8 +197,8 @@ void pullOutMets(const RXNSPACE &rxnspace, const METSPACE &metspace, METSPACE &r
   return;
 }
 
-/* Based on cofactors removed from reactions in ProblemSpace.fullrxns (and placed in stoich_part)
-   make a list of synonymous reactinos and dump it to ProblemSpace.synrxns (in stoich_part). */
+/* Based on cofactors flagged as secondary in reactions in ProblemSpace.fullrxns
+   make a list of synonymous reactinos and dump it to ProblemSpace.synrxns. */
 
 void MakeSynList(PROBLEM &ProblemSpace){
 
@@ -255,11 +260,11 @@ void MakeSynList(PROBLEM &ProblemSpace){
       }
 
       REACTION firstSyn = fullspace.rxnFromId(synspace.rxns[i].syn[0]);
-      synspace.rxns[i].stoich_part = firstSyn.stoich_part;
+      vector<STOICH> firstPart = firstSyn.stoichPart();
 
       /* Merge Reversibilities */
-      int firstMetId = firstSyn.stoich_part[0].met_id;
-      double firstCoeff = firstSyn.stoich_part[0].rxn_coeff;
+      int firstMetId = firstPart[0].met_id;
+      double firstCoeff = firstPart[0].rxn_coeff;
       int sgn;
       /* Technically it could be 0 too but we don't care, because that means net_reversible is 0 and we'll make the rev 0 by default */
       if(firstCoeff * (double)firstSyn.net_reversible < 0.0f) { sgn = -1; } else { sgn = 1; }
@@ -271,9 +276,10 @@ void MakeSynList(PROBLEM &ProblemSpace){
 
 	int curRev = curRxn.net_reversible;
 	double curCoeff;
-	for(int k=0; k<curRxn.stoich_part.size(); k++) {
-	  if(curRxn.stoich_part[k].met_id == firstMetId) { 
-	    curCoeff = curRxn.stoich_part[k].rxn_coeff;
+	for(int k=0; k<curRxn.stoich.size(); k++) {
+	  if(curRxn.stoich[k].secondary) { continue; }
+	  if(curRxn.stoich[k].met_id == firstMetId) { 
+	    curCoeff = curRxn.stoich[k].rxn_coeff;
 	    break;
 	  }
 	}
@@ -299,9 +305,10 @@ void getProducts(const REACTION &rxn, int reactantId, vector<int> &res) {
   int sgn(0);
   unsigned int i;
   bool productPresent = false;
-  for(i=0;i<rxn.stoich_part.size();i++) 	{
-    if(rxn.stoich_part[i].met_id == reactantId)  {
-      if(rxn.stoich_part[i].rxn_coeff < 0)
+  for(i=0;i<rxn.stoich.size();i++) 	{
+    if(rxn.stoich[i].secondary) { continue; }
+    if(rxn.stoich[i].met_id == reactantId)  {
+      if(rxn.stoich[i].rxn_coeff < 0)
 	{ sgn = -1; }
       else { sgn = 1; }
       /* Test reversibility -use net_reversible to account for changes due to the algorithm */
@@ -325,9 +332,10 @@ void getProducts(const REACTION &rxn, int reactantId, vector<int> &res) {
   if(!productPresent) {return;}
   
   /* Get and return objects with sign opposite of sgn (i.e. if sgn*coeff < 0) */
-  for(i=0;i<rxn.stoich_part.size();i++) {
-    if( (rxn.stoich_part[i].rxn_coeff * sgn) < 0 ) {
-      res.push_back(rxn.stoich_part[i].met_id);
+  for(i=0;i<rxn.stoich.size();i++) {
+    if(rxn.stoich[i].secondary) { continue; }
+    if( (rxn.stoich[i].rxn_coeff * sgn) < 0 ) {
+      res.push_back(rxn.stoich[i].met_id);
     }
   }
   return;
@@ -383,7 +391,7 @@ int rougheq(const double one, const double two, const double constant){
 /* Returns the stoichiometric coefficient of a reaction given the reaction ID and met ID you want 
  Returns 0.0f if the metabolite is not in the reaction 
 
-Looks for the metabolite in stoich, not stoich_part */
+Looks for the metabolite in all of stoich (secondaries included) */
 double rxnCoeff(const RXNSPACE &rxnspace, int rxnId, int metId) {
   REACTION rxn = rxnspace.rxnFromId(rxnId);
   for(int i=0; i<rxn.stoich.size(); i++) {
@@ -406,7 +414,7 @@ vector<int> getAllSecondaryIds(const PROBLEM &ProblemSpace) {
 }
 
 /* whichOne = 1 --> fullrxns (stoich)
-   whichOne = 2 --> synrxns (stoich_part) */
+   whichOne = 2 --> synrxns (stoich without secondaries) */
 vector<int> getAllPathMets(const vector<PATHSUMMARY> &pList, const PROBLEM &problemSpace, int whichOne) {
   vector<int> metList;
   for(int i=0; i<pList.size(); i++) {
@@ -421,7 +429,8 @@ vector<int> getAllPathMets(const vector<PATHSUMMARY> &pList, const PROBLEM &prob
 	break;
       case 2:
 	tmpRxn = problemSpace.synrxns.rxnFromId(abs(pList[i].rxnDirIds[j]));
-	for(int k=0; k<tmpRxn.stoich_part.size(); k++) {
+	for(int k=0; k<tmpRxn.stoich.size(); k++) {
+	  if(tmpRxn.stoich[k].secondary) { continue; }
 	  metList.push_back(tmpRxn.stoich[k].met_id);
 	}
 	break;
@@ -446,14 +455,16 @@ vector<int> getAllPathRxns(const vector<PATHSUMMARY> &pList) {
 
 
 void turnOffMagicExits(RXNSPACE &rxnspace, const vector<int> &exitsToKeep) {
-  for(int i=0; i<rxnspace.rxns.size(); i++) {
-    if(rxnspace.rxns[i].id < _db.BLACKMAGICFACTOR || rxnspace.rxns[i].id >= _db.BLACKMAGICFACTOR + _db.MINFACTORSPACING) { continue; }
+  const vector<int> &exitIdx = rxnspace.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<exitIdx.size(); i++) {
+    REACTION &exit = rxnspace.rxns[exitIdx[i]];
     bool keep = false;
     for(int j=0; j<exitsToKeep.size(); j++) {
-      if(exitsToKeep[j] == rxnspace.rxns[i].id) { keep = true; break; }
+      if(exitsToKeep[j] == exit.id) { keep = true; break; }
     }
-    if(!keep) { rxnspace.rxns[i].lb = 0.0f; rxnspace.rxns[i].ub = 0.0f; }
+    if(!keep) { exit.lb = 0.0f; exit.ub = 0.0f; }
   }
+  rxnspace.syncAttributes();
 }
 
 /* Modify the NGAM associated with the model PROBLEM
@@ -467,6 +478,7 @@ void modifyNGAM(ANSWER &model, double newAtpm) {
   }
   model.reactions.rxnPtrFromId(atpmId)->lb = newAtpm;
   model.reactions.rxnPtrFromId(atpmId)->ub = newAtpm;
+  model.reactions.syncAttributes();
 }
 
 /* Modify the growth-associated maintenance by changing the amount of ATP, ADP, H2O, Pi, and H                                                                                                                 
@@ -18,17 +18,24 @@
 
 using namespace std;
 
-ANSWER overwriteRXNS(vector<REACTION> &ETC_adjusted, const ANSWER &ans){
-  ANSWER result(ans);
+/* Write the stoichiometry of each reaction in ETC_adjusted into rxns IN PLACE (the replaced stoichiometries
+   are saved so that restoreRXNS can put them back) */
+void overwriteRXNS(const vector<REACTION> &ETC_adjusted, RXNSPACE &rxns, vector<vector<STOICH> > &saved){
+  saved.clear();
   for(int i=0;i<ETC_adjusted.size();i++){
-    int rxn_idx = result.reactions.idxFromId(ETC_adjusted[i].id);
-    REACTION &rxn_ptr = result.reactions.rxns[rxn_idx];
-    assert(ETC_adjusted[i].stoich.size()==rxn_ptr.stoich.size());
-    for(int j=0;j<rxn_ptr.stoich.size();j++){
-      rxn_ptr.stoich[j] = ETC_adjusted[i].stoich[j];
-    }
+    const REACTION &rxn = rxns.rxnFromId(ETC_adjusted[i].id);
+    assert(ETC_adjusted[i].stoich.size()==rxn.stoich.size());
+    saved.push_back(rxn.stoich);
+    rxns.changeStoich(ETC_adjusted[i].id, ETC_adjusted[i].stoich);
   } 
-  return result;
+}
+
+/* Undo overwriteRXNS (backwards, in case ETC_adjusted names the same reaction twice) */
+void restoreRXNS(const vector<REACTION> &ETC_adjusted, RXNSPACE &rxns, const vector<vector<STOICH> > &saved){
+  assert(saved.size()==ETC_adjusted.size());
+  for(int i=(int)ETC_adjusted.size()-1;i>=0;i--){
+    rxns.changeStoich(ETC_adjusted[i].id, saved[i]);
+  }
 }
 
 map<int,double> getSecretionRates(const ANSWER &ans1, const GROWTH &growth1, 
@@ -38,7 +45,7 @@ map<int,double> getSecretionRates(const ANSWER &ans1, const GROWTH &growth1,
   //indexed by the order they appear in growth
   for(int i=0;i<growth1.byproduct.size();i++){
     int met_id = growth1.byproduct[i].id;
-    int rxn_id = FindExchange4Metabolite(ans1.reactions.rxns,met_id);
+    int rxn_id = FindExchange4Metabolite(ans1.reactions,met_id);
     int rxn_idx= ans1.reactions.idxFromId(rxn_id);
     result[met_id] = fba_solution[rxn_idx];
   }
@@ -102,12 +109,15 @@ double measureScore(SCORE1 &score1,vector<ANSWER> &ans, vector<GROWTH> &growth){
     
     vector<vector<double> > sim_growth_rates, exp_growth_rates;
     vector<double> scores;
+    /* Nothing in the model depends on j, so solve once with the ETC adjustments swapped in and put
+       the original stoichiometries back straight afterwards */
+    vector<vector<STOICH> > savedStoich;
+    overwriteRXNS(score1.ETC_adjusted, ans[i].reactions, savedStoich);
+    vector<double> g = FBA_SOLVE(ans[i].reactions, ans[i].metabolites);
+    restoreRXNS(score1.ETC_adjusted, ans[i].reactions, savedStoich);
+    const ANSWER &temp_ans = ans[i];
     //load the sim vs exp data
     for(int j=0;j<growth.size();j++){
-      //printf("overwriting reactions\n");
-      ANSWER temp_ans = overwriteRXNS(score1.ETC_adjusted, ans[i]);
-      // printf("FBA solving\n");
-      vector<double> g = FBA_SOLVE(temp_ans.reactions, temp_ans.metabolites);
       //growth rate
       score1.growthRate[j] = g[temp_ans.reactions.idxFromId(_db.BIOMASS)];
       //printf("Growth Rate: %f\n",g[0]);
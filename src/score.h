@@ -8,7 +8,8 @@
 using std::vector;
 using std::map;
 
-ANSWER overwriteRXNS(vector<REACTION> &ETC_adjusted, const ANSWER &ans);
+void overwriteRXNS(const vector<REACTION> &ETC_adjusted, RXNSPACE &rxns, vector<vector<STOICH> > &saved);
+void restoreRXNS(const vector<REACTION> &ETC_adjusted, RXNSPACE &rxns, const vector<vector<STOICH> > &saved);
 map<int,double> getSecretionRates(const ANSWER &ans1, const GROWTH &growth1,
 				  const vector<double> &fba_solution);
 double evalProtocal1(const vector<double> sim, const vector<double> exp);
@@ -1,9 +1,11 @@
 #include <cassert>
+#include <cmath>
 #include <cstdio>
 #include <set>
 #include <vector>
 #include <map>
 #include <queue>
+#include <omp.h>
 
 #include "DataStructures.h"
 #include "shortestPath.h"
@@ -11,14 +13,135 @@
 #include "Printers.h"
 #include "XML_loader.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 using std::set;
 using std::map;
 using std::queue;
 using std::vector;
 using std::priority_queue;
 
-/* Graph is encoded in metabolite.rxnsInvolved_nosec */
-PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, const METABOLITE &output, set<BADIDSTORE> &badIds) {
+/* Relax reaction rxnIdx now that fromId (one of its reactants) has been reached optimally. Nothing happens unless
+   every reactant on the same side as fromId has been reached. modifiedMetIdx and products are scratch space.
+   Pass NULL for badIds if you don't care which reactions were blocked. If bounds is not NULL the queue is ordered by
+   value + bound (A*) and anything that can't reach the target (bound -1) is never queued */
+static void relaxReaction(const RXNSPACE &rxnspace, const METSPACE &metspace, int rxnIdx, int fromId, 
+			  vector<bool> &isDoneAlready, vector<double> &values, vector<int> &precursorRxnIds,
+			  priority_queue<VALUESTORE> &nodeList, set<BADIDSTORE> *badIds, const vector<double> *bounds,
+			  vector<int> &modifiedMetIdx, vector<int> &products) {
+  modifiedMetIdx.clear();
+  double reactantValue(0.0f);
+  double rxnCost = rxnspace.costs()[rxnIdx];
+  const REACTION* currentRxn = &rxnspace.rxns[rxnIdx];
+
+  int tmpIdx;
+  for(int j=0; j<currentRxn->stoich.size();j++) {
+    if(currentRxn->stoich[j].secondary) { continue; }
+    if(currentRxn->stoich[j].met_id == fromId) {
+      tmpIdx = j; 
+      break; 
+    }
+  }
+
+  /* Note - it is NOT sufficient to just let the queue do its thing, we MUST explicitly identify all of
+     the reactants as already having been reached optimally. Otherwise the code will incorrectly allow
+     just one reactant to be present before labeling the products. 
+
+     Try to keep track of reactions that we find blocked here so that we can go and try to un-block them later
+  */
+  bool notAllInputsPresent = false;
+  BADIDSTORE tmpBad;
+  for(int j=0; j<currentRxn->stoich.size(); j++) {
+    if(currentRxn->stoich[j].secondary) { continue; }
+    if(currentRxn->stoich[j].rxn_coeff * currentRxn->stoich[tmpIdx].rxn_coeff > 0.0f) {
+      if(!isDoneAlready[metspace.idxFromId(currentRxn->stoich[j].met_id)]) { 
+	notAllInputsPresent = true; 
+	if(badIds == NULL) { break; }
+	tmpBad.badRxnId = currentRxn->id;
+	tmpBad.badMetIds.push_back(currentRxn->stoich[j].met_id);
+      }
+    }
+  }
+  if(notAllInputsPresent) {
+    if(badIds != NULL) { badIds->insert(tmpBad); }
+    return;
+  } else if(badIds != NULL) { badIds->erase(tmpBad); }
+
+  for(int j=0; j<currentRxn->stoich.size();j++) {
+    if(currentRxn->stoich[j].secondary) { continue; }
+    if(currentRxn->stoich[j].rxn_coeff * currentRxn->stoich[tmpIdx].rxn_coeff > 0) { 
+      reactantValue += values[metspace.idxFromId(currentRxn->stoich[j].met_id)];
+    }
+  }     
+
+  /* Check for other negative likelihoods. If any exist Dijkstras will die a horrible, horrible death */
+  if(rxnCost < 0) {
+    printf("ERROR: in Dijkstras algorithm - NEGATIVE LIKELIHOOD %1.2f for REACTION %d\n", rxnCost, currentRxn->id);
+    assert(rxnCost >= 0);
+  }
+
+  getProducts(*currentRxn, fromId, products);
+
+  for(int j=0; j<products.size();j++) {
+    double newValue = reactantValue + rxnCost;
+    int prodIdx = metspace.idxFromId(products[j]);
+    if(values[prodIdx] > newValue ) {
+      values[prodIdx] = newValue;
+      precursorRxnIds[prodIdx] = currentRxn->id;
+      modifiedMetIdx.push_back(prodIdx);
+    }
+  }
+
+  /* Add updated values to the heap */
+  for(int j=0; j<modifiedMetIdx.size();j++) {
+    VALUESTORE mod;
+    mod.id = metspace.mets[modifiedMetIdx[j]].id;
+    mod.value = values[modifiedMetIdx[j]];
+    if(bounds != NULL) {
+      if((*bounds)[modifiedMetIdx[j]] < 0) { continue; }
+      mod.value += (*bounds)[modifiedMetIdx[j]];
+    }
+    nodeList.push(mod);
+  }
+}
+
+/* DO NOT INCLUDE flag */
+static bool isExcludedCost(double rxnCost) {
+  return rxnCost > -1.1 && rxnCost < -0.9;
+}
+
+/* Orders metabolite indexes by old label + landmark bound */
+class OLDESTIMATEORDER{
+ public:
+  const vector<double> &values;
+  const vector<double> &bounds;
+  OLDESTIMATEORDER(const vector<double> &v, const vector<double> &b) : values(v), bounds(b) {}
+  bool operator()(int a, int b) const { return values[a] + bounds[a] < values[b] + bounds[b]; }
+};
+
+static void saveState(SSSPSTATE *state, const vector<double> &values, const vector<int> &precursorRxnIds, 
+		      const vector<bool> &isDoneAlready, const vector<int> &settleOrder) {
+  if(state == NULL) { return; }
+  state->values = values;
+  state->precursorRxnIds = precursorRxnIds;
+  state->isDone = isDoneAlready;
+  state->settleOrder = settleOrder;
+}
+
+/* Graph is encoded in metabolite.rxnsInvolved_nosec
+
+   If fullState is not NULL, Dijkstras keeps going after the output is reached (so every reachable metabolite gets its final label)
+   and the labels are saved there for repairShortestPath. The path returned is the same either way.
+
+   If bounds is not NULL (and there is no fullState) the search is goal-directed: bounds[i] must be a lower bound on the cost
+   of getting from metabolite i to the output, or -1 if it can't be reached at all (see LANDMARKS::boundsTo and
+   simpleDistances). Metabolites come off the queue in order of label + bound and anything that can't reach the
+   output is never queued. The length of the path is the same, but fewer metabolites get labelled on the way (so badIds
+   only covers those). */
+PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, const METABOLITE &output, set<BADIDSTORE> &badIds,
+		      SSSPSTATE *fullState, const vector<double> *bounds) {
 
   badIds.clear();
   //printf("entering findShortestPath\n");
@@ -30,39 +153,54 @@ PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const
   /* Bookkeeping of various sorts */
   vector<bool> isDoneAlready(metspace.mets.size(), false);
   vector<double> values(metspace.mets.size(), 0.0f);
-  map<int, bool> metsExplored;
+  vector<int> settleOrder;
+
+  /* For tracing back - reaction ID that reached each metabolite (indexed like metspace.mets) */
+  vector<int> precursorRxnIds(metspace.mets.size(), -2);
 
-  /* For tracing back - maps met ID to reaction ID */
-  map<int, int> precursorRxnIds;
+  int outputIdx = metspace.idxFromId(output.id);
+  const vector<double> *boundsPtr = (fullState == NULL) ? bounds : NULL;
 
   /* Initialize */
+  bool anyInputs = false;
   for(int i=0; i<metspace.mets.size();i++) {
     VALUESTORE tmp;
     tmp.id = metspace.mets[i].id;
     if(inputs.idIn(tmp.id)) {
       /* Input */
       tmp.value = 0.0f;
-      precursorRxnIds[tmp.id] = -1; /* -1 signifies the end of a pathway when we're backtracing*/
-      nodeList.push(tmp);
+      precursorRxnIds[i] = -1; /* -1 signifies the end of a pathway when we're backtracing*/
+      anyInputs = true;
+      if(boundsPtr == NULL) { nodeList.push(tmp); }
+      else if((*boundsPtr)[i] >= 0) { tmp.value = (*boundsPtr)[i];  nodeList.push(tmp);  tmp.value = 0.0f; }
     } else {
       tmp.value = 1000000.0f;
-      precursorRxnIds[tmp.id] = -2; /* -2 signifies that the metabolite has not been reached by Dijkstras (this gets updated 
-				       to the precursor reaction ID later in the algorithm - running into this in the backtracing step is an error) */
+      precursorRxnIds[i] = -2; /* -2 signifies that the metabolite has not been reached by Dijkstras (this gets updated 
+				  to the precursor reaction ID later in the algorithm - running into this in the backtracing step is an error) */
     }
     values[i] = tmp.value;
   }
 
   if(nodeList.size() == 0) {
-    printf("WARNING: No inputs found! Will return an empty path\n");
+    /* (If there are inputs the bounds showed that none of them can reach the output) */
+    if(!anyInputs) { printf("WARNING: No inputs found! Will return an empty path\n"); }
+    saveState(fullState, values, precursorRxnIds, isDoneAlready, settleOrder);
     PATH dum;
     return dum;
   }
 
-  int outputIdx = metspace.idxFromId(output.id);
+  /* Reaction costs are read from the contiguous attribute array and the REACTION itself is only touched
+     for reactions that are not excluded */
+  const vector<double> &cost = rxnspace.costs();
+  if(cost.size() != rxnspace.rxns.size()) {
+    printf("ERROR: RXNSPACE attributes out of date in findShortestPath - call syncAttributes() after modifying rxns directly\n");
+    assert(cost.size() == rxnspace.rxns.size());
+  }
 
+  vector<int> modifiedMetIdx;
+  vector<int> products;
   while(nodeList.size() > 0) {
 
-    vector<int> reactionList;
     VALUESTORE tmp = nodeList.top();
     int tmpValIdx = metspace.idxFromId(tmp.id);
     nodeList.pop(); /* Actually remove the highest value (since top() doens't remove it) */
@@ -72,107 +210,191 @@ PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const
 	 In such a case we normally want to continue on, however we must check and make sure that there are still
 	 things left to check, otherwise there is no solution */
       if(nodeList.size() == 0) {
+	if(fullState != NULL) { break; }
 	//printf("No path found to output [found from duplicate] \n");
-	//	printIntMap_mets(metspace, precursorRxnIds);
 	PATH tmpPath;
 	return tmpPath;
       }      
       continue;
     }
     isDoneAlready[tmpValIdx] = true;
+    if(fullState != NULL) { settleOrder.push_back(tmpValIdx); }
 
     /* We have found optimal path to the specified output already */
-    if(isDoneAlready[outputIdx]) {
+    if(isDoneAlready[outputIdx] && fullState == NULL) {
       // printf("Optimal path found to output\n");
       break;
     }
 
     /* Find all products of reactions starting with the given metabolite. Update V(P) */
-    reactionList = metspace.mets[tmpValIdx].rxnsInvolved_nosec;
+    const vector<int> &reactionList = metspace.mets[tmpValIdx].rxnsInvolved_nosec;
 
     for(int i=0; i<reactionList.size();i++) {
-      vector<int> modifiedMetIdx;
-      vector<int> products;
-      double reactantValue(0.0f);
-      const REACTION* currentRxn = rxnspace.rxnPtrFromId(reactionList[i]);
-
-      /* DO NOT INCLUDE flag */
-      if(currentRxn->current_likelihood> -1.1 && currentRxn->current_likelihood < -0.9) { continue; }
-
-      int tmpIdx;
-      for(int j=0; j<currentRxn->stoich_part.size();j++) {
-	if(currentRxn->stoich_part[j].met_id == tmp.id) {
-	  tmpIdx = j; 
-	  break; 
-	}
-      }
+      int rxnIdx = rxnspace.idxFromId(reactionList[i]);
+      if(isExcludedCost(cost[rxnIdx])) { continue; }
+      relaxReaction(rxnspace, metspace, rxnIdx, tmp.id, isDoneAlready, values, precursorRxnIds, nodeList, &badIds, boundsPtr,
+		    modifiedMetIdx, products);
+    } /* For each reaction in reactionList */
 
-      /* Note - it is NOT sufficient to just let the queue do its thing, we MUST explicitly identify all of
-	 the reactants as already having been reached optimally. Otherwise the code will incorrectly allow
-	 just one reactant to be present before labeling the products. 
-
-	 Try to keep track of reactions that we find blocked here so that we can go and try to un-block them later
-      */
-      bool notAllInputsPresent = false;
-      BADIDSTORE tmpBad;
-      for(int j=0; j<currentRxn->stoich_part.size(); j++) {
-	if(currentRxn->stoich_part[j].rxn_coeff * currentRxn->stoich_part[tmpIdx].rxn_coeff > 0.0f) {
-	  if(!isDoneAlready[metspace.idxFromId(currentRxn->stoich_part[j].met_id)]) { 
-	    notAllInputsPresent = true; 
-	    tmpBad.badRxnId = currentRxn->id;
-	    tmpBad.badMetIds.push_back(currentRxn->stoich_part[j].met_id);
-	  }
-	}
-      }
-      if(notAllInputsPresent) {
-	badIds.insert(tmpBad);
-	continue;
-      } else { badIds.erase(tmpBad); }
+    if(nodeList.size() == 0) {
+      if(fullState != NULL) { break; }
+      //printf("No path found to output\n");
+      PATH tmpPath;
+      //      printRxnsFromIntSet(badIds, rxnspace);
+      return tmpPath;
+    }
 
+  } /* While nodeList.size() > 0 */
 
-      for(int j=0; j<currentRxn->stoich_part.size();j++) {
-	if(currentRxn->stoich_part[j].rxn_coeff * currentRxn->stoich_part[tmpIdx].rxn_coeff > 0) { 
-	  reactantValue += values[metspace.idxFromId(currentRxn->stoich_part[j].met_id)];
-	}
-      }     
+  saveState(fullState, values, precursorRxnIds, isDoneAlready, settleOrder);
+  if(!isDoneAlready[outputIdx]) {
+    PATH tmpPath;
+    return tmpPath;
+  }
+  return tracedPathToOutput(rxnspace, metspace, output, values, precursorRxnIds);
+}
 
-      /* Check for other negative likelihoods. If any exist Dijkstras will die a horrible, horrible death */
-      if(currentRxn->current_likelihood < 0) {
-	printf("ERROR: in Dijkstras algorithm - NEGATIVE LIKELIHOOD %1.2f for REACTION %d\n", currentRxn->current_likelihood, currentRxn->id);
-	assert(currentRxn->current_likelihood >= 0);
-      }
+/* Spur search for kShortest with INCREMENTAL_SPURS (legacy - only used with BATCH_SPURS off, see MyConstants.cc; 
+   SpurBench keeps it for comparison). rxnspace must be the network parent was computed on (with findShortestPath and a fullState)
+   with excludedRxnId turned off as well. Removing a reaction can't make anything cheaper, so only the metabolites whose route
+   in parent went through excludedRxnId get their labels recomputed - everything else is kept.
 
-      getProducts(*currentRxn, tmp.id, products);
+   The length of the path found is always the same as findShortestPath would give, but when two paths are exactly tied 
+   this may pick the other one. Blocked reactions (badIds) are not tracked here. bounds (if not NULL) make the 
+   re-labelling goal-directed as in findShortestPath. */
+PATH repairShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METABOLITE &output, const SSSPSTATE &parent, int excludedRxnId,
+			const vector<double> *bounds) {
 
-      for(int j=0; j<products.size();j++) {
-	double newValue = reactantValue + currentRxn->current_likelihood;
-	int prodIdx = metspace.idxFromId(products[j]);
-        if(values[prodIdx] > newValue ) {
-	  values[prodIdx] = newValue;
-	  precursorRxnIds[products[j]] = reactionList[i];
-	  modifiedMetIdx.push_back(prodIdx);
-	}
+  int numMets = metspace.mets.size();
+  assert(parent.values.size() == numMets);
+  int outputIdx = metspace.idxFromId(output.id);
+  /* Wasn't reachable before - taking something else away won't help */
+  if(!parent.isDone[outputIdx]) {
+    PATH tmpPath;
+    return tmpPath;
+  }
+
+  /* A metabolite is affected if the reaction that reached it in parent is the excluded one or has an affected reactant. 
+     Those reactants were always settled before it, so one pass in settle order finds all of them (starting from the first 
+     thing the excluded reaction reached - nothing before that can be affected) */
+  int firstAffected = 0;
+  while(firstAffected < parent.settleOrder.size() && parent.precursorRxnIds[parent.settleOrder[firstAffected]] != excludedRxnId) {
+    firstAffected++;
+  }
+  vector<bool> affected(numMets, false);
+  vector<int> affectedIdx;
+  for(int i=firstAffected; i<parent.settleOrder.size(); i++) {
+    int metIdx = parent.settleOrder[i];
+    int rxnId = parent.precursorRxnIds[metIdx];
+    if(rxnId < 0) { continue; }
+    bool isAffected = (rxnId == excludedRxnId);
+    if(!isAffected) {
+      const REACTION &rxn = rxnspace.rxnFromId(rxnId);
+      int metId = metspace.mets[metIdx].id;
+      int sgn(0);
+      for(int j=0; j<rxn.stoich.size(); j++) {
+	if(rxn.stoich[j].secondary) { continue; }
+	if(rxn.stoich[j].met_id == metId) { sgn = rxn.stoich[j].rxn_coeff < 0 ? -1 : 1; break; }
+      }
+      for(int j=0; j<rxn.stoich.size(); j++) {
+	if(rxn.stoich[j].secondary) { continue; }
+	if(sgn*rxn.stoich[j].rxn_coeff < 0 && affected[metspace.idxFromId(rxn.stoich[j].met_id)]) { isAffected = true; break; }
       }
+    }
+    if(isAffected) {
+      affected[metIdx] = true;
+      affectedIdx.push_back(metIdx);
+    }
+  }
 
-      /* Add updated values to the heap */
-      for(int j=0; j<modifiedMetIdx.size();j++) {
-	VALUESTORE mod;
-	mod.id = metspace.mets[modifiedMetIdx[j]].id;
-	mod.value = values[modifiedMetIdx[j]];
-	nodeList.push(mod);
+  vector<double> values = parent.values;
+  vector<int> precursorRxnIds = parent.precursorRxnIds;
+  vector<bool> isDoneAlready = parent.isDone;
+  for(int i=0; i<affectedIdx.size(); i++) {
+    values[affectedIdx[i]] = 1000000.0f;
+    precursorRxnIds[affectedIdx[i]] = -2;
+    isDoneAlready[affectedIdx[i]] = false;
+  }
+
+  /* With bounds the lower bound on an affected metabolite's new queue value is its old label + its bound, 
+     so seed in that order (and never bother with anything that can't reach the output) */
+  const vector<double> *boundsPtr = bounds;
+  vector<int> seedIdx;
+  if(boundsPtr != NULL) {
+    for(int i=0; i<affectedIdx.size(); i++) {
+      if((*bounds)[affectedIdx[i]] >= 0) { seedIdx.push_back(affectedIdx[i]); }
+    }
+    std::stable_sort(seedIdx.begin(), seedIdx.end(), OLDESTIMATEORDER(parent.values, *bounds));
+  } else {
+    seedIdx = affectedIdx;
+  }
+
+  const vector<double> &cost = rxnspace.costs();
+  priority_queue<VALUESTORE> nodeList;
+  vector<int> modifiedMetIdx;
+  vector<int> products;
+
+  /* Dijkstras over the affected metabolites. Each one first has every remaining reaction into it offered again from its settled side
+     (which only fires if that whole side is settled). That is done lazily in order of the parent's labels: an affected label 
+     can only go up, so a metabolite whose old label is above the top of the queue can't be next anyway - and the ones past 
+     the output are never looked at */
+  int nextSeed = 0;
+  while(true) {
+    while(nextSeed < seedIdx.size() &&
+	  (nodeList.size() == 0 || parent.values[seedIdx[nextSeed]] + (boundsPtr ? (*bounds)[seedIdx[nextSeed]] : 0.0f) <= nodeList.top().value)) {
+      const METABOLITE &met = metspace.mets[seedIdx[nextSeed]];
+      nextSeed++;
+      for(int k=0; k<met.rxnsInvolved_nosec.size(); k++) {
+	int rxnIdx = rxnspace.idxFromId(met.rxnsInvolved_nosec[k]);
+	if(isExcludedCost(cost[rxnIdx])) { continue; }
+	const REACTION &rxn = rxnspace.rxns[rxnIdx];
+	int sgn(0);
+	for(int j=0; j<rxn.stoich.size(); j++) {
+	  if(rxn.stoich[j].secondary) { continue; }
+	  if(rxn.stoich[j].met_id == met.id) { sgn = rxn.stoich[j].rxn_coeff < 0 ? -1 : 1; break; }
+	}
+	for(int j=0; j<rxn.stoich.size(); j++) {
+	  if(rxn.stoich[j].secondary) { continue; }
+	  if(sgn*rxn.stoich[j].rxn_coeff < 0) {
+	    if(isDoneAlready[metspace.idxFromId(rxn.stoich[j].met_id)]) {
+	      relaxReaction(rxnspace, metspace, rxnIdx, rxn.stoich[j].met_id, isDoneAlready, values, precursorRxnIds, nodeList, NULL, boundsPtr,
+			    modifiedMetIdx, products);
+	    }
+	    break;
+	  }
+	}
       }
-    } /* For each reaction in reactionList */
+    }
+    if(nodeList.size() == 0) { break; }
 
-    if(nodeList.size() == 0) {
-      //printf("No path found to output\n");
-      PATH tmpPath;
-      //      printRxnsFromIntSet(badIds, rxnspace);
-      return tmpPath;
+    VALUESTORE tmp = nodeList.top();
+    int tmpValIdx = metspace.idxFromId(tmp.id);
+    nodeList.pop();
+    if(isDoneAlready[tmpValIdx]) { continue; }
+    isDoneAlready[tmpValIdx] = true;
+    if(tmpValIdx == outputIdx) { break; }
+
+    const vector<int> &reactionList = metspace.mets[tmpValIdx].rxnsInvolved_nosec;
+    for(int i=0; i<reactionList.size(); i++) {
+      int rxnIdx = rxnspace.idxFromId(reactionList[i]);
+      if(isExcludedCost(cost[rxnIdx])) { continue; }
+      relaxReaction(rxnspace, metspace, rxnIdx, tmp.id, isDoneAlready, values, precursorRxnIds, nodeList, NULL, boundsPtr,
+		    modifiedMetIdx, products);
     }
+  }
 
-  } /* While nodeList.size() > 0 */
+  if(!isDoneAlready[outputIdx]) {
+    PATH tmpPath;
+    return tmpPath;
+  }
+  return tracedPathToOutput(rxnspace, metspace, output, values, precursorRxnIds);
+}
 
+/* Trace the path to output back through precursorRxnIds and fill in the rest of the PATH */
+PATH tracedPathToOutput(const RXNSPACE &rxnspace, const METSPACE &metspace, const METABOLITE &output, 
+			const vector<double> &values, const vector<int> &precursorRxnIds) {
   /* Trace the path back */
+  map<int, bool> metsExplored;
   queue<int> dfsList; dfsList.push(output.id);
   vector<int> rxnIds;
   vector<int> inputIdList;
@@ -205,8 +427,9 @@ PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const
   vector<int> allMets;
   for(int i=0; i<tracedPath.rxnIds.size(); i++) {
     const REACTION* rxn = rxnspace.rxnPtrFromId(tracedPath.rxnIds[i]);
-    for(int j=0; j < rxn->stoich_part.size(); j++) {
-      allMets.push_back(rxn->stoich_part[j].met_id);
+    for(int j=0; j < rxn->stoich.size(); j++) {
+      if(rxn->stoich[j].secondary) { continue; }
+      allMets.push_back(rxn->stoich[j].met_id);
     }
   }
 
@@ -218,7 +441,7 @@ PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const
   return tracedPath;
 }
 
-/*    precursorRxnIds: map between metabolite IDs and reaction IDs that they came from (-1 for inputs)
+/*    precursorRxnIds: reaction IDs that each metabolite came from, indexed like metspace.mets (-1 for inputs)
       metsExplored: needed internally. true for anything that has already been traced by the DFS
       rxnIds: ID of any reactions that have been traced
       inputIds: ID of any inputs (-1) found while tracing
@@ -227,7 +450,7 @@ PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const
 
  Note that if we get an indexing out of bounds here that indicates I messed up the code... */
 
-void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, map<int, int>  &precursorRxnIds, map<int, bool> &metsExplored, vector<int> &rxnIds, vector<int> &inputIds, 
+void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, const vector<int> &precursorRxnIds, map<int, bool> &metsExplored, vector<int> &rxnIds, vector<int> &inputIds, 
 	       vector<int> &rxnDirections, queue<int> &nodeList) {
 
   /* Termination condition - nothing left in the queue! */
@@ -237,7 +460,7 @@ void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, map<int, int>
 
   int currentNodeId = nodeList.front();
   nodeList.pop();
-  int currentEdgeId = precursorRxnIds[currentNodeId];
+  int currentEdgeId = precursorRxnIds[metspace.idxFromId(currentNodeId)];
 
   metsExplored[currentNodeId] = true;
 
@@ -251,9 +474,10 @@ void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, map<int, int>
 
   int sgn(0);
   const REACTION* rxn = rxnspace.rxnPtrFromId(currentEdgeId);
-  for(int i=0; i<rxn->stoich_part.size();i++) {
-    if(rxn->stoich_part[i].met_id == currentNodeId) {
-      if(rxn->stoich_part[i].rxn_coeff < 0) { sgn = -1; } else { sgn = 1; };
+  for(int i=0; i<rxn->stoich.size();i++) {
+    if(rxn->stoich[i].secondary) { continue; }
+    if(rxn->stoich[i].met_id == currentNodeId) {
+      if(rxn->stoich[i].rxn_coeff < 0) { sgn = -1; } else { sgn = 1; };
       break;
     }
   }
@@ -275,15 +499,443 @@ void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, map<int, int>
   tracePath(metspace, rxnspace, precursorRxnIds, metsExplored, rxnIds, inputIds, rxnDirections, nodeList);
 }
 
-/* Find metabolites opposite of metId in a reaction (based on stoich_part) */
+/* Find metabolites opposite of metId in a reaction (secondaries excluded) */
 /* 6-14-11: CONFIRMED working by printout */
 vector<int> opposite(const REACTION* rxn, int metId, int sgn) {
 
     vector<int> finalList;
-    for(int i=0; i<rxn->stoich_part.size();i++) {
-      if(sgn*rxn->stoich_part[i].rxn_coeff < 0) {
-	finalList.push_back(rxn->stoich_part[i].met_id);
+    for(int i=0; i<rxn->stoich.size();i++) {
+      if(rxn->stoich[i].secondary) { continue; }
+      if(sgn*rxn->stoich[i].rxn_coeff < 0) {
+	finalList.push_back(rxn->stoich[i].met_id);
       }
     }
     return finalList;
 }
+
+/* Index the non-secondary stoichiometry of rxnspace for batchShortestPaths. metspace rxnsInvolved_nosec must be up to date
+   (calcMetRxnRelations_nosec) */
+void buildHyperCsr(const RXNSPACE &rxnspace, const METSPACE &metspace, HYPERCSR &result) {
+  result.metStart.assign(1, 0);
+  result.metRxns.clear();
+  for(int i=0; i<metspace.mets.size(); i++) {
+    const vector<int> &reactionList = metspace.mets[i].rxnsInvolved_nosec;
+    for(int j=0; j<reactionList.size(); j++) {
+      if(rxnspace.idIn(reactionList[j])) { result.metRxns.push_back(rxnspace.idxFromId(reactionList[j])); }
+    }
+    result.metStart.push_back(result.metRxns.size());
+  }
+  result.rxnStart.assign(1, 0);
+  result.rxnMets.clear();
+  result.rxnSigns.clear();
+  result.rxnDirection.clear();
+  for(int i=0; i<rxnspace.rxns.size(); i++) {
+    const REACTION &rxn = rxnspace.rxns[i];
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      if(rxn.stoich[j].secondary || !metspace.idIn(rxn.stoich[j].met_id)) { continue; }
+      result.rxnMets.push_back(metspace.idxFromId(rxn.stoich[j].met_id));
+      result.rxnSigns.push_back(rxn.stoich[j].rxn_coeff < 0 ? -1 : 1);
+    }
+    result.rxnStart.push_back(result.rxnMets.size());
+    result.rxnDirection.push_back(rxn.net_reversible);
+  }
+}
+
+/* Lane arithmetic for batchShortestPaths (one double per exclusion variant). Compile with -mavx2 to do four lanes at a time */
+static inline void lanesAddInto(double *sum, const double *x) {
+#ifdef __AVX2__
+  for(int l=0; l<SPUR_LANES; l+=4) {
+    _mm256_storeu_pd(sum + l, _mm256_add_pd(_mm256_loadu_pd(sum + l), _mm256_loadu_pd(x + l)));
+  }
+#else
+  for(int l=0; l<SPUR_LANES; l++) { sum[l] += x[l]; }
+#endif
+}
+
+/* target = min(target, candidate) in each lane. Returns a bitmask of the lanes that went down */
+static inline unsigned int lanesMinInto(double *target, const double *candidate) {
+  unsigned int improved = 0;
+#ifdef __AVX2__
+  for(int l=0; l<SPUR_LANES; l+=4) {
+    __m256d t = _mm256_loadu_pd(target + l);
+    __m256d c = _mm256_loadu_pd(candidate + l);
+    improved |= (unsigned int)_mm256_movemask_pd(_mm256_cmp_pd(c, t, _CMP_LT_OQ)) << l;
+    _mm256_storeu_pd(target + l, _mm256_min_pd(c, t));
+  }
+#else
+  for(int l=0; l<SPUR_LANES; l++) {
+    if(candidate[l] < target[l]) {
+      target[l] = candidate[l];
+      improved |= 1u << l;
+    }
+  }
+#endif
+  return improved;
+}
+
+/* Shortest paths to output for up to SPUR_LANES copies of rxnspace that each have one more reaction (excludedRxnIds[lane]) 
+   turned off, in one pass over the graph. Every metabolite carries one label per lane, and a reaction is relaxed for all
+   the lanes at once (a lane where one of the reactants hasn't been reached yet, or where the reaction is excluded, just 
+   stays infinite). 
+
+   The lanes don't settle in the same order, so this is label-correcting rather than Dijkstras: a metabolite goes back on 
+   the queue whenever any of its lanes improves, keyed by the smallest lane that did. With non-negative costs nothing 
+   queued later can have a smaller key, so we can stop as soon as the key reaches the worst lane of the output. 
+   Path lengths are the same as findShortestPath on each variant (exact ties may be broken differently).
+   bounds (as in findShortestPath) is only used to skip metabolites that can't reach the output. */
+void batchShortestPaths(const HYPERCSR &graph, const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, 
+			const METABOLITE &output, const vector<int> &excludedRxnIds, vector<PATH> &result, const vector<double> *bounds) {
+  int numLanes = excludedRxnIds.size();
+  assert(numLanes <= SPUR_LANES);
+  result.assign(numLanes, PATH());
+  if(numLanes == 0) { return; }
+
+  int numMets = metspace.mets.size();
+  int outputIdx = metspace.idxFromId(output.id);
+  const vector<double> &cost = rxnspace.costs();
+  const double inf = HUGE_VAL;
+
+  /* Lanes past numLanes never get anywhere */
+  unsigned int unusedLanes = 0;
+  for(int l=numLanes; l<SPUR_LANES; l++) { unusedLanes |= 1u << l; }
+  int excludedIdx[SPUR_LANES];
+  for(int l=0; l<numLanes; l++) { excludedIdx[l] = rxnspace.idxFromId(excludedRxnIds[l]); }
+
+  /* [metabolite index * SPUR_LANES + lane] */
+  vector<double> values((size_t)numMets * SPUR_LANES, inf);
+  vector<int> precursorRxnIds((size_t)numMets * SPUR_LANES, -2);
+  /* Smallest key this metabolite is on the queue with (inf if it isn't) - any other entries for it are stale */
+  vector<double> queuedKey(numMets, inf);
+  priority_queue<VALUESTORE> nodeList;
+
+  for(int i=0; i<numMets; i++) {
+    if(!inputs.idIn(metspace.mets[i].id)) { continue; }
+    for(int l=0; l<numLanes; l++) {
+      values[(size_t)i*SPUR_LANES + l] = 0.0f;
+      precursorRxnIds[(size_t)i*SPUR_LANES + l] = -1;
+    }
+    if(bounds != NULL && (*bounds)[i] < 0) { continue; }
+    VALUESTORE tmp;
+    tmp.id = i;  tmp.value = 0.0f;
+    queuedKey[i] = 0.0f;
+    nodeList.push(tmp);
+  }
+
+  double sideSum[SPUR_LANES];
+  double newValue[SPUR_LANES];
+  const double *outputValues = &values[(size_t)outputIdx * SPUR_LANES];
+  while(nodeList.size() > 0) {
+    VALUESTORE tmp = nodeList.top();
+    nodeList.pop();
+    int metIdx = tmp.id;
+    if(tmp.value != queuedKey[metIdx]) { continue; }
+    queuedKey[metIdx] = inf;
+
+    double worstOutput = 0.0f;
+    for(int l=0; l<numLanes; l++) {  if(outputValues[l] > worstOutput) { worstOutput = outputValues[l]; }  }
+    if(tmp.value >= worstOutput) { break; }
+
+    for(int k=graph.metStart[metIdx]; k<graph.metStart[metIdx+1]; k++) {
+      int rxnIdx = graph.metRxns[k];
+      if(isExcludedCost(cost[rxnIdx])) { continue; }
+      if(cost[rxnIdx] < 0) {
+	printf("ERROR: in batchShortestPaths - NEGATIVE LIKELIHOOD %1.2f for REACTION %d\n", cost[rxnIdx], rxnspace.rxns[rxnIdx].id);
+	assert(cost[rxnIdx] >= 0);
+      }
+      int start = graph.rxnStart[rxnIdx];
+      int end = graph.rxnStart[rxnIdx+1];
+      int sgn = 0;
+      for(int j=start; j<end; j++) {
+	if(graph.rxnMets[j] == metIdx) { sgn = graph.rxnSigns[j];  break; }
+      }
+      /* Same reversibility rules as getProducts */
+      int dir = graph.rxnDirection[rxnIdx];
+      if(sgn == 0 || (dir == 1 && sgn != -1) || (dir == -1 && sgn != 1)) { continue; }
+
+      for(int l=0; l<SPUR_LANES; l++) { sideSum[l] = 0.0f; }
+      for(int j=start; j<end; j++) {
+	if(graph.rxnSigns[j] == sgn) { lanesAddInto(sideSum, &values[(size_t)graph.rxnMets[j] * SPUR_LANES]); }
+      }
+      unsigned int blocked = unusedLanes;
+      for(int l=0; l<numLanes; l++) {  if(excludedIdx[l] == rxnIdx) { blocked |= 1u << l; }  }
+      for(int l=0; l<SPUR_LANES; l++) {
+	newValue[l] = ((blocked >> l) & 1) ? inf : sideSum[l] + cost[rxnIdx];
+      }
+
+      for(int j=start; j<end; j++) {
+	if(graph.rxnSigns[j] != -sgn) { continue; }
+	int prodIdx = graph.rxnMets[j];
+	if(bounds != NULL && (*bounds)[prodIdx] < 0) { continue; }
+	unsigned int improved = lanesMinInto(&values[(size_t)prodIdx * SPUR_LANES], newValue);
+	if(improved == 0) { continue; }
+	double key = inf;
+	for(int l=0; l<numLanes; l++) {
+	  if(((improved >> l) & 1) == 0) { continue; }
+	  precursorRxnIds[(size_t)prodIdx * SPUR_LANES + l] = rxnspace.rxns[rxnIdx].id;
+	  if(newValue[l] < key) { key = newValue[l]; }
+	}
+	if(key < queuedKey[prodIdx]) {
+	  queuedKey[prodIdx] = key;
+	  VALUESTORE mod;
+	  mod.id = prodIdx;  mod.value = key;
+	  nodeList.push(mod);
+	}
+      }
+    }
+  }
+
+  vector<double> laneValues(numMets);
+  vector<int> lanePrecursors(numMets);
+  for(int l=0; l<numLanes; l++) {
+    if(outputValues[l] == inf) { continue; }
+    for(int i=0; i<numMets; i++) {
+      laneValues[i] = values[(size_t)i*SPUR_LANES + l];
+      lanePrecursors[i] = precursorRxnIds[(size_t)i*SPUR_LANES + l];
+    }
+    result[l] = tracedPathToOutput(rxnspace, metspace, output, laneValues, lanePrecursors);
+  }
+}
+
+/* One proposed label from a parallelShortestPath round */
+class LABELCANDIDATE{
+ public:
+  int metIdx;
+  int rxnId;
+  double value;
+};
+
+/* Bucket a label falls in for parallelShortestPath */
+static long bucketOf(double value, double delta) {
+  return (long)floor(value / delta);
+}
+
+/* Single query spread over all threads (delta-stepping): labels are settled a bucket of width delta at a time. Each round
+   relaxes every reaction touching a metabolite that changed in the current bucket in parallel, and the proposals are
+   merged afterwards, so the result doesn't depend on the number of threads or on timing.
+
+   Costs are identical to findShortestPath. A label (and its precursor) is only replaced by a strictly lower one; when
+   several reactions propose the same new label in one round the one with the smaller ID is used (findShortestPath takes
+   whichever it relaxes first), so paths can only differ where there are exact ties.
+   Blocked reactions (badIds) are not tracked. graph must be built from rxnspace / metspace (see buildHyperCsr) */
+PATH parallelShortestPath(const HYPERCSR &graph, const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs,
+			  const METABOLITE &output) {
+  int numMets = metspace.mets.size();
+  int outputIdx = metspace.idxFromId(output.id);
+  const vector<double> &cost = rxnspace.costs();
+  const double inf = HUGE_VAL;
+
+  /* Bucket width - about one reaction */
+  double delta(0.0f);
+  int numCosts(0);
+  for(int r=0; r<cost.size(); r++) {
+    if(isExcludedCost(cost[r])) { continue; }
+    if(cost[r] < 0) {
+      printf("ERROR: in parallelShortestPath - NEGATIVE LIKELIHOOD %1.2f for REACTION %d\n", cost[r], rxnspace.rxns[r].id);
+      assert(cost[r] >= 0);
+    }
+    delta += cost[r];
+    numCosts++;
+  }
+  delta = (numCosts > 0 && delta > 0) ? delta / numCosts : 1.0f;
+
+  vector<double> values(numMets, inf);
+  vector<int> precursorRxnIds(numMets, -2);
+  vector<char> changed(numMets, 0);
+  /* Metabolites waiting to be relaxed, by bucket. A metabolite is added again each time its label drops, so an entry is
+     skipped if the metabolite was relaxed since or its label has moved to a lower bucket */
+  map<long, vector<int> > buckets;
+  for(int i=0; i<numMets; i++) {
+    if(inputs.idIn(metspace.mets[i].id)) {
+      values[i] = 0.0f;
+      precursorRxnIds[i] = -1;
+      changed[i] = 1;
+      buckets[0].push_back(i);
+    }
+  }
+
+  vector<vector<LABELCANDIDATE> > threadCandidates(omp_get_max_threads());
+  /* Round in which each label was last lowered (ties are only settled among proposals from that round) */
+  vector<int> lastImproved(numMets, -1);
+  vector<int> frontier;
+  int round(0);
+  while(!buckets.empty()) {
+    map<long, vector<int> >::iterator lowest = buckets.begin();
+    long bucket = lowest->first;
+    /* Nothing from here on can reach (or tie) the output */
+    if(bucket * delta > values[outputIdx]) { break; }
+    frontier.clear();
+    const vector<int> &waiting = lowest->second;
+    for(int w=0; w<waiting.size(); w++) {
+      int metIdx = waiting[w];
+      if(!changed[metIdx] || bucketOf(values[metIdx], delta) != bucket) { continue; }
+      changed[metIdx] = 0;
+      frontier.push_back(metIdx);
+    }
+    buckets.erase(lowest);
+    if(frontier.empty()) { continue; }
+
+    /* Relax - values are only read here */
+#pragma omp parallel
+    {
+      vector<LABELCANDIDATE> &candidates = threadCandidates[omp_get_thread_num()];
+      candidates.clear();
+#pragma omp for schedule(dynamic, 64)
+      for(int f=0; f<frontier.size(); f++) {
+	int metIdx = frontier[f];
+	for(int k=graph.metStart[metIdx]; k<graph.metStart[metIdx+1]; k++) {
+	  int rxnIdx = graph.metRxns[k];
+	  if(isExcludedCost(cost[rxnIdx])) { continue; }
+	  int start = graph.rxnStart[rxnIdx];
+	  int end = graph.rxnStart[rxnIdx+1];
+	  int sgn = 0;
+	  for(int j=start; j<end; j++) {
+	    if(graph.rxnMets[j] == metIdx) { sgn = graph.rxnSigns[j];  break; }
+	  }
+	  /* Same reversibility rules as getProducts */
+	  int dir = graph.rxnDirection[rxnIdx];
+	  if(sgn == 0 || (dir == 1 && sgn != -1) || (dir == -1 && sgn != 1)) { continue; }
+	  double newValue = cost[rxnIdx];
+	  for(int j=start; j<end; j++) {
+	    if(graph.rxnSigns[j] == sgn) { newValue += values[graph.rxnMets[j]]; }
+	  }
+	  if(newValue == inf) { continue; }
+	  for(int j=start; j<end; j++) {
+	    if(graph.rxnSigns[j] != -sgn) { continue; }
+	    int prodIdx = graph.rxnMets[j];
+	    if(newValue > values[prodIdx]) { continue; }
+	    LABELCANDIDATE c;
+	    c.metIdx = prodIdx;  c.rxnId = rxnspace.rxns[rxnIdx].id;  c.value = newValue;
+	    candidates.push_back(c);
+	  }
+	}
+      }
+    }
+
+    /* Merge - only a strictly lower label replaces the old one (an equal one could close a cycle of precursors). Among
+       the proposals of this round that lower a label the lowest value wins, then the lowest reaction ID (inputs keep
+       their labels) */
+    for(int t=0; t<threadCandidates.size(); t++) {
+      const vector<LABELCANDIDATE> &candidates = threadCandidates[t];
+      for(int c=0; c<candidates.size(); c++) {
+	int metIdx = candidates[c].metIdx;
+	if(precursorRxnIds[metIdx] == -1) { continue; }
+	if(candidates[c].value < values[metIdx]) {
+	  values[metIdx] = candidates[c].value;
+	  precursorRxnIds[metIdx] = candidates[c].rxnId;
+	  lastImproved[metIdx] = round;
+	  changed[metIdx] = 1;
+	  buckets[bucketOf(values[metIdx], delta)].push_back(metIdx);
+	} else if(lastImproved[metIdx] == round && candidates[c].value == values[metIdx] && candidates[c].rxnId < precursorRxnIds[metIdx]) {
+	  precursorRxnIds[metIdx] = candidates[c].rxnId;
+	}
+      }
+    }
+    round++;
+  }
+
+  if(values[outputIdx] == inf) {
+    PATH tmpPath;
+    return tmpPath;
+  }
+  return tracedPathToOutput(rxnspace, metspace, output, values, precursorRxnIds);
+}
+
+/* Plain Dijkstras on a split graph from sourceIdx. dist is -1 for anything unreachable */
+void simpleDistances(const SPLITGRAPH &adj, int sourceIdx, vector<double> &dist) {
+  dist.assign(adj.size(), -1.0f);
+  vector<bool> done(adj.size(), false);
+  priority_queue<VALUESTORE> nodeList;
+  VALUESTORE tmp;
+  tmp.id = sourceIdx; tmp.value = 0.0f;
+  dist[sourceIdx] = 0.0f;
+  nodeList.push(tmp);
+  while(nodeList.size() > 0) {
+    tmp = nodeList.top();
+    nodeList.pop();
+    if(done[tmp.id]) { continue; }
+    done[tmp.id] = true;
+    for(int i=0; i<adj[tmp.id].size(); i++) {
+      int next = adj[tmp.id][i].first;
+      double newValue = tmp.value + adj[tmp.id][i].second;
+      if(dist[next] < 0 || dist[next] > newValue) {
+	dist[next] = newValue;
+	VALUESTORE mod;
+	mod.id = next; mod.value = newValue;
+	nodeList.push(mod);
+      }
+    }
+  }
+}
+
+/* Split every reaction into an edge from each (non-secondary) reactant to each product, in whichever directions 
+   net_reversible allows, costing the whole reaction. A product can't cost less than its costliest single predecessor
+   plus the reaction, so distances on this graph are lower bounds on hyperpath costs. Excluded reactions (-1) are left out.
+   rxnspace costs must be up to date (syncAttributes) */
+void splitGraph(const RXNSPACE &rxnspace, const METSPACE &metspace, SPLITGRAPH &forward, SPLITGRAPH &backward) {
+  int numMets = metspace.mets.size();
+  forward.assign(numMets, vector<std::pair<int, double> >());
+  backward.assign(numMets, vector<std::pair<int, double> >());
+  const vector<double> &cost = rxnspace.costs();
+  vector<int> products;
+  for(int r=0; r<rxnspace.rxns.size(); r++) {
+    if(cost[r] < 0) { continue; }
+    const REACTION &rxn = rxnspace.rxns[r];
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      if(rxn.stoich[j].secondary) { continue; }
+      if(!metspace.idIn(rxn.stoich[j].met_id)) { continue; }
+      int fromIdx = metspace.idxFromId(rxn.stoich[j].met_id);
+      getProducts(rxn, rxn.stoich[j].met_id, products);
+      for(int k=0; k<products.size(); k++) {
+	if(!metspace.idIn(products[k])) { continue; }
+	int toIdx = metspace.idxFromId(products[k]);
+	forward[fromIdx].push_back(std::make_pair(toIdx, cost[r]));
+	backward[toIdx].push_back(std::make_pair(fromIdx, cost[r]));
+      }
+    }
+  }
+}
+
+/* Build landmark tables for rxnspace / metspace: forward and backward split-graph distances (see splitGraph) from 
+   a few landmarks picked farthest-first. Only exclude reactions here that will stay excluded for every query 
+   the table is used with */
+void buildLandmarks(const RXNSPACE &rxnspace, const METSPACE &metspace, int numLandmarks, LANDMARKS &result) {
+  result.landmarkIdx.clear();
+  result.fromLandmark.clear();
+  result.toLandmark.clear();
+  int numMets = metspace.mets.size();
+  if(numLandmarks <= 0 || numMets == 0) { return; }
+
+  SPLITGRAPH forward, backward;
+  splitGraph(rxnspace, metspace, forward, backward);
+
+  /* Farthest-first: start from whatever is farthest from the first metabolite, then keep taking the metabolite
+     farthest from all the landmarks so far (anything with edges that no landmark reaches at all counts as farthest) */
+  vector<double> dist;
+  simpleDistances(forward, 0, dist);
+  int next = 0;
+  for(int i=0; i<numMets; i++) {  if(dist[i] > dist[next]) { next = i; }  }
+  vector<double> closest(numMets, -1.0f);
+  vector<bool> isLandmark(numMets, false);
+  while(result.landmarkIdx.size() < numLandmarks) {
+    isLandmark[next] = true;
+    result.landmarkIdx.push_back(next);
+    result.fromLandmark.push_back(vector<double>());
+    result.toLandmark.push_back(vector<double>());
+    simpleDistances(forward, next, result.fromLandmark.back());
+    simpleDistances(backward, next, result.toLandmark.back());
+
+    const vector<double> &from = result.fromLandmark.back();
+    const vector<double> &to = result.toLandmark.back();
+    next = -1;
+    double farthest = -1.0f;
+    for(int i=0; i<numMets; i++) {
+      double d = from[i];
+      if(d < 0 || (to[i] >= 0 && to[i] < d)) { d = to[i]; }
+      if(d >= 0 && (closest[i] < 0 || d < closest[i])) { closest[i] = d; }
+      if(isLandmark[i] || (forward[i].empty() && backward[i].empty())) { continue; }
+      double score = closest[i] < 0 ? 1E30 : closest[i];
+      if(score > farthest) { farthest = score; next = i; }
+    }
+    if(next == -1) { break; }
+  }
+}
@@ -14,8 +14,24 @@ using std::queue;
 using std::set;
 using std::vector;
 
-PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, const METABOLITE &output, set<BADIDSTORE> &badIds);
-void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, map<int, int>  &precursorRxnIds, map<int, bool> &metsExplored, vector<int> &rxnIds, vector<int> &inputIds,
+/* Number of exclusion variants batchShortestPaths runs through one traversal (a multiple of 4 for the AVX2 lanes) */
+enum { SPUR_LANES = 8 };
+
+PATH findShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, const METABOLITE &output, set<BADIDSTORE> &badIds,
+		      SSSPSTATE *fullState = NULL, const vector<double> *bounds = NULL);
+PATH repairShortestPath(const RXNSPACE &rxnspace, const METSPACE &metspace, const METABOLITE &output, const SSSPSTATE &parent, int excludedRxnId,
+			const vector<double> *bounds = NULL);
+void buildHyperCsr(const RXNSPACE &rxnspace, const METSPACE &metspace, HYPERCSR &result);
+void batchShortestPaths(const HYPERCSR &graph, const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs, 
+			const METABOLITE &output, const vector<int> &excludedRxnIds, vector<PATH> &result, const vector<double> *bounds = NULL);
+PATH parallelShortestPath(const HYPERCSR &graph, const RXNSPACE &rxnspace, const METSPACE &metspace, const METSPACE &inputs,
+			  const METABOLITE &output);
+void splitGraph(const RXNSPACE &rxnspace, const METSPACE &metspace, SPLITGRAPH &forward, SPLITGRAPH &backward);
+void simpleDistances(const SPLITGRAPH &adj, int sourceIdx, vector<double> &dist);
+void buildLandmarks(const RXNSPACE &rxnspace, const METSPACE &metspace, int numLandmarks, LANDMARKS &result);
+PATH tracedPathToOutput(const RXNSPACE &rxnspace, const METSPACE &metspace, const METABOLITE &output, 
+			const vector<double> &values, const vector<int> &precursorRxnIds);
+void tracePath(const METSPACE &metspace, const RXNSPACE &rxnspace, const vector<int> &precursorRxnIds, map<int, bool> &metsExplored, vector<int> &rxnIds, vector<int> &inputIds,
                vector<int> &rxnDirections, queue<int> &nodeList);
 vector<int> opposite(const REACTION* rxn, int metId, int sgn);
 
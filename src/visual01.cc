@@ -41,7 +41,7 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
       if(incl_mets[i].input!=1 && incl_mets[i].output!=1){
 
 	if(incl_mets[i].secondary_pair.empty() && incl_mets[i].secondary_lone == 0) {
-	  fprintf(dotput,"\"%s\" [shape=ellipse,margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] ; \n",incl_mets[i].name);
+	  fprintf(dotput,"\"%s\" [shape=ellipse,margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] ; \n",incl_mets[i].name.c_str());
 	}
 
 	if(incl_mets[i].secondary_lone != 0) { continue; }
@@ -56,7 +56,7 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
 	  if(printName) { break; }
 	}
 	if(printName) { */
-	  fprintf(dotput,"\"%s\" [shape=ellipse,margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] ; \n",incl_mets[i].name);
+	  fprintf(dotput,"\"%s\" [shape=ellipse,margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] ; \n",incl_mets[i].name.c_str());
 	  /*	} */
       }
     }
@@ -65,13 +65,13 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
   /* Double circles for INPUTS & OUTPUTS */
   for(int i=0;i<numMETs;i++){
     if(incl_mets[i].input==1 || incl_mets[i].output==1){
-      fprintf(dotput,"node [shape=doublecircle,label=\"%s\",margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] \"%s\" ; \n",incl_mets[i].name,incl_mets[i].name);}}
+      fprintf(dotput,"node [shape=doublecircle,label=\"%s\",margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] \"%s\" ; \n",incl_mets[i].name.c_str(),incl_mets[i].name.c_str());}}
 
   /* Double circles around BIOMASS */
   int bm = -9;
   for(int i=0;i<numRXNs;i++){
     if(incl_rxns[i].id==_db.BIOMASS){
-      fprintf(dotput,"node [shape=doublecircle,label=\"%s\",margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] \"%s\" ; \n",incl_rxns[i].name,incl_rxns[i].name);
+      fprintf(dotput,"node [shape=doublecircle,label=\"%s\",margin=0,regular=1,style=filled,fillcolor=orange1,fontsize=12,height=0,width=0] \"%s\" ; \n",incl_rxns[i].name.c_str(),incl_rxns[i].name.c_str());
       bm = i; break;}}
 
   /* BLANK metabolites - used to set up the dangling secondaries that make things MUCH easier to read. */
@@ -80,15 +80,16 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
   map<int, int> metId2Count;
   for(int i=0; i<numRXNs; i++) {
     bool pairsDone = false;
-    for(int j=0; j<incl_rxns[i].stoich_part.size(); j++) {
-      METABOLITE MET = metspace.metFromId(incl_rxns[i].stoich_part[j].met_id);
+    vector<STOICH> part = incl_rxns[i].stoichPart();
+    for(int j=0; j<part.size(); j++) {
+      METABOLITE MET = metspace.metFromId(part[j].met_id);
       /* Keep track of how many blanks at the end of the secondary edges we need to keep track of */
       if(MET.secondary_lone == 1 | hasValidSecondaryPair(incl_rxns[i], metspace, MET.id)) {
 	// Secondary lones always will be "dangling" off by definition
 	if(metId2Count.find(MET.id)==metId2Count.end()) { metId2Count[MET.id] = 0; }
 	metId2Count[MET.id] += 1;
 	int count = metId2Count[MET.id];
-	fprintf(dotput,"\"%s_BLANK%d\" [shape=ellipse,label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] ; \n",MET.name,count);
+	fprintf(dotput,"\"%s_BLANK%d\" [shape=ellipse,label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] ; \n",MET.name.c_str(),count);
       }
     }
   }
@@ -97,53 +98,54 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
   /* RXN boxes */
   for(int i=0;i<numRXNs;i++){
     int k=0; int l=0;
-    for(int j=0;j<incl_rxns[i].stoich_part.size();j++){
-      if(incl_rxns[i].stoich_part[j].rxn_coeff>0){k++;} 
-      if(incl_rxns[i].stoich_part[j].rxn_coeff<0){l++;}
+    vector<STOICH> part = incl_rxns[i].stoichPart();
+    for(int j=0;j<part.size();j++){
+      if(part[j].rxn_coeff>0){k++;} 
+      if(part[j].rxn_coeff<0){l++;}
     }
     if(l>0 && k==0){
-      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name);
-      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name);
+      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name.c_str());
+      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name.c_str());
       fprintf(dotput,"margin = 0 ; \n");
       fprintf(dotput,"fontsize = 12 ; \n");
       //fprintf(dotput,"color = blue ; \n");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_in");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_out");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_in");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_out");
       fprintf(dotput,"} \n");
       good = 1;
     }
     if(k>0 && l==0){
-      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name);
-      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name);
+      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name.c_str());
+      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name.c_str());
       fprintf(dotput,"margin = 0 ; \n");
       fprintf(dotput,"fontsize = 12 ; \n");
       //fprintf(dotput,"color = blue ; \n");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_in");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_out");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_in");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_out");
       fprintf(dotput,"} \n");
       //fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=none,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name,"_in",incl_rxns[i].name,"_out");
       good = 1;
     }
     if(l>0 && k>0){
-      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name);
-      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name);
+      fprintf(dotput,"subgraph cluster_%s { \n",incl_rxns[i].name.c_str());
+      fprintf(dotput,"label = \"%s\" ; \n",incl_rxns[i].name.c_str());
       fprintf(dotput,"margin = 0 ; \n");
       fprintf(dotput,"fontsize = 12 ; \n");
       //fprintf(dotput,"color = blue ; \n");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_in");
-      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name,"_out");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_in");
+      fprintf(dotput,"node [label=\"\",margin=0,regular=1,style=filled,fillcolor=white,fontsize=6,height=0,width=0] \"%s%s\" ; \n",incl_rxns[i].name.c_str(),"_out");
       fprintf(dotput,"} \n");
       //fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=none,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name,"_in",incl_rxns[i].name,"_out");
       good = 1;
     }
     if(good == 1) {
       if(incl_rxns[i].net_reversible==0) {
-	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=both,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name,"_in",incl_rxns[i].name,"_out"); }
+	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=both,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name.c_str(),"_in",incl_rxns[i].name.c_str(),"_out"); }
       else if(incl_rxns[i].net_reversible==1) {
-	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=forward,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name,"_in",incl_rxns[i].name,"_out");
+	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=forward,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name.c_str(),"_in",incl_rxns[i].name.c_str(),"_out");
       }
       else if(incl_rxns[i].net_reversible==-1) {
-	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=back,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name,"_in",incl_rxns[i].name,"_out");
+	      fprintf(dotput,"\"%s%s\" -> \"%s%s\" [dir=back,label=\"\",margin=0,regular=1,fontsize=8] ; \n",incl_rxns[i].name.c_str(),"_in",incl_rxns[i].name.c_str(),"_out");
       }
     }
   }
@@ -154,120 +156,121 @@ void Paths2Dot(FILE *dotput, const METSPACE &metspace,
   if(bm >= 0) {
     for(int i=0;i<incl_rxns[bm].stoich.size();i++){
       fprintf(dotput,"\"%s\" -> \"%s\" [weight=1] ; \n",
-	      incl_rxns[bm].stoich[i].met_name,incl_rxns[bm].name);}
+	      metspace.metFromId(incl_rxns[bm].stoich[i].met_id).name.c_str(),incl_rxns[bm].name.c_str());}
   }
 
   /* Normal Reactions */
   for(int i=0;i<numRXNs;i++){
     int k=0; int l=0;
-    for(int j=0;j<incl_rxns[i].stoich_part.size();j++){
-      if(incl_rxns[i].stoich_part[j].rxn_coeff>0){k++;} 
-      if(incl_rxns[i].stoich_part[j].rxn_coeff<0){l++;}
+    vector<STOICH> part = incl_rxns[i].stoichPart();
+    for(int j=0;j<part.size();j++){
+      if(part[j].rxn_coeff>0){k++;} 
+      if(part[j].rxn_coeff<0){l++;}
     }
     if(k>0 && l>0){
-      for(int j=0;j<incl_rxns[i].stoich_part.size();j++){
+      for(int j=0;j<part.size();j++){
 	if(incl_rxns[i].net_reversible==0 
-	   && incl_rxns[i].stoich_part[j].rxn_coeff<0){ /* reversible arrows */
-	  METABOLITE MET = metspace.metFromId(incl_rxns[i].stoich_part[j].met_id);
+	   && part[j].rxn_coeff<0){ /* reversible arrows */
+	  METABOLITE MET = metspace.metFromId(part[j].met_id);
 	  if(MET.secondary_lone == 1) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s_BLANK%d\" -> \"%s%s\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].name,"_in",
-		    incl_rxns[i].stoich_part[j].met_name);
+		    MET.name.c_str(), count,
+		    incl_rxns[i].name.c_str(),"_in",
+		    MET.name.c_str());
 	  } else if(hasValidSecondaryPair(incl_rxns[i], metspace, MET.id)) {
 	    /* We DON'T need to print the secondaries here since we're looping through the whole thing anyway
 	       and we'll hit the other half of the pair on the way around (and the pairs are labeled both ways) */
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s_BLANK%d\" -> \"%s%s\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].name,"_in",
-		    incl_rxns[i].stoich_part[j].met_name);
+		    MET.name.c_str(), count,
+		    incl_rxns[i].name.c_str(),"_in",
+		    MET.name.c_str());
 	  } else {
 	    fprintf(dotput,"\"%s\" -> \"%s%s\" [dir=none,weight=1] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name,
-		    incl_rxns[i].name,"_in");
+		    MET.name.c_str(),
+		    incl_rxns[i].name.c_str(),"_in");
 	  }
 	}
 	if(incl_rxns[i].net_reversible==0 
-	   && incl_rxns[i].stoich_part[j].rxn_coeff>0){ /* reversible arrows */
-	  METABOLITE MET = metspace.metFromId(incl_rxns[i].stoich_part[j].met_id);
+	   && part[j].rxn_coeff>0){ /* reversible arrows */
+	  METABOLITE MET = metspace.metFromId(part[j].met_id);
 	  if(MET.secondary_lone == 1) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s%s\" -> \"%s_BLANK%d\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].name, "_out", 
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].stoich_part[j].met_name);
+		    incl_rxns[i].name.c_str(), "_out", 
+		    MET.name.c_str(), count,
+		    MET.name.c_str());
 	  } else if(hasValidSecondaryPair(incl_rxns[i], metspace, MET.id)) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s%s\" -> \"%s_BLANK%d\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].name, "_out", 
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].stoich_part[j].met_name); 
+		    incl_rxns[i].name.c_str(), "_out", 
+		    MET.name.c_str(), count,
+		    MET.name.c_str()); 
 	  } else {
 	    fprintf(dotput,"\"%s%s\" -> \"%s\" [dir=none,weight=1] ; \n",
-		    incl_rxns[i].name, "_out", incl_rxns[i].stoich_part[j].met_name);
+		    incl_rxns[i].name.c_str(), "_out", MET.name.c_str());
 	  }
 	}
-	if((incl_rxns[i].stoich_part[j].rxn_coeff<0 
+	if((part[j].rxn_coeff<0 
 	    && incl_rxns[i].net_reversible==1)
-	   ||(incl_rxns[i].stoich_part[j].rxn_coeff>0 
+	   ||(part[j].rxn_coeff>0 
 	      && incl_rxns[i].net_reversible==-1)){ /* into rxn_in */
 
-	  METABOLITE MET = metspace.metFromId(incl_rxns[i].stoich_part[j].met_id);
+	  METABOLITE MET = metspace.metFromId(part[j].met_id);
 	  if(MET.secondary_lone == 1) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s_BLANK%d\" -> \"%s%s\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].name,"_in",
-		    incl_rxns[i].stoich_part[j].met_name);
+		    MET.name.c_str(), count,
+		    incl_rxns[i].name.c_str(),"_in",
+		    MET.name.c_str());
 	  } else if(hasValidSecondaryPair(incl_rxns[i], metspace, MET.id)) {
 	    /* We DON'T need to print the secondaries here since we're looping through the whole thing anyway
 	       and we'll hit the other half of the pair on the way around (and the pairs are labeled both ways) */
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s_BLANK%d\" -> \"%s%s\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].name,"_in",
-		    incl_rxns[i].stoich_part[j].met_name);
+		    MET.name.c_str(), count,
+		    incl_rxns[i].name.c_str(),"_in",
+		    MET.name.c_str());
 	  } else {
 	    // Not a secondary metabolite
 	    fprintf(dotput,"\"%s\" -> \"%s%s\" [dir=none,weight=1] ; \n",
-		    incl_rxns[i].stoich_part[j].met_name,
-		    incl_rxns[i].name,"_in");
+		    MET.name.c_str(),
+		    incl_rxns[i].name.c_str(),"_in");
 	  }
 	}
 	
-	if((incl_rxns[i].stoich_part[j].rxn_coeff<0 
+	if((part[j].rxn_coeff<0 
 	    && incl_rxns[i].net_reversible==-1)
-	   ||(incl_rxns[i].stoich_part[j].rxn_coeff>0 
+	   ||(part[j].rxn_coeff>0 
 	      && incl_rxns[i].net_reversible==1)){ /* out of rxn_out */
 
-	  METABOLITE MET = metspace.metFromId(incl_rxns[i].stoich_part[j].met_id);
+	  METABOLITE MET = metspace.metFromId(part[j].met_id);
 	  if(MET.secondary_lone == 1) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s%s\" -> \"%s_BLANK%d\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].name, "_out", 
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].stoich_part[j].met_name); 
+		    incl_rxns[i].name.c_str(), "_out", 
+		    MET.name.c_str(), count,
+		    MET.name.c_str()); 
 	  } else if(hasValidSecondaryPair(incl_rxns[i], metspace, MET.id)) {
 	    int count = metId2Count[MET.id];
 	    metId2Count[MET.id] -= 1;
 	    fprintf(dotput,"\"%s%s\" -> \"%s_BLANK%d\" [dir=none,weight=1,label=\"%s\",fontsize=14] ; \n",
-		    incl_rxns[i].name, "_out", 
-		    incl_rxns[i].stoich_part[j].met_name, count,
-		    incl_rxns[i].stoich_part[j].met_name); 
+		    incl_rxns[i].name.c_str(), "_out", 
+		    MET.name.c_str(), count,
+		    MET.name.c_str()); 
 	  } else {
 	    // Not a secondary metabolite
 	    fprintf(dotput,"\"%s%s\" -> \"%s\" [dir=none,weight=1] ; \n",
-		    incl_rxns[i].name, "_out", 
-		    incl_rxns[i].stoich_part[j].met_name);
+		    incl_rxns[i].name.c_str(), "_out", 
+		    MET.name.c_str());
 	  }
 	}
       }
@@ -294,16 +297,18 @@ bool hasValidSecondaryPair(const REACTION &rxn, const METSPACE &workingMets, int
 
   /* Is met_id in rxn? */
   bool good = false;
-  for(int i=0; i<rxn.stoich_part.size(); i++) {
-    if(met.id == rxn.stoich_part[i].met_id) { good = true; break; }
+  for(int i=0; i<rxn.stoich.size(); i++) {
+    if(rxn.stoich[i].secondary) { continue; }
+    if(met.id == rxn.stoich[i].met_id) { good = true; break; }
   }
   if(!good) { return false; }
 
   /* Is at least ONE of the secondary_pairs of met_id in the rxn? */
   good = false;
   for(int i=0; i<met.secondary_pair.size(); i++) {
-    for(int j=0; j<rxn.stoich_part.size(); j++) {
-      if(rxn.stoich_part[j].met_id == met.secondary_pair[i]) { good = true; break; }
+    for(int j=0; j<rxn.stoich.size(); j++) {
+      if(rxn.stoich[j].secondary) { continue; }
+      if(rxn.stoich[j].met_id == met.secondary_pair[i]) { good = true; break; }
     }
     if(good) { break; }
   }
@@ -320,14 +325,14 @@ void convertPathForVisuals(const PATH &path, const PROBLEM &ProblemSpace,  RXNSP
   case 0:
     pullOutRxnsbyIds(ProblemSpace.fullrxns, path.rxnIds, workingRxns);
     pullOutMets(workingRxns, ProblemSpace.metabolites, workingMets);
-    /* For fullrxns it's possible someone forgot to copy stoich over to stoich_part.
-       Do that for them here. 
+    /* For fullrxns we want the secondary metabolites as well - mark them as
+       non-secondary here. 
 
        This basically assumes that if you call the function with FULLRXNS, then you intend to graph with the cofactors present, 
     since it doesn't really make much sense otherwise (if you use FULLRXNS without cofactors, 
     you'll have a lot of rxns that look identical taking up space) */
     for(int i=0; i<workingRxns.rxns.size(); i++) {
-      workingRxns.rxns[i].stoich_part = workingRxns.rxns[i].stoich;
+      workingRxns.rxns[i].includeSecondaries();
     }
     break;
   case 1: 
@@ -344,7 +349,7 @@ void convertPathForVisuals(const PATH &path, const PROBLEM &ProblemSpace,  RXNSP
 }
 
 /* Pass the rxnspace so that we can distinguish synrxns from fullrxns 
- Note that either way we are using STOICH_PART and not STOICH. 
+ Note that either way we skip the secondary metabolites in the STOICH. 
 
 useSynRxns = true --> pull out reactions from ProblemSpace.synrxns
 useSynRxns = false --> pull out reactions from ProblemSpace.fullrxns 
@@ -370,14 +375,14 @@ void VisualizePath2File(const char *fileName, const char *label, const PATH &pat
 
 /* Visualize the fullrxns
 
-   useSyn: true - use synRxns (must already have stoich_part filled)
-          false - use fullrxns (assumes that you want to use stoich, and copies that over to stoich_part before calling the paths2Dot file)
+   useSyn: true - use synRxns (secondary flags must already be set)
+          false - use fullrxns (assumes that you want the cofactors, and clears the secondary flags before calling the paths2Dot file)
 
 */
 void visualizePathSummary2File(const char* fileBase, const char* label, const vector<PATHSUMMARY> &psum, const PROBLEM &ProblemSpace, int useSyn) {
   
   for(int i=0; i<psum.size(); i++) {
-    char fileName[128]; sprintf(fileName, "%s%s.dot", fileBase, ProblemSpace.metabolites.metFromId(psum[i].outputId).name);
+    char fileName[128]; sprintf(fileName, "%s%s.dot", fileBase, ProblemSpace.metabolites.metFromId(psum[i].outputId).name.c_str());
     FILE* dotput = fopen(fileName, "w");
 
     vector<PATHSUMMARY> tmpP; tmpP.push_back(psum[i]);
@@ -390,17 +395,17 @@ void visualizePathSummary2File(const char* fileBase, const char* label, const ve
     switch(useSyn) {
     case 0:
       pullOutRxnsbyIds(ProblemSpace.fullrxns, allRxnIds, modelRxns);
-      // Copy stoich to stoich_part per assumption that you actually want cofactors if you're using fullrxns
+      // Clear the secondary flags per assumption that you actually want cofactors if you're using fullrxns
       for(int i=0; i<modelRxns.rxns.size(); i++) {
-	modelRxns.rxns[i].stoich_part = modelRxns.rxns[i].stoich;}
+	modelRxns.rxns[i].includeSecondaries();}
       break;
     case 1:
       pullOutRxnsbyIds(ProblemSpace.synrxns, allRxnIds, modelRxns);
-      // stoich_part should already be in synrxns so no need to copy it over
+      // secondary flags should already be set in synrxns
       break;
     case 2: 
       pullOutRxnsbyIds(ProblemSpace.synrxnsR, allRxnIds, modelRxns);
-      // stoich_part should already be in synrxns so no need to copy it over
+      // secondary flags should already be set in synrxns
       break;
     }
 
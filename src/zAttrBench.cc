@@ -0,0 +1,69 @@
+#include "DataStructures.h"
+#include "MyConstants.h"
+#include "RunK.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+#include <vector>
+
+using std::vector;
+
+/* Benchmark for the structure-of-arrays reaction attributes (RXNSPACE::costs() etc.) on a random model (no input files
+   needed). Reads the reaction costs in a random order - the access pattern of Dijkstras - once from
+   rxns[i].current_likelihood and once from costs(), and then in order. Each REACTION is sizeof(REACTION) bytes, so
+   the first way touches a new cache line for nearly every lookup while costs() packs 8 costs per 64-byte line.
+   (No hardware counters here - use "perf stat -e cache-misses ./AttrBench" where perf is available.)
+   Also checks that costs() is up to date after adjustLikelihoods.
+
+   Usage: AttrBench [number of reactions] [number of lookups] */
+
+int main(int argc, char *argv[]) {
+  int numRxns = (argc > 1) ? atoi(argv[1]) : 200000;
+  int numLookups = (argc > 2) ? atoi(argv[2]) : 4000000;
+  srand(1);
+
+  RXNSPACE rxnspace;
+  for(int i=0; i<numRxns; i++) {
+    REACTION rxn;
+    rxn.id = i + 1;
+    STOICH st;  st.met_id = 1 + rand() % 1000;  st.rxn_coeff = -1.0f;  rxn.stoich.push_back(st);
+    st.met_id = 1 + rand() % 1000;  st.rxn_coeff = 1.0f;  rxn.stoich.push_back(st);
+    rxn.init_likelihood = (rand() % 20 == 0) ? -4.0f : 0.1 + (rand() % 100) / 100.0;
+    rxnspace.addReaction(rxn);
+  }
+  adjustLikelihoods(rxnspace, 1.0f, -3.0f, 1.1f, -10.0f, true);
+  for(int i=0; i<numRxns; i++) { assert(rxnspace.costs()[i] == rxnspace.rxns[i].current_likelihood); }
+
+  vector<int> order(numLookups);
+  for(int i=0; i<numLookups; i++) { order[i] = rand() % numRxns; }
+
+  double total = 0.0f;
+  double start = omp_get_wtime();
+  for(int i=0; i<numLookups; i++) { total += rxnspace.rxns[order[i]].current_likelihood; }
+  double rxnTime = omp_get_wtime() - start;
+
+  double totalSoa = 0.0f;
+  const vector<double> &cost = rxnspace.costs();
+  start = omp_get_wtime();
+  for(int i=0; i<numLookups; i++) { totalSoa += cost[order[i]]; }
+  double soaTime = omp_get_wtime() - start;
+  assert(total == totalSoa);
+
+  start = omp_get_wtime();
+  for(int r=0; r<numLookups/numRxns; r++) {
+    for(int i=0; i<numRxns; i++) { total += rxnspace.rxns[i].current_likelihood; }
+  }
+  double rxnScanTime = omp_get_wtime() - start;
+  start = omp_get_wtime();
+  for(int r=0; r<numLookups/numRxns; r++) {
+    for(int i=0; i<numRxns; i++) { totalSoa += cost[i]; }
+  }
+  double soaScanTime = omp_get_wtime() - start;
+
+  printf("%d reactions (sizeof(REACTION) = %d bytes), %d lookups\n", numRxns, (int)sizeof(REACTION), numLookups);
+  printf("random order:  rxns[i].current_likelihood %.3fs  costs() %.3fs\n", rxnTime, soaTime);
+  printf("in order:      rxns[i].current_likelihood %.3fs  costs() %.3fs  (checksum %g)\n", rxnScanTime, soaScanTime, total - totalSoa);
+  return 0;
+}
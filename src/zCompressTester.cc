@@ -0,0 +1,164 @@
+#include "DataStructures.h"
+#include "genericLinprog.h"
+#include "MyConstants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using std::vector;
+
+/* Checks that COMPRESS_LP doesn't change growth: on random networks (no input files needed) solves growth with no
+   knockouts and with each of a set of single-reaction knockouts, with batchSolve on the full model and on the
+   compressModel copy - the LPs minimizeExits and knockoutLethality run with COMPRESS_LP off and on - and compares the
+   growth. The networks are made of linear pathways between hub metabolites (which compressModel lumps) plus branching
+   reactions, exchanges, blocked reactions and dead ends. Also prints how much smaller the compressed LPs are.
+
+   Usage: CompressTester [models_per_size] */
+
+static const double COMPRESS_TOL = 1E-5;
+
+static int numMetsAdded = 0;
+
+static int newMetabolite(METSPACE &metspace) {
+  METABOLITE met;
+  met.id = ++numMetsAdded;
+  char name[32];
+  sprintf(name, "M%d", met.id);  met.name = name;
+  metspace.addMetabolite(met);
+  return met.id;
+}
+
+static void addRxn(RXNSPACE &rxnspace, int id, const vector<int> &metIds, const vector<double> &coeffs, double lb, double ub) {
+  REACTION rxn;
+  rxn.id = id;
+  char name[32];
+  sprintf(name, "R%d", rxn.id);  rxn.name = name;
+  for(int i=0; i<metIds.size(); i++) {
+    STOICH st;  st.met_id = metIds[i];  st.rxn_coeff = coeffs[i];
+    rxn.stoich.push_back(st);
+  }
+  rxn.lb = lb;  rxn.ub = ub;
+  rxn.net_reversible = (lb < 0.0f && ub > 0.0f) ? 0 : (lb < 0.0f ? -1 : 1);
+  rxnspace.addReaction(rxn);
+}
+
+/* numPathways linear pathways of 2-8 steps, each from one hub metabolite to another */
+static void randomModel(int numPathways, RXNSPACE &rxnspace, METSPACE &metspace) {
+  numMetsAdded = 0;
+  int numHubs = numPathways/3 + 3;
+  vector<int> hubs;
+  for(int i=0; i<numHubs; i++) { hubs.push_back(newMetabolite(metspace)); }
+
+  int id = 1;
+  vector<int> mets;  vector<double> coeffs;
+  for(int p=0; p<numPathways; p++) {
+    int from = hubs[rand() % numHubs];
+    int to = hubs[rand() % numHubs];
+    int steps = 2 + rand() % 7;
+    bool reversible = (rand() % 3 == 0);
+    int prev = from;
+    for(int s=0; s<steps; s++) {
+      int next = (s == steps - 1) ? to : newMetabolite(metspace);
+      mets.clear();  coeffs.clear();
+      mets.push_back(prev);  coeffs.push_back(-(1 + rand() % 2));
+      mets.push_back(next);  coeffs.push_back(1 + rand() % 2);
+      double ub = (rand() % 10 == 0) ? 5 + rand() % 20 : 1000.0f;
+      addRxn(rxnspace, id++, mets, coeffs, reversible ? -1000.0f : 0.0f, ub);
+      prev = next;
+    }
+  }
+  /* Branching reactions between hubs */
+  for(int i=0; i<numPathways/2; i++) {
+    mets.clear();  coeffs.clear();
+    for(int k=0; k<3; k++) {
+      int hub = hubs[rand() % numHubs];
+      if(find(mets.begin(), mets.end(), hub) != mets.end()) { continue; }
+      mets.push_back(hub);  coeffs.push_back((k == 2) ? 1.0f : -1.0f);
+    }
+    addRxn(rxnspace, id++, mets, coeffs, (rand() % 2) ? -1000.0f : 0.0f, 1000.0f);
+  }
+  /* Blocked reactions and dead ends (a hub going to a metabolite nothing uses) */
+  for(int i=0; i<numPathways/10 + 1; i++) {
+    mets.clear();  coeffs.clear();
+    mets.push_back(hubs[rand() % numHubs]);  coeffs.push_back(-1.0f);
+    mets.push_back(hubs[rand() % numHubs]);  coeffs.push_back(1.0f);
+    if(mets[0] != mets[1]) { addRxn(rxnspace, id++, mets, coeffs, 0.0f, 0.0f); }
+    mets.clear();  coeffs.clear();
+    mets.push_back(hubs[rand() % numHubs]);  coeffs.push_back(-1.0f);
+    mets.push_back(newMetabolite(metspace));  coeffs.push_back(1.0f);
+    addRxn(rxnspace, id++, mets, coeffs, 0.0f, 1000.0f);
+  }
+  /* Uptake (written as met -->, so negative flux brings it in) */
+  for(int i=0; i<numHubs/3 + 1; i++) {
+    mets.assign(1, hubs[rand() % numHubs]);  coeffs.assign(1, -1.0f);
+    addRxn(rxnspace, id++, mets, coeffs, -(1 + rand() % 20), 1000.0f);
+    rxnspace.rxns.back().isExchange = 1;
+  }
+  /* Biomass */
+  mets.clear();  coeffs.clear();
+  for(int k=0; k<4; k++) {
+    int hub = hubs[rand() % numHubs];
+    if(find(mets.begin(), mets.end(), hub) != mets.end()) { continue; }
+    mets.push_back(hub);  coeffs.push_back(-(0.5f + rand() % 3));
+  }
+  addRxn(rxnspace, _db.BIOMASS, mets, coeffs, 0.0f, 1000.0f);
+  rxnspace.rxnMap();
+}
+
+static bool agree(double a, double b) {
+  return fabs(a - b) <= COMPRESS_TOL * std::max(1.0, std::max(fabs(a), fabs(b)));
+}
+
+int main(int argc, char *argv[]) {
+  int modelsPerSize = (argc > 1) ? atoi(argv[1]) : 20;
+  int sizes[] = {10, 50, 200, 1000};
+  int numSizes = sizeof(sizes)/sizeof(sizes[0]);
+  srand(1);
+
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  int failures = 0;
+  for(int s=0; s<numSizes; s++) {
+    int numBad = 0, numGrowing = 0;
+    long fullRows = 0, fullCols = 0, compRows = 0, compCols = 0;
+    for(int n=0; n<modelsPerSize; n++) {
+      RXNSPACE rxnspace;  METSPACE metspace;
+      randomModel(sizes[s], rxnspace, metspace);
+
+      /* Growth as is, then with every 5th reaction knocked out on its own */
+      vector<vector<BOUNDOVERRIDE> > variants(1);
+      for(int i=0; i<rxnspace.rxns.size(); i+=5) {
+	if(rxnspace.rxns[i].id == _db.BIOMASS) { continue; }
+	variants.push_back(vector<BOUNDOVERRIDE>(1, BOUNDOVERRIDE(rxnspace.rxns[i].id, 0.0f, 0.0f)));
+      }
+
+      COMPRESSEDMODEL compressed;
+      compressModel(rxnspace, metspace, obj, compressed);
+      fullRows += metspace.mets.size();  fullCols += rxnspace.rxns.size();
+      compRows += compressed.metspace.mets.size();  compCols += compressed.rxnspace.rxns.size();
+
+      GLPKDATA full(rxnspace, metspace, obj, coeff, 1);
+      GLPKDATA small(compressed, obj, coeff, 1);
+      vector<double> growthFull, growthSmall;  vector<int> statusFull, statusSmall;
+      full.batchSolve(variants, growthFull, statusFull);
+      small.batchSolve(variants, growthSmall, statusSmall);
+
+      if(growthFull[0] >= _db.GROWTH_CUTOFF) { numGrowing++; }
+      for(int v=0; v<variants.size(); v++) {
+	if(agree(growthFull[v], growthSmall[v])) { continue; }
+	printf("  %d pathways, model %d, %s: growth %f full, %f compressed\n", sizes[s], n,
+	       v == 0 ? "no knockout" : rxnspace.rxnFromId(variants[v][0].rxnId).name.c_str(), growthFull[v], growthSmall[v]);
+	numBad++;
+	break;
+      }
+    }
+    printf("%d pathways: %d models (%d grow), %d disagree   LP %.0f x %.0f -> %.0f x %.0f on average (%.0f%% of the columns)\n",
+	   sizes[s], modelsPerSize, numGrowing, numBad, (double)fullRows / modelsPerSize, (double)fullCols / modelsPerSize,
+	   (double)compRows / modelsPerSize, (double)compCols / modelsPerSize, 100.0f * compCols / fullCols);
+    failures += numBad;
+  }
+
+  return failures > 0;
+}
@@ -0,0 +1,98 @@
+#include "DataStructures.h"
+#include "MyConstants.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <omp.h>
+#include <vector>
+
+using std::vector;
+
+/* Benchmark for copying RXNSPACE / METSPACE and for rxnFromId / metFromId lookups on a random model (no input files
+   needed). Counts the heap allocations (this program replaces operator new) and the time for each. Also checks that a
+   copy of a space whose reactions were edited directly (without rxnMap) has up to date lookups.
+
+   Usage: CopyBench [number of reactions] [number of metabolites] [repeats] */
+
+static long numAllocations = 0;
+
+void* operator new(std::size_t size) {
+#pragma omp atomic
+  numAllocations++;
+  void *ptr = malloc(size ? size : 1);
+  if(ptr == NULL) { throw std::bad_alloc(); }
+  return ptr;
+}
+
+void operator delete(void *ptr) throw() {
+  free(ptr);
+}
+
+static void makeModel(int numRxns, int numMets, RXNSPACE &rxnspace, METSPACE &metspace) {
+  char name[32];
+  for(int i=0; i<numMets; i++) {
+    METABOLITE met;
+    met.id = i + 1;
+    sprintf(name, "M%d", met.id);  met.name = name;
+    metspace.addMetabolite(met);
+  }
+  for(int i=0; i<numRxns; i++) {
+    REACTION rxn;
+    rxn.id = i + 1;
+    sprintf(name, "R%d", rxn.id);  rxn.name = name;
+    int numStoich = 2 + rand() % 3;
+    for(int k=0; k<numStoich; k++) {
+      STOICH st;  st.met_id = 1 + rand() % numMets;  st.rxn_coeff = (k % 2) ? 1.0f : -1.0f;
+      rxn.stoich.push_back(st);
+    }
+    rxn.lb = -1000.0f;  rxn.ub = 1000.0f;
+    rxn.init_likelihood = rxn.current_likelihood = 0.1 + (rand() % 100) / 100.0;
+    rxnspace.addReaction(rxn);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int numRxns = (argc > 1) ? atoi(argv[1]) : 20000;
+  int numMets = (argc > 2) ? atoi(argv[2]) : 3000;
+  int repeats = (argc > 3) ? atoi(argv[3]) : 20;
+  srand(1);
+
+  RXNSPACE rxnspace;  METSPACE metspace;
+  makeModel(numRxns, numMets, rxnspace, metspace);
+
+  RXNSPACE rxnCopy;
+  long before = numAllocations;
+  double start = omp_get_wtime();
+  for(int r=0; r<repeats; r++) { rxnCopy = rxnspace; }
+  printf("RXNSPACE assignment (%d reactions): %.0f allocations, %.3f ms each\n", numRxns,
+	 (double)(numAllocations - before) / repeats, 1000.0f * (omp_get_wtime() - start) / repeats);
+
+  METSPACE metCopy;
+  before = numAllocations;
+  start = omp_get_wtime();
+  for(int r=0; r<repeats; r++) { metCopy = metspace; }
+  printf("METSPACE assignment (%d metabolites): %.0f allocations, %.3f ms each\n", numMets,
+	 (double)(numAllocations - before) / repeats, 1000.0f * (omp_get_wtime() - start) / repeats);
+
+  int numLookups = 1000000;
+  long total = 0;
+  before = numAllocations;
+  start = omp_get_wtime();
+  for(int i=0; i<numLookups; i++) {
+    total += rxnspace.rxnFromId(1 + i % numRxns).stoich.size();
+    total += metspace.metFromId(1 + i % numMets).id;
+  }
+  printf("%d rxnFromId(..).field + metFromId(..).field lookups: %ld allocations, %.3f ms (checksum %ld)\n", numLookups,
+	 numAllocations - before, 1000.0f * (omp_get_wtime() - start), total);
+
+  /* Direct edits that keep the size the same must still show up in a copy */
+  rxnspace.rxns[0].id = numRxns + 1;
+  rxnspace.rxns[1].current_likelihood = 0.5f;
+  RXNSPACE edited(rxnspace);
+  assert(edited.idIn(numRxns + 1) && !edited.idIn(1));
+  assert(edited.costs()[1] == 0.5f);
+  printf("Copy after direct edits: lookups up to date\n");
+  return 0;
+}
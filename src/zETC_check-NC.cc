@@ -74,9 +74,9 @@ int main(int argc, char *argv[]) {
   ProblemSpace.fullrxns.addReaction(fullBiomass);
 
   /* Re-adjust likelihoods in case we added something that is tagged as BLACK MAGIC */
-  adjustLikelihoods(ProblemSpace.fullrxns.rxns, 1.0f, -2.0f, 1.1f, -2.0f, true);
-  adjustLikelihoods(ProblemSpace.synrxns.rxns, 1.0f, -2.0f, 1.1f, -2.0f, true);
-  adjustLikelihoods(ProblemSpace.synrxnsR.rxns,  1.0f, -2.0f, 1.1f, -2.0f, true);
+  adjustLikelihoods(ProblemSpace.fullrxns, 1.0f, -2.0f, 1.1f, -2.0f, true);
+  adjustLikelihoods(ProblemSpace.synrxns, 1.0f, -2.0f, 1.1f, -2.0f, true);
+  adjustLikelihoods(ProblemSpace.synrxnsR,  1.0f, -2.0f, 1.1f, -2.0f, true);
 
   FirstKPass(ProblemSpace,K,psum);
 
@@ -99,7 +99,7 @@ int main(int argc, char *argv[]) {
   for(int i=0;i<ETCout.size();i++){
     printf("chain %d of %d: ",i,(int)ETCout.size());
     for(int j=0;j<ETCout[i].rxnDirIds.size();j++){
-      printf("%s(%d)  ",rxnspace.rxnFromId(abs(ETCout[i].rxnDirIds[j])).name,ETCout[i].rxnDirIds[j]);
+      printf("%s(%d)  ",rxnspace.rxnFromId(abs(ETCout[i].rxnDirIds[j])).name.c_str(),ETCout[i].rxnDirIds[j]);
     }
     printf("\n");
   }
@@ -110,7 +110,7 @@ int main(int argc, char *argv[]) {
   for(int i=0;i<ETCout2.size();i++){
     printf("chain %d of %d (%d): ",i,(int)ETCout2.size(),ETCout2[i].rxn.net_reversible);
     for(int j=0;j<ETCout2[i].rxnDirIds.size();j++){
-      printf("%s(%1.3f)  ",rxnspace.rxnFromId(abs(ETCout2[i].rxnDirIds[j])).name,
+      printf("%s(%1.3f)  ",rxnspace.rxnFromId(abs(ETCout2[i].rxnDirIds[j])).name.c_str(),
 	     rxnspace.rxnFromId(abs(ETCout2[i].rxnDirIds[j])).init_likelihood);
     }
     printf("\n");fflush(stdout);
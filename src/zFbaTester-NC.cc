@@ -1,5 +1,6 @@
 #include "DataStructures.h"
 #include "ETC.h"
+#include "genericLinprog.h"
 #include "Grow.h"
 #include "MyConstants.h"
 #include "pathUtils.h"
@@ -47,7 +48,7 @@ int main(int argc, char *argv[]) {
   /* I tried to move this to inputSetup as well but it gave me a compile error
      so here it is*/
   printf("Annotating genes...\n");
-  map<string, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
+  map<STRINGID, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
   printf("...done\n");
 
   printf("Finding paths in forward direction...\n");
@@ -67,7 +68,7 @@ int main(int argc, char *argv[]) {
     vector<int> outputIds = Load_Outputs_From_Growth(ProblemSpace, i);
     for(int j=0; j<psum[i].size(); j++) { 
       if(psum[i][j].size() == 0) {
-	printf("WARNING: No paths found to output %s under growth condition %d so making it a secondary_lone \n", ProblemSpace.metabolites.metFromId(outputIds[j]).name, i);
+	printf("WARNING: No paths found to output %s under growth condition %d so making it a secondary_lone \n", ProblemSpace.metabolites.metFromId(outputIds[j]).name.c_str(), i);
 	ProblemSpace.metabolites.metPtrFromId(outputIds[j])->secondary_lone = 1;
       }
     }
@@ -139,6 +140,9 @@ int main(int argc, char *argv[]) {
   vector<ANSWER> *test = &ans;
 
   optimizeAMs(ans, ProblemSpace, 50);
+  int cacheHits, cacheMisses;
+  fbaCacheStats(cacheHits, cacheMisses);
+  printf("FBA cache: %d hits, %d misses\n", cacheHits, cacheMisses);
 
 
   /*
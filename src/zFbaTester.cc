@@ -51,8 +51,8 @@ int main(int argc, char *argv[]) {
   for(int i=0; i<tmpfull.rxns.size(); i++) {
     fullString[0] = '\0';
     partString[0] = '\0';
-    printRxnFormula(tmpfull.rxns[i], fullString, true);
-    printRxnFormula(tmpfull.rxns[i], partString, false);
+    printRxnFormula(ProblemSpace.metabolites, tmpfull.rxns[i], fullString, true);
+    printRxnFormula(ProblemSpace.metabolites, tmpfull.rxns[i], partString, false);
     fprintf(fid, "%s\t%d\t%1.3f\t%s\t%s\n", 
 	    tmpfull.rxns[i].name, tmpfull.rxns[i].net_reversible, tmpfull.rxns[i].current_likelihood,
 	    fullString, partString);
@@ -61,15 +61,12 @@ int main(int argc, char *argv[]) {
   /* Make a computer-friendly format so I can easily curate, add/remove things */
   for(int i=0; i<tmpfull.rxns.size(); i++) {
     for(int j=0; j<tmpfull.rxns[i].stoich.size(); j++) {
-      bool keep = false;
-      for(int k=0; k<tmpfull.rxns[i].stoich_part.size(); k++) {
-	if(tmpfull.rxns[i].stoich[j].met_id == tmpfull.rxns[i].stoich_part[k].met_id) { keep = true; break; }
-      }
+      bool keep = !tmpfull.rxns[i].stoich[j].secondary;
       /* Reaction name - Reaction ID - Reversibility - Metabolite name - Metabolite ID - reaction coefficient - Secondary or not [1 = secondary] */
       fprintf(fid, "%s\t%d\t%d\t%s\t%d\t%1.8f\t%d\n",
-	      tmpfull.rxns[i].name, tmpfull.rxns[i].id, tmpfull.rxns[i].net_reversible, 
-	      tmpfull.rxns[i].stoich[j].met_name, tmpfull.rxns[i].stoich[j].met_id, tmpfull.rxns[i].stoich[j].rxn_coeff, keep?0:1);
-      fprintf(fid2, "%s\t%1.4f\n", tmpfull.rxns[i].name, tmpfull.rxns[i].init_likelihood);
+	      tmpfull.rxns[i].name.c_str(), tmpfull.rxns[i].id, tmpfull.rxns[i].net_reversible, 
+	      ProblemSpace.metabolites.metFromId(tmpfull.rxns[i].stoich[j].met_id).name.c_str(), tmpfull.rxns[i].stoich[j].met_id, tmpfull.rxns[i].stoich[j].rxn_coeff, keep?0:1);
+      fprintf(fid2, "%s\t%1.4f\n", tmpfull.rxns[i].name.c_str(), tmpfull.rxns[i].init_likelihood);
     }
   }
 
@@ -80,7 +77,7 @@ int main(int argc, char *argv[]) {
   /* I tried to move this to inputSetup as well but it gave me a compile error
      so here it is*/
   printf("Annotating genes...\n");
-  map<string, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
+  map<STRINGID, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
   printf("...done\n");
 
   //  printREACTIONvector(ProblemSpace.synrxns.rxns, 1);
@@ -102,7 +99,7 @@ int main(int argc, char *argv[]) {
     vector<int> outputIds = Load_Outputs_From_Growth(ProblemSpace, i);
     for(int j=0; j<psum[i].size(); j++) { 
       if(psum[i][j].size() == 0) {
-	printf("WARNING: No paths found to output %s under growth condition %d so making it a secondary_lone \n", ProblemSpace.metabolites.metFromId(outputIds[j]).name, i);
+	printf("WARNING: No paths found to output %s under growth condition %d so making it a secondary_lone \n", ProblemSpace.metabolites.metFromId(outputIds[j]).name.c_str(), i);
 	ProblemSpace.metabolites.metPtrFromId(outputIds[j])->secondary_lone = 1;
       }
     }
@@ -0,0 +1,85 @@
+#include "DataStructures.h"
+#include "genericLinprog.h"
+#include "Grow.h"
+#include "MyConstants.h"
+#include "pathUtils.h"
+#include "Paths2Model.h"
+#include "RunK.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+#include <vector>
+
+using std::vector;
+
+/* Agreement check for the two gap-finding formulations: builds the gapfill model (setUpGapfill) for every growth
+   condition and runs gapFindLinprog and gapFindSplitLinprog on it. Prints the magic exits each one keeps, where they
+   differ and how long each took, and checks that the model still grows with only the kept exits on.
+
+   Usage: GapFindCompare likelihoods.xml input.xml */
+
+/* Does the model grow with every magic exit that is not in keep turned off? */
+static bool growsWithExits(const PROBLEM &model, const vector<int> &keep) {
+  PROBLEM pruned = model;
+  const vector<int> &exitIdx = pruned.fullrxns.idxOfKind(RXN_MAGICEXIT);
+  for(int i=0; i<exitIdx.size(); i++) {
+    REACTION &exit = pruned.fullrxns.rxns[exitIdx[i]];
+    if(find(keep.begin(), keep.end(), exit.id) == keep.end()) { exit.lb = 0.0f; exit.ub = 0.0f; }
+  }
+  vector<double> flux = FBA_SOLVE(pruned.fullrxns, pruned.metabolites);
+  return flux[pruned.fullrxns.idxFromId(_db.BIOMASS)] >= _db.GROWTH_CUTOFF;
+}
+
+int main(int argc, char *argv[]) {
+  PROBLEM ProblemSpace;
+  InputSetup(argc, argv, ProblemSpace);
+
+  /* Paths to the biomass components the same way FbaTester gets them */
+  vector<vector<vector<PATHSUMMARY> > > psum;
+  FirstKPass(ProblemSpace, _db.INITIAL_K, psum);
+  SecondKPass(ProblemSpace, _db.INITIAL_K, psum);
+  addR(psum, ProblemSpace);
+  calcMetRxnRelations(ProblemSpace.fullrxns, ProblemSpace.metabolites);
+  vector<PATHSUMMARY> flat = flattenPsum(psum);
+  vector<vector<vector<PATHSUMMARY> > > unSynPsum = psum;
+  for(int i=0; i<psum.size(); i++) {
+    for(int j=0; j<psum[i].size(); j++) {
+      for(int k=0; k<psum[i][j].size(); k++) { unSynPsum[i][j][k] = replaceWithRealRxnIds(psum[i][j][k], flat, ProblemSpace); }
+    }
+  }
+  vector<PATHSUMMARY> pList = flattenPsum(unSynPsum);
+
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  int failures = 0;
+  for(int g=0; g<ProblemSpace.growth.size(); g++) {
+    PROBLEM model = setUpGapfill(ProblemSpace, pList);
+    setSpecificGrowthConditions(model, ProblemSpace.growth[g]);
+
+    vector<int> oldExits, splitExits;
+    double start = omp_get_wtime();
+    GLPKDATA oldLp(model.fullrxns, model.metabolites, obj, coeff, 1);
+    int oldStatus = oldLp.gapFindLinprog(oldExits);
+    double oldTime = omp_get_wtime() - start;
+    start = omp_get_wtime();
+    GLPKDATA splitLp(model.fullrxns, model.metabolites, obj, coeff, 1);
+    int splitStatus = splitLp.gapFindSplitLinprog(splitExits);
+    double splitTime = omp_get_wtime() - start;
+
+    vector<int> onlyOld, onlySplit;
+    set_difference(oldExits.begin(), oldExits.end(), splitExits.begin(), splitExits.end(), back_inserter(onlyOld));
+    set_difference(splitExits.begin(), splitExits.end(), oldExits.begin(), oldExits.end(), back_inserter(onlySplit));
+
+    printf("Growth condition %d: gapFindLinprog kept %d exits (status %d, %.3fs) gapFindSplitLinprog kept %d exits (status %d, %.3fs)\n",
+	   g, (int)oldExits.size(), oldStatus, oldTime, (int)splitExits.size(), splitStatus, splitTime);
+    for(int i=0; i<onlyOld.size(); i++) { printf("  only gapFindLinprog: %s\n", model.fullrxns.rxnFromId(onlyOld[i]).name.c_str()); }
+    for(int i=0; i<onlySplit.size(); i++) { printf("  only gapFindSplitLinprog: %s\n", model.fullrxns.rxnFromId(onlySplit[i]).name.c_str()); }
+
+    if(oldStatus != splitStatus) { printf("ERROR: the two formulations disagree on whether there is a solution\n"); failures++; }
+    if(splitStatus == 1 && !growsWithExits(model, splitExits)) { printf("ERROR: no growth with the gapFindSplitLinprog exits\n"); failures++; }
+    if(oldStatus == 1 && !growsWithExits(model, oldExits)) { printf("ERROR: no growth with the gapFindLinprog exits\n"); failures++; }
+  }
+
+  return failures > 0;
+}
@@ -0,0 +1,80 @@
+#include "Annotations.h"
+#include "DataStructures.h"
+#include "Grow.h"
+#include "MyConstants.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+/* Checks knockoutLethality on a small hand-made network (no input files needed):
+
+   A uptake -> A --R1--> B --R2--> C --biomass-->
+                 \--R3--> D (dead end)
+
+   R1 has two isozymes (g1, g2), R2 only g3, R3 only g4 and g5 isn't annotated to anything. Only the g3 knockout
+   should be lethal - knocking out g1 or g2 leaves the other one to make R1.
+
+   Usage: KnockoutTester (from the directory with outputs/ in it, like the other testers - GeneAnnotations saves there) */
+
+static void addMet(METSPACE &metspace, int id, const char *name) {
+  METABOLITE met;
+  met.id = id;  met.name = name;
+  metspace.addMetabolite(met);
+}
+
+static void addRxn(RXNSPACE &rxnspace, int id, const char *name, int fromMet, int toMet, double lb, const char *gene1, const char *gene2) {
+  REACTION rxn;
+  rxn.id = id;  rxn.name = name;
+  STOICH st;
+  if(fromMet > 0) { st.met_id = fromMet;  st.rxn_coeff = -1.0f;  rxn.stoich.push_back(st); }
+  if(toMet > 0) { st.met_id = toMet;  st.rxn_coeff = 1.0f;  rxn.stoich.push_back(st); }
+  rxn.lb = lb;  rxn.ub = 1000.0f;
+  rxn.net_reversible = (lb < 0.0f) ? 0 : 1;
+  const char *genes[2] = {gene1, gene2};
+  for(int i=0; i<2; i++) {
+    if(genes[i] == NULL) { continue; }
+    ANNOTATION annote;
+    annote.genename = genes[i];  annote.probability = 1.0f;
+    rxn.annote.push_back(annote);
+  }
+  rxnspace.addReaction(rxn);
+}
+
+int main(int argc, char *argv[]) {
+  PROBLEM model;
+  addMet(model.metabolites, 1, "A");
+  addMet(model.metabolites, 2, "B");
+  addMet(model.metabolites, 3, "C");
+  addMet(model.metabolites, 4, "D");
+  /* (the uptake is written as A -->, so negative flux brings A in) */
+  addRxn(model.fullrxns, 1, "EX_A", 1, 0, -10.0f, NULL, NULL);
+  addRxn(model.fullrxns, 2, "R1", 1, 2, 0.0f, "g1", "g2");
+  addRxn(model.fullrxns, 3, "R2", 2, 3, 0.0f, "g3", NULL);
+  addRxn(model.fullrxns, 4, "R3", 1, 4, 0.0f, "g4", NULL);
+  addRxn(model.fullrxns, _db.BIOMASS, "Biomass", 3, 0, 0.0f, NULL, NULL);
+
+  map<STRINGID, vector<VALUESTORE> > geneRxnMap = GeneAnnotations(model.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
+
+  const char *genes[] = {"g1", "g2", "g3", "g4", "g5"};
+  bool expected[] = {false, false, true, false, false};
+  int numGenes = sizeof(genes)/sizeof(genes[0]);
+  vector<STRINGID> geneIds;
+  for(int i=0; i<numGenes; i++) { geneIds.push_back(internString(genes[i])); }
+
+  vector<bool> lethal = knockoutLethality(model, geneRxnMap, geneIds);
+  int failures = 0;
+  for(int i=0; i<numGenes; i++) {
+    bool ok = (lethal[i] == expected[i]);
+    printf("%s knockout: %s (expected %s)%s\n", genes[i], lethal[i] ? "lethal" : "grows", expected[i] ? "lethal" : "grows", ok ? "" : "  WRONG");
+    if(!ok) { failures++; }
+  }
+  /* The single-gene version has to agree */
+  if(knockoutLethality(model, geneRxnMap, geneIds[2]) != expected[2]) { printf("single-gene knockoutLethality disagrees for g3  WRONG\n");  failures++; }
+
+  printf("%d wrong\n", failures);
+  return failures > 0;
+}
@@ -0,0 +1,76 @@
+#include "DataStructures.h"
+#include "genericLinprog.h"
+#include "kShortest.h"
+#include "Modularity.h"
+#include "MyConstants.h"
+#include "RunK.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+#include <vector>
+
+using std::vector;
+
+/* Before / after timings for reorderForLocality: FBA on fullrxns and K-shortest on synrxns for every output of the first
+   growth condition, with storage in file order and then in locality order. The answers must not change.
+
+   Usage: LocalityBench num_threads likelihoods.xml input.xml */
+
+/* A new GLPKDATA every time (the free FBA_SOLVE would just return its cached answer after the first) */
+static double timeFba(const PROBLEM &ProblemSpace, int repeats, double &objective) {
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  double start = omp_get_wtime();
+  vector<double> flux;
+  for(int r=0; r<repeats; r++) {
+    GLPKDATA lp(ProblemSpace.fullrxns, ProblemSpace.metabolites, obj, coeff, 1);
+    flux = lp.FBA_SOLVE();
+  }
+  objective = flux[ProblemSpace.fullrxns.idxFromId(_db.BIOMASS)];
+  return omp_get_wtime() - start;
+}
+
+static double timePaths(PROBLEM &ProblemSpace, int K, double &totalLength) {
+  vector<int> inputIds = Load_Inputs_From_Growth(ProblemSpace.growth[0]);
+  vector<int> outputIds = Load_Outputs_From_Growth(ProblemSpace, 0);
+  METSPACE inputs(ProblemSpace.metabolites, inputIds);
+  METSPACE outputs(ProblemSpace.metabolites, outputIds);
+  vector<vector<PATH> > result;
+  double start = omp_get_wtime();
+  kShortest(result, ProblemSpace.synrxns, ProblemSpace.metabolites, inputs, outputs, K);
+  double elapsed = omp_get_wtime() - start;
+  totalLength = 0.0f;
+  for(int i=0; i<result.size(); i++) {
+    for(int k=0; k<result[i].size(); k++) { totalLength += result[i][k].totalLikelihood; }
+  }
+  return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+  PROBLEM ProblemSpace;
+  InputSetup(argc, argv, ProblemSpace);
+  int fbaRepeats = 20;
+  int K = _db.INITIAL_K > 1 ? _db.INITIAL_K : 5;
+
+  double objBefore, objAfter, lengthBefore, lengthAfter;
+  double fbaBefore = timeFba(ProblemSpace, fbaRepeats, objBefore);
+  double pathBefore = timePaths(ProblemSpace, K, lengthBefore);
+
+  reorderForLocality(ProblemSpace);
+  /* synrxns gets the same kind of order (it has different reactions from fullrxns) */
+  vector<int> rxnOrder, metOrder;
+  localityOrder(ProblemSpace.synrxns, ProblemSpace.metabolites, rxnOrder, metOrder);
+  ProblemSpace.synrxns.reorder(rxnOrder);
+
+  double fbaAfter = timeFba(ProblemSpace, fbaRepeats, objAfter);
+  double pathAfter = timePaths(ProblemSpace, K, lengthAfter);
+
+  printf("FBA x%d:       file order %.3fs   locality order %.3fs   (objective %f / %f)\n", fbaRepeats, fbaBefore, fbaAfter, objBefore, objAfter);
+  printf("K-shortest K=%d: file order %.3fs   locality order %.3fs   (total length %f / %f)\n", K, pathBefore, pathAfter, lengthBefore, lengthAfter);
+  if(fabs(objBefore - objAfter) > 1E-6 || fabs(lengthBefore - lengthAfter) > 1E-6) {
+    printf("ERROR: reordering changed the answers\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "DataStructures.h"
+#include "genericLinprog.h"
+#include "Grow.h"
+#include "MyConstants.h"
+#include "RunK.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+#include <vector>
+
+using std::vector;
+
+/* Stress test for running LPs from many threads at once (see LPSESSION). Every growth condition is solved once serially
+   for reference, then FBA is run again and again from all the threads - half of the runs build a new GLPKDATA each time
+   and the other half re-solve one per-thread copy of a GLPKDATA. Every answer has to match the reference.
+   GLPK has to be built with thread-local storage for this to pass with more than one thread.
+
+   Usage: LpStress num_threads likelihoods.xml input.xml */
+
+int main(int argc, char *argv[]) {
+  PROBLEM ProblemSpace;
+  InputSetup(argc, argv, ProblemSpace);
+  int rounds = 50;
+
+  int numModels = ProblemSpace.growth.size();
+  vector<PROBLEM> models(numModels, ProblemSpace);
+  for(int g=0; g<numModels; g++) { setSpecificGrowthConditions(models[g], ProblemSpace.growth[g]); }
+
+  vector<int> obj(1, _db.BIOMASS); vector<double> coeff(1, 1.0f);
+  vector<double> reference(numModels);
+  double start = omp_get_wtime();
+  for(int g=0; g<numModels; g++) {
+    GLPKDATA lp(models[g].fullrxns, models[g].metabolites, obj, coeff, 1);
+    vector<double> flux = lp.FBA_SOLVE();
+    reference[g] = flux[models[g].fullrxns.idxFromId(_db.BIOMASS)];
+  }
+  double serialTime = omp_get_wtime() - start;
+
+  int mismatches = 0;
+  int numThreads = 0;
+  start = omp_get_wtime();
+#pragma omp parallel reduction(+:mismatches)
+  {
+#pragma omp single
+    numThreads = omp_get_num_threads();
+
+    /* One copy per thread of each model's GLPKDATA, made in the thread that uses it */
+    vector<GLPKDATA*> copies;
+    for(int g=0; g<numModels; g++) {
+      GLPKDATA original(models[g].fullrxns, models[g].metabolites, obj, coeff, 1);
+      copies.push_back(new GLPKDATA(original));
+    }
+
+#pragma omp for schedule(dynamic)
+    for(int run=0; run<rounds*numModels; run++) {
+      int g = run % numModels;
+      int biomassIdx = models[g].fullrxns.idxFromId(_db.BIOMASS);
+      vector<double> flux;
+      /* Straight to GLPKDATA - the free FBA_SOLVE would answer most of these from its cache */
+      if(run % 2 == 0) {
+	GLPKDATA fresh(models[g].fullrxns, models[g].metabolites, obj, coeff, 1);
+	flux = fresh.FBA_SOLVE();
+      }
+      else { flux = copies[g]->FBA_SOLVE(); }
+      if(fabs(flux[biomassIdx] - reference[g]) > 1E-6) {
+	printf("MISMATCH run %d thread %d growth condition %d: %f (expected %f)\n", run, omp_get_thread_num(), g, flux[biomassIdx], reference[g]);
+	mismatches++;
+      }
+    }
+
+    for(int g=0; g<numModels; g++) { delete copies[g]; }
+    LPSESSION &session = solverSession();
+#pragma omp critical
+    printf("Thread %d: %d problems created, %d reused\n", omp_get_thread_num(), session.numCreated, session.numReused);
+  }
+  double parallelTime = omp_get_wtime() - start;
+
+  printf("%d growth conditions: serial %.3fs   %d runs on %d threads %.3fs   sessions %d   mismatches %d\n",
+	 numModels, serialTime, rounds*numModels, numThreads, parallelTime, numSolverSessions(), mismatches);
+
+#pragma omp parallel
+  closeSolverSession();
+
+  return mismatches > 0;
+}
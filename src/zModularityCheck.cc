@@ -68,8 +68,8 @@ int main(int argc, char *argv[]){
   for(int i=0;i<ProblemSpace.exchanges.rxns.size();i++){
     ProblemSpace.fullrxns.addReaction(ProblemSpace.exchanges.rxns[i]);
   }
-  adjustLikelihoods(theModel.synrxns.rxns, 1.0f, -1.0f, 1.1f, -3.0f, false);   
-  adjustLikelihoods(theModel.fullrxns.rxns, 1.0f, -1.0f, 1.1f, -3.0f, false);   
+  adjustLikelihoods(theModel.synrxns, 1.0f, -1.0f, 1.1f, -3.0f, false);   
+  adjustLikelihoods(theModel.fullrxns, 1.0f, -1.0f, 1.1f, -3.0f, false);   
 
   /*
   printf("Everything: %d\n",(int)ProblemSpace.synrxns.rxns.size());
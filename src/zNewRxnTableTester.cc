@@ -33,14 +33,14 @@ int main(int argc, char *argv[]) {
 
   tmp.clear();
 
-  adjustLikelihoods(ProblemSpace.synrxns.rxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
-  //  adjustLikelihoods(ProblemSpace.synrxnsR.rxns,  1.0f, -3.0f, 1.1f, -10.0f, true);
-  adjustLikelihoods(ProblemSpace.fullrxns.rxns, 1.0f, -3.0f, 1.1f, -10.0f, true);  
+  adjustLikelihoods(ProblemSpace.synrxns, 1.0f, -3.0f, 1.1f, -10.0f, true);
+  //  adjustLikelihoods(ProblemSpace.synrxnsR,  1.0f, -3.0f, 1.1f, -10.0f, true);
+  adjustLikelihoods(ProblemSpace.fullrxns, 1.0f, -3.0f, 1.1f, -10.0f, true);  
 
   //  printREACTIONvector(ProblemSpace.synrxns.rxns, 1);
   printSynRxns(ProblemSpace.synrxns, ProblemSpace.fullrxns);
 
-  map<string, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
+  map<STRINGID, vector<VALUESTORE> > annoteToRxns = GeneAnnotations(ProblemSpace.fullrxns, _db.ANNOTE_CUTOFF_1, _db.ANNOTE_CUTOFF_2);
 
   int K=1;
   vector<vector<vector<PATHSUMMARY> > > psum;
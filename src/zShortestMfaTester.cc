@@ -52,7 +52,7 @@ int main(int argc, char *argv[]) {
     adjustMagicLikelihood(revSplit, ProblemSpace.growth[k]);
 
     /* Heavy penalty on the magic exits and entrances. */
-    adjustLikelihoods(revSplit.rxns, 1.0f, -1000.0f, 1.1f, -3.0f, true);
+    adjustLikelihoods(revSplit, 1.0f, -1000.0f, 1.1f, -3.0f, true);
 
     char rxnNameFile[64];
     sprintf(rxnNameFile, "Reaction_list_growth_%d", k);
@@ -60,8 +60,8 @@ int main(int argc, char *argv[]) {
     char rxnString[4096];
     for(int i=0; i<revSplit.rxns.size(); i++) {
       rxnString[0] = '\0';
-      printRxnFormula(revSplit.rxns[i], rxnString, false);
-      fprintf(fid, "%d\t%s\t%s\n", i, revSplit.rxns[i].name, rxnString);      
+      printRxnFormula(metSplit, revSplit.rxns[i], rxnString, false);
+      fprintf(fid, "%d\t%s\t%s\n", i, revSplit.rxns[i].name.c_str(), rxnString);      
     }
     fclose(fid);
     
@@ -70,7 +70,7 @@ int main(int argc, char *argv[]) {
       printf("Working on biomass component number %d...\n", i);
       int bmId = ProblemSpace.growth[k].biomass[i].met_id;
       char nm[128];
-      sprintf(nm, "%s_growth%d%s", metSplit.metFromId(bmId).name, k, ".cplex");
+      sprintf(nm, "%s_growth%d%s", metSplit.metFromId(bmId).name.c_str(), k, ".cplex");
       writeMilpCplex(revSplit, metSplit, bmId, nm);
       
     /* Come up with a solution with which to seed the MILP and write that to a file */
@@ -154,7 +154,7 @@ void adjustMagicLikelihood(RXNSPACE &rxnspace, const GROWTH &whichCondition) {
 void makeMagicExits(RXNSPACE &RxnSpace, const METSPACE &exitsToMake) {
   /* Generate magic exits for everything... */
   for(int i=0; i<exitsToMake.mets.size(); i++) {
-    int id = FindExchange4Metabolite(RxnSpace.rxns, exitsToMake.mets[i].id);
+    int id = FindExchange4Metabolite(RxnSpace, exitsToMake.mets[i].id);
     if(id == -1) {
       /* Only allow exits - not entrances, since this formulation shouldn't require them. This drastically reduces the number
 	 of integer variables and the size of the search space... */
@@ -232,7 +232,7 @@ void writeMilpCplex(const RXNSPACE &space, const METSPACE &metspace, int targetM
    The maximum line length is 500 so if I make a new line every 10 I should be OK (no identifiers are longer than 6 digits + 2 spaces + a sign = 9 */
   fprintf(fid, "MINIMIZE\n");
   for(int i=0; i<space.rxns.size(); i++) {
-    if(space.rxns[i].current_likelihood < 0.0f) { printf("ERROR: Reaction %s has current_likelhiood < 0\n", space.rxns[i].name); }
+    if(space.rxns[i].current_likelihood < 0.0f) { printf("ERROR: Reaction %s has current_likelhiood < 0\n", space.rxns[i].name.c_str()); }
     //    fprintf(fid, "+ %1.3f z%d ", space.rxns[i].current_likelihood, i);
     fprintf(fid, "+ 1 z%d ", i);
     if( i != 0 && (i/10) * 10 == i ) { fprintf(fid, "\n\t"); }
@@ -259,7 +259,7 @@ void writeMilpCplex(const RXNSPACE &space, const METSPACE &metspace, int targetM
     fprintf(fid, " = 0\n");
   }
   /* Vj > 0 --> j is the exchange reaction for the target metabolite */
-  int ExcId = FindExchange4Metabolite(space.rxns, targetMetId);
+  int ExcId = FindExchange4Metabolite(space, targetMetId);
   int ExcIdx = space.idxFromId(ExcId);
   fprintf(fid, "v%d >= %1.3f\n", ExcIdx, T2);
   /* For the same reaction, z_forward + z_backward <= 1 */
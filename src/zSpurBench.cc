@@ -0,0 +1,131 @@
+#include "DataStructures.h"
+#include "MyConstants.h"
+#include "RunK.h"
+#include "shortestPath.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <omp.h>
+#include <set>
+#include <vector>
+
+using std::set;
+using std::vector;
+
+/* Benchmark for the K-shortest spur searches on a random network (no input files needed).
+   Every reaction in the shortest path is excluded in turn (the spur set of the first K-shortest iteration) and the spur
+   paths are found three ways: a Dijkstras from scratch for each one, repairing the parent's labels, and batchShortestPaths
+   SPUR_LANES at a time. All three must give the same lengths.
+
+   Usage: SpurBench [number of metabolites] [max jump between metabolites] [repeats] */
+
+/* Random layered network: every metabolite has three reactions to metabolites a little further along, a third of
+   them two-reactant (so AND-joins matter) and a third reversible */
+static void makeNetwork(int numMets, int span, RXNSPACE &rxnspace, METSPACE &metspace) {
+  for(int i=0; i<numMets; i++) {
+    METABOLITE met;
+    met.id = i + 1;
+    char name[32];
+    sprintf(name, "M%d", i);
+    met.name = name;
+    metspace.addMetabolite(met);
+  }
+  int rxnId = 1;
+  for(int i=0; i<numMets; i++) {
+    for(int e=0; e<3; e++) {
+      int to = i + 1 + rand() % span;
+      if(to >= numMets) { continue; }
+      REACTION rxn;
+      rxn.id = rxnId++;
+      char name[32];
+      sprintf(name, "R%d", rxn.id);
+      rxn.name = name;
+      STOICH st;
+      st.met_id = i + 1;  st.rxn_coeff = -1;  rxn.stoich.push_back(st);
+      if(e == 1 && i > 0) {  st.met_id = 1 + rand() % i;  rxn.stoich.push_back(st);  }
+      st.met_id = to + 1;  st.rxn_coeff = 1;  rxn.stoich.push_back(st);
+      rxn.lb = 0;  rxn.ub = 1000;
+      rxn.net_reversible = (e == 2) ? 0 : 1;
+      rxn.init_likelihood = rxn.current_likelihood = 0.1 + (rand() % 100) / 100.0;
+      rxnspace.addReaction(rxn);
+    }
+  }
+  calcMetRxnRelations_nosec(rxnspace, metspace);
+  rxnspace.syncAttributes();
+}
+
+int main(int argc, char *argv[]) {
+  int numMets = (argc > 1) ? atoi(argv[1]) : 2000;
+  int span = (argc > 2) ? atoi(argv[2]) : 20;
+  int repeats = (argc > 3) ? atoi(argv[3]) : 20;
+  srand(7);
+
+  RXNSPACE rxnspace;
+  METSPACE metspace;
+  makeNetwork(numMets, span, rxnspace, metspace);
+  METSPACE inputs;
+  inputs.addMetabolite(metspace.mets[0]);
+  const METABOLITE &output = metspace.mets[numMets - 1];
+
+  set<BADIDSTORE> badIds;
+  SSSPSTATE parentState;
+  PATH parent = findShortestPath(rxnspace, metspace, inputs, output, badIds, &parentState);
+  if(parent.outputId == -1) {
+    printf("Output can't be reached - try a bigger jump\n");
+    return 1;
+  }
+  const vector<int> &spurRxns = parent.rxnIds;
+  int numSpurs = spurRxns.size();
+#ifdef __AVX2__
+  printf("%d metabolites, %d reactions, %d spurs (AVX2 lanes)\n", numMets, (int)rxnspace.rxns.size(), numSpurs);
+#else
+  printf("%d metabolites, %d reactions, %d spurs (scalar lanes)\n", numMets, (int)rxnspace.rxns.size(), numSpurs);
+#endif
+
+  vector<double> scratch(numSpurs), repaired(numSpurs), batched(numSpurs);
+
+  double start = omp_get_wtime();
+  for(int r=0; r<repeats; r++) {
+    for(int i=0; i<numSpurs; i++) {
+      rxnspace.changeLikelihood(spurRxns[i], -1);
+      scratch[i] = findShortestPath(rxnspace, metspace, inputs, output, badIds).totalLikelihood;
+      rxnspace.changeLikelihood(spurRxns[i], rxnspace.rxnFromId(spurRxns[i]).init_likelihood);
+    }
+  }
+  double scratchTime = omp_get_wtime() - start;
+
+  start = omp_get_wtime();
+  for(int r=0; r<repeats; r++) {
+    findShortestPath(rxnspace, metspace, inputs, output, badIds, &parentState);
+    for(int i=0; i<numSpurs; i++) {
+      rxnspace.changeLikelihood(spurRxns[i], -1);
+      repaired[i] = repairShortestPath(rxnspace, metspace, output, parentState, spurRxns[i]).totalLikelihood;
+      rxnspace.changeLikelihood(spurRxns[i], rxnspace.rxnFromId(spurRxns[i]).init_likelihood);
+    }
+  }
+  double repairTime = omp_get_wtime() - start;
+
+  HYPERCSR graph;
+  buildHyperCsr(rxnspace, metspace, graph);
+  start = omp_get_wtime();
+  for(int r=0; r<repeats; r++) {
+    for(int first=0; first<numSpurs; first+=SPUR_LANES) {
+      vector<int> lanes(spurRxns.begin() + first, spurRxns.begin() + std::min(numSpurs, first + SPUR_LANES));
+      vector<PATH> lanePaths;
+      batchShortestPaths(graph, rxnspace, metspace, inputs, output, lanes, lanePaths);
+      for(int l=0; l<lanePaths.size(); l++) { batched[first + l] = lanePaths[l].totalLikelihood; }
+    }
+  }
+  double batchTime = omp_get_wtime() - start;
+
+  int mismatches = 0;
+  for(int i=0; i<numSpurs; i++) {
+    if(fabs(scratch[i] - repaired[i]) > 1E-9 || fabs(scratch[i] - batched[i]) > 1E-9) {
+      printf("MISMATCH spur %d (reaction %d): %f %f %f\n", i, spurRxns[i], scratch[i], repaired[i], batched[i]);
+      mismatches++;
+    }
+  }
+  printf("from scratch: %.3fs   repaired: %.3fs   batched: %.3fs   mismatches: %d\n", scratchTime, repairTime, batchTime, mismatches);
+  return mismatches > 0;
+}
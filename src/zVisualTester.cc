@@ -76,7 +76,7 @@ void testKShortest_visuals() {
 			}
 			printf("REACTION LIST #%d:\n",j);
 			for(k=0;k<newReaction.size();k++) {
-				printREACTIONinputs(newReaction[k], 1);
+				printREACTIONinputs(ProblemSpace.metabolites, newReaction[k], 1);
 			}
 			Paths2Dot(dotput, newMetabolite, newReaction, label);
 			fclose(dotput);